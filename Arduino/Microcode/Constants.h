@@ -52,6 +52,14 @@ static const uint32_t ALU_A_OR_B    = (uint32_t)0b101 << ALU_OFFSET;
 static const uint32_t ALU_A_AND_B   = (uint32_t)0b110 << ALU_OFFSET;
 static const uint32_t ALU_NOT_A     = (uint32_t)0b111 << ALU_OFFSET; // preset (set all 1's)
 
+// shift unit modes, on the ALU mode bits when SHF is set (emulator only roms:
+// MicrocodeTools -s and -w. the EEPROM images never set SHF)
+// input: 'A' from the bus. C is the bit shifted out, O is cleared
+static const uint32_t SHIFT_SHL = (uint32_t)0b000 << ALU_OFFSET; // A << 1
+static const uint32_t SHIFT_SHR = (uint32_t)0b001 << ALU_OFFSET; // A >> 1
+static const uint32_t SHIFT_ROL = (uint32_t)0b010 << ALU_OFFSET; // A << 1, bit 7 into bit 0
+static const uint32_t SHIFT_ROR = (uint32_t)0b011 << ALU_OFFSET; // A >> 1, bit 0 into bit 7
+
 // other control word bits
 // names starting with an underscore are active low
 static const uint32_t  ALB  = (uint32_t)1 << 6;  // if set, ALU to use Rb as second input, otherwise use 0
@@ -69,7 +77,7 @@ static const uint32_t  PCC  = (uint32_t)1 << 17; // increment program counter
 static const uint32_t _PCW  = (uint32_t)1 << 18; // (active low) write to program counter
 static const uint32_t _MAW  = (uint32_t)1 << 19; // (active low) write to memory address register
 static const uint32_t LCD   = (uint32_t)1 << 20; // lcd write
-static const uint32_t TBD21 = (uint32_t)1 << 21; // (unused) tbd
+static const uint32_t  SHF  = (uint32_t)1 << 21; // (emulator only) ALU register takes the shift unit output instead of the ALU's (mode from the ALU mode bits)
 static const uint32_t _TR   = (uint32_t)1 << 22; // (active low) reset microcode counter (next instruction)
 static const uint32_t  HLT  = (uint32_t)1 << 23; // halt
 
@@ -399,15 +407,22 @@ class EepromAddress
   // EEPROM address layout (15 bits)
   // bit:   |   14    |   13    |   12    |   11    |   10    |    9    |    8    |    7    |    6    |    5    |    4    |    3    |    2    |    1    |    0    |
   // value: |zero flag|cary flag|oflw flag|neg flag |-----  microcode step -------|----------------------------------- op code  ----------------------------------|
+  //
+  // WideSteps layout (16 bits, emulator only): a 4 bit microcode step in bits 8-11
+  // and the flags moved up to bits 12-15
+
+  public:
+    enum Layout { Standard, WideSteps };
 
   private:
     static const int OpcodeOffset    = 0;
     static const int MicrotimeOffset = 8;
-    static const int FlagsOffset     = 11;
 
     static const uint16_t OpcodeMask    = Opcode::Mask << OpcodeOffset;
-    static const uint16_t MicrotimeMask = (uint16_t)0x7  << MicrotimeOffset;
-    static const uint16_t FlagsMask     = (uint16_t)0xf  << FlagsOffset;
+
+    int flagsOffset() const { return m_layout == WideSteps ? 12 : 11; }
+    uint16_t microtimeMask() const { return (uint16_t)(m_layout == WideSteps ? 0xf : 0x7) << MicrotimeOffset; }
+    uint16_t flagsMask() const { return (uint16_t)0xf << flagsOffset(); }
 
   public:
     static const uint32_t NegativeFlag = (uint32_t)1 << 0;
@@ -416,17 +431,21 @@ class EepromAddress
     static const uint32_t ZeroFlag     = (uint32_t)1 << 3;
 
     static const uint16_t TOTAL_BYTES = (uint16_t)1 << 15;
+    static const uint32_t WIDE_TOTAL_BYTES = (uint32_t)1 << 16;
 
-    EepromAddress(uint16_t address) : m_address(address) {}
-    EepromAddress(uint8_t flags, uint8_t microtime, const Opcode &opcode)
-    : m_address(((flags << FlagsOffset) & FlagsMask) |
-                ((microtime << MicrotimeOffset) & MicrotimeMask) |
-                ((opcode << OpcodeOffset) & OpcodeMask))
+    EepromAddress(uint16_t address, Layout layout = Standard) : m_address(address), m_layout(layout) {}
+    EepromAddress(uint8_t flags, uint8_t microtime, const Opcode &opcode, Layout layout = Standard)
+    : m_address(0), m_layout(layout)
     {
+      m_address = ((flags << flagsOffset()) & flagsMask()) |
+                  ((microtime << MicrotimeOffset) & microtimeMask()) |
+                  ((opcode << OpcodeOffset) & OpcodeMask);
     }
 
-    uint8_t flags() const { return (m_address & FlagsMask) >> FlagsOffset; }
-    uint8_t microtime() const { return (m_address & MicrotimeMask) >> MicrotimeOffset; }
+    Layout layout() const { return m_layout; }
+
+    uint8_t flags() const { return (m_address & flagsMask()) >> flagsOffset(); }
+    uint8_t microtime() const { return (m_address & microtimeMask()) >> MicrotimeOffset; }
     const Opcode &opcode() const
     {
       static Opcode oc(0);
@@ -443,10 +462,10 @@ class EepromAddress
       return oc;
     }
 
-    bool isNegativeFlagSet() const { return m_address & (NegativeFlag << FlagsOffset); }
-    bool isOverflowFlagSet() const { return m_address & (OverflowFlag << FlagsOffset); }
-    bool isCarryFlagSet() const { return m_address & (CarryFlag << FlagsOffset); }
-    bool isZeroFlagSet() const { return m_address & (ZeroFlag << FlagsOffset); }
+    bool isNegativeFlagSet() const { return flags() & NegativeFlag; }
+    bool isOverflowFlagSet() const { return flags() & OverflowFlag; }
+    bool isCarryFlagSet() const { return flags() & CarryFlag; }
+    bool isZeroFlagSet() const { return flags() & ZeroFlag; }
 
     std::string toString() const
     {
@@ -464,4 +483,5 @@ class EepromAddress
 
   private:
     uint16_t m_address;
+    Layout   m_layout;
 };
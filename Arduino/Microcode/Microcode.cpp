@@ -9,6 +9,12 @@ static const uint8_t STEP3 = STEP1 + 2;
 static const uint8_t STEP4 = STEP1 + 3;
 static const uint8_t STEP5 = STEP1 + 4;
 static const uint8_t STEP6 = STEP1 + 5;
+static const uint8_t STEP7 = STEP1 + 6;   // STEP7 onwards: wide step rom only
+static const uint8_t STEP8 = STEP1 + 7;
+static const uint8_t STEP9 = STEP1 + 8;
+static const uint8_t STEP10 = STEP1 + 9;
+static const uint8_t STEP11 = STEP1 + 10;
+static const uint8_t STEP12 = STEP1 + 11;
 
 static const uint32_t INSTRUCTION_END     = _TR;
 static const uint32_t READ_PROGRAM_MEMORY = PGM | BW_MEM;
@@ -16,6 +22,9 @@ static const uint32_t READ_MEMORY         = BW_MEM;
 
 static const uint32_t SET_MAW_FROM_PC     = Register::PC().writeToBus() | _MAW;
 
+static const uint32_t ALU_INCREMENT       = ALU_A_PLUS_B | ALC | _ALW;  // Acc = bus + 1
+static const uint32_t ALU_DECREMENT       = ALU_A_MINUS_B | _ALW;       // Acc = bus - 1
+
 uint32_t getImmediateMovControlWord(const Register &dest, uint8_t microtime, std::string& desc)
 {
   if (dest == Register::PC())
@@ -138,7 +147,26 @@ uint32_t getConditionalJumpControlWord(const EepromAddress &address, std::string
 }
 
 
-uint32_t getMovControlWord(const EepromAddress& address, std::string& desc)
+// shift unit rom only (MicrocodeTools -s, emulator only): shifts of Rb
+// through the shift unit. they use the otherwise meaningless "mov X, X"
+// opcodes: 00 001 001 shl, 00 010 010 shr, 00 011 011 rlc, 00 100 100 rrc
+uint32_t getShiftControlWord(const Register& slot, uint8_t microtime, std::string& desc)
+{
+  uint32_t mode = SHIFT_SHL;
+  if (slot == Register::Rb())       { desc = "shl Rb"; mode = SHIFT_SHL; }
+  else if (slot == Register::Rc())  { desc = "shr Rb"; mode = SHIFT_SHR; }
+  else if (slot == Register::Rd())  { desc = "rlc Rb"; mode = SHIFT_ROL; }
+  else                              { desc = "rrc Rb"; mode = SHIFT_ROR; }
+
+  switch (microtime)
+  {
+    case STEP1: return Register::Rb().writeToBus() | SHF | mode | _ALW;
+    case STEP2: return Register::Acc().writeToBus() | Register::Rb().readFromBus() | INSTRUCTION_END;
+  }
+  return INSTRUCTION_END;
+}
+
+uint32_t getMovControlWord(const EepromAddress& address, std::string& desc, bool shiftUnit)
 {
   Opcode opcode = address.opcode();
   Register dest = opcode.destReg();
@@ -199,6 +227,10 @@ uint32_t getMovControlWord(const EepromAddress& address, std::string& desc)
       case STEP1: return src.writeToBus() | dest.readFromBus() | INSTRUCTION_END;
     }
   }
+  else if (shiftUnit && (dest == Register::Rb() || dest == Register::Rc() || dest == Register::Rd() || dest == Register::StP()))
+  {
+    return getShiftControlWord(dest, address.microtime(), desc);
+  }
   else if (dest == Register::PC())
   {
     desc = "hlt";
@@ -589,7 +621,110 @@ uint32_t getAluControlWord(const EepromAddress& address, std::string& desc)
 }
 
 
-extern uint32_t getControlWord(const EepromAddress &address, std::string &desc)
+// wide step rom only (EepromAddress::WideSteps). these take the redundant
+// "Rb sub Rb with carry", "sub Rb from Rb with carry" and both "cmp Rb, Rb"
+// opcodes. mul and cpy handle one bit/byte per pass and repeat by stepping PC
+// back onto themselves until their counter register reaches zero
+
+// mul: Ra += Rb * Rc (low byte). Rb and Rc are clobbered
+uint32_t getMulControlWord(const EepromAddress& address, std::string& desc)
+{
+  desc = "mul";
+
+  switch (address.microtime())
+  {
+    // low bit of the multiplier into the carry flag
+    case STEP1: return Register::Rc().writeToBus() | SHF | SHIFT_SHR | _ALW;
+    case STEP2: return Register::Acc().writeToBus() | Register::Rc().readFromBus();
+
+    // add the multiplicand if it was set (or add 0)
+    case STEP3: return Register::Ra().writeToBus() | ALU_A_PLUS_B | (address.isCarryFlagSet() ? ALB : 0) | _ALW;
+    case STEP4: return Register::Acc().writeToBus() | Register::Ra().readFromBus();
+
+    case STEP5: return Register::Rb().writeToBus() | SHF | SHIFT_SHL | _ALW;
+    case STEP6: return Register::Acc().writeToBus() | Register::Rb().readFromBus();
+
+    // repeat while multiplier bits remain
+    case STEP7: return Register::Rc().writeToBus() | ALU_A_PLUS_B | _ALW;
+    case STEP8: return address.isZeroFlagSet() ? INSTRUCTION_END : (Register::PC().writeToBus() | ALU_DECREMENT);
+    case STEP9: return Register::Acc().writeToBus() | Register::PC().readFromBus() | INSTRUCTION_END;
+  }
+  return INSTRUCTION_END;
+}
+
+// cpy: copy Rc bytes (0 = 256) of ram from *Ra to *Rd. Ra and Rd are left
+// past the blocks, Rc at 0. Rb is clobbered
+uint32_t getCpyControlWord(const EepromAddress& address, std::string& desc)
+{
+  desc = "cpy";
+
+  switch (address.microtime())
+  {
+    case STEP1: return Register::Ra().writeToBus() | _MAW | ALU_INCREMENT;
+    case STEP2: return READ_MEMORY | Register::Rb().readFromBus();
+    case STEP3: return Register::Acc().writeToBus() | Register::Ra().readFromBus();
+
+    case STEP4: return Register::Rd().writeToBus() | _MAW | ALU_INCREMENT;
+    case STEP5: return Register::Rb().writeToBus() | _MW;
+    case STEP6: return Register::Acc().writeToBus() | Register::Rd().readFromBus();
+
+    case STEP7: return Register::Rc().writeToBus() | ALU_DECREMENT;
+    case STEP8: return Register::Acc().writeToBus() | Register::Rc().readFromBus();
+    case STEP9: return address.isZeroFlagSet() ? INSTRUCTION_END : (Register::PC().writeToBus() | ALU_DECREMENT);
+    case STEP10: return Register::Acc().writeToBus() | Register::PC().readFromBus() | INSTRUCTION_END;
+  }
+  return INSTRUCTION_END;
+}
+
+// add16/sub16: the 16 bit little endian value in ram at *Ra +/-= the one at
+// *Rd, carry chained from the low byte. Rb, Rc and Rd are clobbered
+uint32_t getWordAluControlWord(const EepromAddress& address, bool subtract, std::string& desc)
+{
+  desc = subtract ? "sub16" : "add16";
+
+  const uint32_t mode = subtract ? ALU_A_MINUS_B : ALU_A_PLUS_B;
+
+  // subtraction carries in unless there was a borrow (carry clear)
+  const uint32_t lowCarry = subtract ? ALC : 0;
+
+  switch (address.microtime())
+  {
+    // Rb = low byte of *Rd, Rc = Rd + 1
+    case STEP1: return Register::Rd().writeToBus() | _MAW | ALU_INCREMENT;
+    case STEP2: return Register::Acc().writeToBus() | Register::Rc().readFromBus();
+    case STEP3: return READ_MEMORY | Register::Rb().readFromBus();
+
+    // low byte, Rd = Ra + 1
+    case STEP4: return Register::Ra().writeToBus() | _MAW | ALU_INCREMENT;
+    case STEP5: return Register::Acc().writeToBus() | Register::Rd().readFromBus();
+    case STEP6: return READ_MEMORY | ALB | mode | lowCarry | _ALW;
+    case STEP7: return Register::Acc().writeToBus() | _MW;
+
+    // high byte
+    case STEP8: return Register::Rc().writeToBus() | _MAW;
+    case STEP9: return READ_MEMORY | Register::Rb().readFromBus();
+    case STEP10: return Register::Rd().writeToBus() | _MAW;
+    case STEP11: return READ_MEMORY | ALB | mode | (address.isCarryFlagSet() ? ALC : 0) | _ALW;
+    case STEP12: return Register::Acc().writeToBus() | _MW | INSTRUCTION_END;
+  }
+  return INSTRUCTION_END;
+}
+
+static uint32_t getWideControlWord(const EepromAddress& address, std::string& desc, bool& handled)
+{
+  handled = true;
+  switch ((uint8_t)address.opcode())
+  {
+    case 0xe5: return getMulControlWord(address, desc);
+    case 0xe9: return getCpyControlWord(address, desc);
+    case 0xf5: return getWordAluControlWord(address, false, desc);
+    case 0xf9: return getWordAluControlWord(address, true, desc);
+  }
+  handled = false;
+  return 0;
+}
+
+static uint32_t getStepControlWord(const EepromAddress &address, std::string &desc, bool shiftUnit)
 {
   // first steps are always to retrieve the next instruction
   // from memory and place into the instruction register
@@ -608,7 +743,7 @@ extern uint32_t getControlWord(const EepromAddress &address, std::string &desc)
   switch (address.opcode().group())
   {
     case OpcodeGroup::MOV_BITS:
-      return getMovControlWord(address, desc);
+      return getMovControlWord(address, desc, shiftUnit);
 
     case OpcodeGroup::LOD_BITS:
       return getLodControlWord(address, desc);
@@ -617,9 +752,57 @@ extern uint32_t getControlWord(const EepromAddress &address, std::string &desc)
       return getStoControlWord(address, desc);
 
     case OpcodeGroup::ALU_BITS:
+      if (address.layout() == EepromAddress::WideSteps)
+      {
+        bool handled = false;
+        uint32_t controlWord = getWideControlWord(address, desc, handled);
+        if (handled)
+          return controlWord;
+      }
       return getAluControlWord(address, desc);
 
     default:
       return 0;
   }
 }
+
+// the pipelined machine loads the next instruction from program memory (at PC)
+// during every step that ends an instruction. steps 0 and 1 only run after a
+// reset and the step counter then continues at STEP1. a PC written (or counted)
+// by the ending step is forwarded to the fetch, so jumps need no change. a write
+// to program memory can't share the step with the fetch: it moves to a step of
+// its own and the instruction ends one step later
+static bool writesProgramMemory(uint32_t controlWord)
+{
+  return (controlWord & _MW) && (controlWord & PGM);
+}
+
+extern uint32_t getControlWord(const EepromAddress &address, std::string &desc)
+{
+  return getStepControlWord(address, desc, false);
+}
+
+extern uint32_t getControlWord(const EepromAddress &address, std::string &desc, bool pipelined)
+{
+  return getControlWord(address, desc, pipelined, false);
+}
+
+extern uint32_t getControlWord(const EepromAddress &address, std::string &desc, bool pipelined, bool shiftUnit)
+{
+  uint32_t controlWord = getStepControlWord(address, desc, shiftUnit);
+  if (!pipelined || address.microtime() < STEP1)
+    return controlWord;
+
+  if ((controlWord & INSTRUCTION_END) && writesProgramMemory(controlWord))
+    return controlWord & ~INSTRUCTION_END;
+
+  if (address.microtime() > STEP1)
+  {
+    std::string prevDesc;
+    uint32_t prev = getStepControlWord(EepromAddress(address.flags(), address.microtime() - 1, address.opcode(), address.layout()), prevDesc, shiftUnit);
+    if ((prev & INSTRUCTION_END) && writesProgramMemory(prev))
+      return INSTRUCTION_END;
+  }
+
+  return controlWord;
+}
@@ -26,3 +26,12 @@
 class EepromAddress;
 
 uint32_t getControlWord(const EepromAddress& address, std::string& desc);
+
+// control words for the pipelined machine, which fetches the next instruction
+// during the last step of the current one (FEATURE_PIPELINE in the emulator)
+uint32_t getControlWord(const EepromAddress& address, std::string& desc, bool pipelined);
+
+// shiftUnit: the shift unit's shl/shr/rlc/rrc Rb on the "mov X, X" opcodes
+// (SHF, emulator only). the EEPROMs are written without them, so there
+// those opcodes do nothing
+uint32_t getControlWord(const EepromAddress& address, std::string& desc, bool pipelined, bool shiftUnit);
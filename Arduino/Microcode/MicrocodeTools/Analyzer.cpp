@@ -0,0 +1,435 @@
+/*
+ * Troy's 8-bit computer - Microcode cost table and analyzer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: MicrocodeTools analyze [-o costs.json]
+//
+// walks every rom address and writes a json cost table (stdout if no -o):
+//
+//   fetch_steps   steps every instruction spends fetching (before its own)
+//   opcodes       per opcode: desc, steps (execute steps for each of the 16
+//                 flag combinations, index = N | O << 1 | C << 2 | Z << 3,
+//                 null where the instruction halts) and flags_read
+//   findings      wasteful microcode, one entry per opcode, step and kind:
+//                   idle              the step latches, counts and writes
+//                                     nothing (at most it ends the
+//                                     instruction, which the step before
+//                                     could do)
+//                   dead_latch        a register is latched and then latched
+//                                     again, or left for the next fetch to
+//                                     overwrite, before anything reads it
+//                   flag_variants     the control words differ between flag
+//                                     combinations the instruction shouldn't
+//                                     care about (or don't where it should)
+//                 flag_mask has bit n set for each flag combination n the
+//                 finding applies to
+//
+// a summary of the findings goes to stderr
+
+#include "Analyzer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include "Microcode.h"
+#include "Constants.h"
+#include "Superoptimizer.h"
+
+namespace
+{
+  const int OPCODES = 256;
+  const int FLAG_COMBINATIONS = 16;
+  const uint8_t FIRST_STEP = 2;   // steps 0 and 1 fetch the instruction
+  const uint8_t LAST_STEP = 7;    // the step counter wraps to the next fetch after this
+
+  const uint32_t LATCHES = _ALW | _RdW | _RcW | _RbW | _RaW | _StPW | _MW | _IRW | _PCW | _MAW;
+
+  const char* flagNames[] = { "N", "O", "C", "Z" };
+
+  enum Reg
+  {
+    R_RA, R_RB, R_RC, R_RD, R_SP, R_PC, R_MAR, R_ACC,
+    REGS
+  };
+
+  const char* regNames[REGS] = { "Ra", "Rb", "Rc", "Rd", "SP", "PC", "MAR", "Acc" };
+
+  struct Finding
+  {
+    int opcode;
+    uint16_t flagMask;
+    int step;           // rom step, FIRST_STEP and up. -1 for the whole instruction
+    std::string kind;
+    std::string detail;
+  };
+
+  // key: opcode, step, kind, detail. findings shared by flag combinations are merged
+  typedef std::tuple<int, int, std::string, std::string> FindingKey;
+
+  struct Instruction
+  {
+    std::string desc;
+    int steps[FLAG_COMBINATIONS];   // -1: halts
+    uint8_t flagsRead;
+    std::vector<uint32_t> words[FLAG_COMBINATIONS];
+  };
+
+  // execute steps up to and including the one that ends the instruction
+  std::vector<uint32_t> executeSteps(uint8_t opcode, uint8_t flags, std::string& desc, bool& halts)
+  {
+    std::vector<uint32_t> words;
+    halts = false;
+    for (uint8_t microtime = FIRST_STEP; microtime <= LAST_STEP; ++microtime)
+    {
+      std::string d;
+      uint32_t w = getControlWord(EepromAddress(flags, microtime, Opcode(opcode)), d);
+      if (microtime == FIRST_STEP)
+        desc = d;
+      words.push_back(w);
+      if (w & HLT)
+        halts = true;
+      if (w & (_TR | HLT))
+        break;
+    }
+    return words;
+  }
+
+  // the flags an instruction is meant to read: conditional jumps test one flag,
+  // add and subtract with carry read C. everything else ignores the flags
+  uint8_t expectedFlags(uint8_t opcode)
+  {
+    Opcode op(opcode);
+    if (op.group() == OpcodeGroup::MOV() && op.destReg() == Register::Imm())
+    {
+      // the source bits pick the test (see getConditionalJumpControlWord)
+      switch (op.srcReg())
+      {
+        case 0b000: case 0b111: return EepromAddress::CarryFlag;     // jc, jnc
+        case 0b001: case 0b110: return EepromAddress::ZeroFlag;      // jz, jnz
+        case 0b010: case 0b101: return EepromAddress::OverflowFlag;  // jo, jno
+        default:                return EepromAddress::NegativeFlag;  // jn, jnn
+      }
+    }
+    if (op.group() == OpcodeGroup::ALU())
+    {
+      AluOpcode alu(opcode);
+      bool arithmetic = alu.aluMode() == AluMode::A_PLUS_B() ||
+                        alu.aluMode() == AluMode::A_MINUS_B() ||
+                        alu.aluMode() == AluMode::B_MINUS_A();
+      if (arithmetic && alu.useCarry())
+        return EepromAddress::CarryFlag;
+    }
+    return 0;
+  }
+
+  std::string flagList(uint8_t flags)
+  {
+    std::string text;
+    for (int i = 0; i < 4; ++i)
+    {
+      if (flags & (1 << i))
+        text += (text.empty() ? "" : ",") + std::string(flagNames[i]);
+    }
+    return text;
+  }
+
+  void regsRead(uint32_t w, bool reads[REGS])
+  {
+    memset(reads, 0, sizeof(bool) * REGS);
+    switch (w & 0x7)
+    {
+      case BW_PC:  reads[R_PC] = true; break;
+      case BW_MEM: reads[R_MAR] = true; break;
+      case BW_StP: reads[R_SP] = true; break;
+      case BW_Ra:  reads[R_RA] = true; break;
+      case BW_Rb:  reads[R_RB] = true; break;
+      case BW_Rc:  reads[R_RC] = true; break;
+      case BW_Rd:  reads[R_RD] = true; break;
+      case BW_ALU: reads[R_ACC] = true; break;
+    }
+
+    // an ALU latch reads Rb as B, and the previous Acc for the overflow flag.
+    // the shift unit reads neither
+    if (w & _ALW)
+    {
+      uint32_t mode = (w >> ALU_OFFSET) & AluMode::Mask;
+      if (w & ALB)
+        reads[R_RB] = true;
+      bool arithmetic = mode == AluMode::A_PLUS_B_BITS || mode == AluMode::A_MINUS_B_BITS || mode == AluMode::B_MINUS_A_BITS;
+      if (arithmetic && !(w & SHF))
+        reads[R_ACC] = true;
+    }
+  }
+
+  void regsWritten(uint32_t w, bool writes[REGS])
+  {
+    memset(writes, 0, sizeof(bool) * REGS);
+    writes[R_RA] = (w & _RaW) != 0;
+    writes[R_RB] = (w & _RbW) != 0;
+    writes[R_RC] = (w & _RcW) != 0;
+    writes[R_RD] = (w & _RdW) != 0;
+    writes[R_SP] = (w & _StPW) != 0;
+    writes[R_PC] = (w & _PCW) != 0;
+    writes[R_MAR] = (w & _MAW) != 0;
+    writes[R_ACC] = (w & _ALW) != 0;
+  }
+
+  // steps are applied in the order computerTick does: the bus and the ALU
+  // read first, then the registers latch, then memory is written at the new
+  // MAR. a PC count lands after all of that
+  void findDeadLatches(const std::vector<uint32_t>& words, std::vector<Finding>& found, int opcode, uint16_t mask)
+  {
+    int lastWrite[REGS];
+    const char* lastHow[REGS];
+    bool used[REGS];
+    for (int r = 0; r < REGS; ++r)
+    {
+      lastWrite[r] = -1;
+      lastHow[r] = "";
+      used[r] = true;
+    }
+
+    auto write = [&](int r, int step, const char* how) {
+      if (!used[r])
+      {
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%s %s here is %s again at step %d before it is read",
+                 regNames[r], lastHow[r], how, step + FIRST_STEP);
+        found.push_back(Finding{ opcode, mask, lastWrite[r] + FIRST_STEP, "dead_latch", buf });
+      }
+      lastWrite[r] = step;
+      lastHow[r] = how;
+      used[r] = false;
+    };
+
+    for (int i = 0; i < (int)words.size(); ++i)
+    {
+      uint32_t w = words[i];
+      bool reads[REGS], writes[REGS];
+      regsRead(w, reads);
+      regsWritten(w, writes);
+
+      for (int r = 0; r < REGS; ++r)
+        used[r] = used[r] || reads[r];
+      for (int r = 0; r < REGS; ++r)
+      {
+        if (writes[r])
+          write(r, i, "latched");
+      }
+      if (w & _MW)
+        used[R_MAR] = true;
+      if (w & PCC)
+      {
+        used[R_PC] = true;
+        write(R_PC, i, "counted");
+      }
+    }
+
+    // the next fetch loads MAR from PC
+    if (!used[R_MAR])
+    {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "MAR latched here is never read");
+      found.push_back(Finding{ opcode, mask, lastWrite[R_MAR] + FIRST_STEP, "dead_latch", buf });
+    }
+  }
+
+  void findIdleSteps(const std::vector<uint32_t>& words, std::vector<Finding>& found, int opcode, uint16_t mask)
+  {
+    // a single step instruction that does nothing is a nop
+    if (words.size() < 2)
+      return;
+
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+      uint32_t w = words[i];
+      if (w & (LATCHES | PCC | LCD | HLT))
+        continue;
+      found.push_back(Finding{ opcode, mask, (int)(FIRST_STEP + i), "idle",
+                               (w & _TR) ? "only ends the instruction" : "does nothing" });
+    }
+  }
+
+  std::string jsonString(const std::string& str)
+  {
+    std::string out = "\"";
+    for (unsigned char ch : str)
+    {
+      if (ch == '"' || ch == '\\')
+      {
+        out += '\\';
+        out += (char)ch;
+      }
+      else if (ch < 0x20 || ch > 0x7e)
+      {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", ch);
+        out += buf;
+      }
+      else
+      {
+        out += (char)ch;
+      }
+    }
+    return out + "\"";
+  }
+}
+
+
+int analyze(int argc, char** argv)
+{
+  const char* outFile = nullptr;
+  for (int i = 0; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+    {
+      outFile = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: MicrocodeTools analyze [-o costs.json]\n");
+      return 1;
+    }
+  }
+
+  std::vector<Instruction> instructions(OPCODES);
+  std::vector<Finding> raw;
+
+  for (int opcode = 0; opcode < OPCODES; ++opcode)
+  {
+    Instruction& inst = instructions[opcode];
+    inst.flagsRead = 0;
+    for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+    {
+      bool halts = false;
+      std::string desc;
+      inst.words[flags] = executeSteps((uint8_t)opcode, (uint8_t)flags, desc, halts);
+      inst.steps[flags] = halts ? -1 : (int)inst.words[flags].size();
+      if (flags == 0)
+        inst.desc = desc;
+
+      if (!halts)
+      {
+        findIdleSteps(inst.words[flags], raw, opcode, (uint16_t)(1 << flags));
+        findDeadLatches(inst.words[flags], raw, opcode, (uint16_t)(1 << flags));
+      }
+    }
+
+    // a flag is read if flipping it changes any step
+    for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+    {
+      for (int bit = 0; bit < 4; ++bit)
+      {
+        if (inst.words[flags] != inst.words[flags ^ (1 << bit)])
+          inst.flagsRead |= (uint8_t)(1 << bit);
+      }
+    }
+
+    uint8_t expected = expectedFlags((uint8_t)opcode);
+    if (inst.flagsRead != expected)
+    {
+      std::string detail = "reads " + (inst.flagsRead ? flagList(inst.flagsRead) : std::string("no flags")) +
+                           ", expected " + (expected ? flagList(expected) : std::string("none"));
+      raw.push_back(Finding{ opcode, (uint16_t)0xffff, -1, "flag_variants", detail });
+    }
+  }
+
+  // merge findings shared by flag combinations
+  std::map<FindingKey, size_t> index;
+  std::vector<Finding> findings;
+  for (const Finding& f : raw)
+  {
+    FindingKey key(f.opcode, f.step, f.kind, f.detail);
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+      index[key] = findings.size();
+      findings.push_back(f);
+    }
+    else
+    {
+      findings[it->second].flagMask |= f.flagMask;
+    }
+  }
+
+  std::ostringstream json;
+  json << "{\n  \"fetch_steps\": " << (int)FIRST_STEP << ",\n  \"opcodes\": [\n";
+  for (int opcode = 0; opcode < OPCODES; ++opcode)
+  {
+    const Instruction& inst = instructions[opcode];
+    json << "    {\"opcode\": " << opcode << ", \"desc\": " << jsonString(inst.desc) << ", \"steps\": [";
+    for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+    {
+      if (flags)
+        json << ", ";
+      if (inst.steps[flags] < 0)
+        json << "null";
+      else
+        json << inst.steps[flags];
+    }
+    json << "], \"flags_read\": " << jsonString(flagList(inst.flagsRead)) << "}"
+         << (opcode + 1 < OPCODES ? ",\n" : "\n");
+  }
+  json << "  ],\n  \"findings\": [\n";
+  for (size_t i = 0; i < findings.size(); ++i)
+  {
+    const Finding& f = findings[i];
+    json << "    {\"opcode\": " << f.opcode << ", \"desc\": " << jsonString(instructions[f.opcode].desc)
+         << ", \"kind\": \"" << f.kind << "\", \"step\": ";
+    if (f.step < 0)
+      json << "null";
+    else
+      json << f.step;
+    json << ", \"flag_mask\": " << f.flagMask;
+    if (f.step >= 0)
+    {
+      // the word is the same for every flag combination in the mask
+      int flags = 0;
+      while (!(f.flagMask & (1 << flags)))
+        ++flags;
+      json << ", \"word\": " << jsonString(describeControlWord(instructions[f.opcode].words[flags][f.step - FIRST_STEP]));
+    }
+    json << ", \"detail\": " << jsonString(f.detail) << "}" << (i + 1 < findings.size() ? ",\n" : "\n");
+  }
+  json << "  ]\n}\n";
+
+  if (outFile)
+  {
+    std::ofstream out(outFile, std::ios::trunc);
+    out << json.str();
+  }
+  else
+  {
+    std::cout << json.str();
+  }
+
+  std::map<std::string, int> counts;
+  for (const Finding& f : findings)
+  {
+    ++counts[f.kind];
+    fprintf(stderr, "%02x %-28s ", f.opcode, instructions[f.opcode].desc.c_str());
+    if (f.step >= 0)
+      fprintf(stderr, "step %d ", f.step);
+    if (f.flagMask != 0xffff)
+      fprintf(stderr, "[flags %04x] ", f.flagMask);
+    fprintf(stderr, "%s: %s\n", f.kind.c_str(), f.detail.c_str());
+  }
+  fprintf(stderr, "%u findings:", (unsigned)findings.size());
+  for (auto& count : counts)
+    fprintf(stderr, " %d %s", count.second, count.first.c_str());
+  fprintf(stderr, "\n");
+  return 0;
+}
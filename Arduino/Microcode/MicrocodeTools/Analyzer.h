@@ -0,0 +1,15 @@
+/*
+ * Troy's 8-bit computer - Microcode cost table and analyzer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#pragma once
+
+// MicrocodeTools analyze [-o costs.json]
+int analyze(int argc, char** argv);
@@ -0,0 +1,117 @@
+/*
+ * Troy's 8-bit computer - Microcode tools: single instruction runs in the emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "EmulatorStep.h"
+
+#include <cstring>
+
+extern "C"
+{
+  #include "computer.h"
+}
+
+static const int MAX_CYCLES = 8;   // the step counter has 3 bits
+
+struct EmulatorStep::Impl
+{
+  Rom rom;
+  std::vector<byte> bytes;
+  Computer* computer;
+  std::vector<uint16_t>* events = nullptr;
+
+  static void onEvent(const SimEvent* ev, void* userData)
+  {
+    Impl* impl = (Impl*)userData;
+    if (impl->events)
+      impl->events->push_back((uint16_t)(ev->type << 8 | ev->value));
+  }
+};
+
+EmulatorStep::EmulatorStep(const std::vector<uint32_t>& romWords) : m_impl(new Impl())
+{
+  // same layout as newRomFromFile: one little endian word per address
+  m_impl->bytes.resize(ROM_WORDS * 4);
+  m_impl->rom.size = (int)m_impl->bytes.size();
+  m_impl->rom.bytes = m_impl->bytes.data();
+  m_impl->rom.stepBits = ROM_STEP_BITS;
+  for (int i = 0; i < ROM_WORDS && i < (int)romWords.size(); ++i)
+  {
+    setWord((uint16_t)i, romWords[i]);
+  }
+
+  Computer* c = newComputerWithRom(&m_impl->rom);
+  computerSetFeatures(c, FEATURE_TRACE);
+  computerEnableEvents(c, EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) |
+                          EVENT_MASK(EventLcdData) | EVENT_MASK(EventPgmWrite), 0);
+  computerSetEventCallback(c, Impl::onEvent, m_impl.get());
+  m_impl->computer = c;
+}
+
+EmulatorStep::~EmulatorStep()
+{
+  destroyComputer(m_impl->computer);
+}
+
+void EmulatorStep::setWord(uint16_t romAddress, uint32_t romWord)
+{
+  byte* b = &m_impl->bytes[(romAddress & (ROM_WORDS - 1)) * 4];
+  b[0] = (byte)romWord;
+  b[1] = (byte)(romWord >> 8);
+  b[2] = (byte)(romWord >> 16);
+  b[3] = (byte)(romWord >> 24);
+}
+
+bool EmulatorStep::run(MachineState& state)
+{
+  Computer* c = m_impl->computer;
+
+  c->ra->value = state.ra;
+  c->rb->value = state.rb;
+  c->rc->value = state.rc;
+  c->rd->value = state.rd;
+  c->sp->value = state.sp;
+  c->alu->out->value = state.acc;
+  c->alu->flags = state.flags;
+  c->pc->r->value = state.pc;
+  c->pc->enabled = 0;
+  c->tc->r->value = 0;
+  c->controlWord = 0;
+  memcpy(c->ram->bytes, state.ram, sizeof(state.ram));
+  memcpy(c->pgm->bytes, state.pgm, sizeof(state.pgm));
+
+  state.events.clear();
+  m_impl->events = &state.events;
+
+  // a step whose control word resets the step counter is the last one
+  bool ended = false;
+  for (int cycle = 0; cycle < MAX_CYCLES && !ended; ++cycle)
+  {
+    computerTick(c, 0);
+    if (c->controlWord & HLT)
+      break;
+    ended = cycle > 0 && c->tc->r->value == 0;
+    computerTick(c, 1);
+  }
+  m_impl->events = nullptr;
+
+  state.ra = c->ra->value;
+  state.rb = c->rb->value;
+  state.rc = c->rc->value;
+  state.rd = c->rd->value;
+  state.sp = c->sp->value;
+  state.acc = c->alu->out->value;
+  state.flags = (uint8_t)c->alu->flags;
+  state.pc = (uint8_t)(c->pc->r->value + (c->pc->enabled ? 1 : 0));  // increment still pending
+  memcpy(state.ram, c->ram->bytes, sizeof(state.ram));
+  memcpy(state.pgm, c->pgm->bytes, sizeof(state.pgm));
+
+  return ended;
+}
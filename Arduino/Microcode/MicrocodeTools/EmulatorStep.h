@@ -0,0 +1,49 @@
+/*
+ * Troy's 8-bit computer - Microcode tools: single instruction runs in the emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// runs one instruction at a time in the emulator core (Emulator/SimLib), so
+// microcode changes can be checked against the emulator's own computerTick.
+// kept apart from Constants.h: SimLib defines the control word bits as macros
+
+struct MachineState
+{
+  uint8_t ra, rb, rc, rd, sp;
+  uint8_t acc;        // ALU register
+  uint8_t flags;      // N = 1, O = 2, C = 4, Z = 8 (as in the rom address)
+  uint8_t pc;
+  uint8_t ram[256];
+  uint8_t pgm[256];
+  std::vector<uint16_t> events;   // type << 8 | value, for Rd outputs, lcd and program memory writes
+};
+
+class EmulatorStep
+{
+  public:
+    // rom words as written to rom.hex (active low bits flipped)
+    explicit EmulatorStep(const std::vector<uint32_t>& romWords);
+    ~EmulatorStep();
+
+    void setWord(uint16_t romAddress, uint32_t romWord);
+
+    // fetch and execute the instruction at state.pc. false if it halts or
+    // never resets the step counter
+    bool run(MachineState& state);
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
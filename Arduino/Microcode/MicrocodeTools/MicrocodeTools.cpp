@@ -15,26 +15,120 @@
 #include <fstream>
 #include "Microcode.h"
 #include "Constants.h"
+#include "Analyzer.h"
+#include "Superoptimizer.h"
 
 
-int main()
+static const int OPCODES = 256;
+static const int FLAG_COMBINATIONS = 16;
+static const uint8_t FIRST_STEP = 2; // steps 0 and 1 fetch the instruction
+
+// write the opcode table used by the emulator's disassembler (SimLib/disasm.c)
+// operand bytes are counted from the microcode: each step that copies PC to the
+// memory address register reads the next program byte. the count is the maximum
+// over all flag combinations (eg. a jump not taken still skips its operand)
+void writeOpcodeTable(const char* filename, const std::string descs[], const uint8_t operands[])
+{
+  std::ofstream file(filename, std::ios::trunc);
+
+  file << "/*\n"
+          " * Troy's 8-bit computer - Emulator\n"
+          " *\n"
+          " * Copyright (c) 2020 Troy Schrapel\n"
+          " *\n"
+          " * This code is licensed under the MIT license\n"
+          " *\n"
+          " * https://github.com/visrealm/vrcpu\n"
+          " *\n"
+          " */\n"
+          "\n"
+          "// generated by Arduino/Microcode/MicrocodeTools. do not edit\n"
+          "\n"
+          "#ifndef _SIMLIB_OPCODES_H_\n"
+          "#define _SIMLIB_OPCODES_H_\n"
+          "\n"
+          "#include \"disasm.h\"\n"
+          "\n"
+          "static const OpcodeInfo opcodeTable[256] = {\n";
+
+  char buf[16];
+  for (int opcode = 0; opcode < OPCODES; ++opcode)
+  {
+    snprintf(buf, sizeof(buf), "/* %02x */ ", opcode);
+    file << "  " << buf << "{ \"" << descs[opcode] << "\", " << (int)operands[opcode] << " },\n";
+  }
+
+  file << "};\n"
+          "\n"
+          "#endif\n";
+}
+
+int main(int argc, char** argv)
 {
-  std::ofstream romFile("../../../Emulator/SimWasm/rom.hex", std::ios::trunc);
+  if (argc > 1 && std::string(argv[1]) == "superopt")
+    return superoptimize(argc - 2, argv + 2);
+  if (argc > 1 && std::string(argv[1]) == "analyze")
+    return analyze(argc - 2, argv + 2);
+
+  // -p: rom for the pipelined machine (FEATURE_PIPELINE in the emulator).
+  // -w: wide step rom (4 bit step counter, emulator only) with the long
+  //     microcoded instructions.
+  // -s: shift unit rom (emulator only) with shl/shr/rlc/rrc Rb.
+  // any of them leave the opcode table alone: it describes the standard
+  // rom, which is what the EEPROMs hold
+  bool pipelined = false;
+  bool wide = false;
+  bool shiftUnit = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::string(argv[i]) == "-p") pipelined = true;
+    else if (std::string(argv[i]) == "-w") wide = true;
+    else if (std::string(argv[i]) == "-s") shiftUnit = true;
+  }
+
+  std::string romName = std::string("../../../Emulator/SimWasm/rom") + (shiftUnit ? "-shift" : "") + (wide ? "-wide" : "") + (pipelined ? "-pipelined" : "") + ".hex";
+  std::ofstream romFile(romName.c_str(), std::ios::trunc);
+
+  EepromAddress::Layout layout = wide ? EepromAddress::WideSteps : EepromAddress::Standard;
+  uint32_t totalWords = wide ? EepromAddress::WIDE_TOTAL_BYTES : EepromAddress::TOTAL_BYTES;
+
+  std::string descs[OPCODES];
+  uint8_t operands[OPCODES] = { 0 };
+  uint8_t operandReads[OPCODES][FLAG_COMBINATIONS] = { { 0 } };
+  bool ended[OPCODES][FLAG_COMBINATIONS] = { { false } };
 
   char buf[10];
-  for (int address = 0; address < EepromAddress::TOTAL_BYTES; ++address)
+  for (uint32_t address = 0; address < totalWords; ++address)
   {
-    EepromAddress addr(address);
+    EepromAddress addr((uint16_t)address, layout);
 
     std::string desc = "<Unassigned>";
 
-    uint32_t controlWord = flipActiveLows(getControlWord(addr, desc));
+    uint32_t rawControlWord = getControlWord(addr, desc, pipelined, shiftUnit);
+    uint32_t controlWord = flipActiveLows(rawControlWord);
     snprintf(buf, sizeof(buf), "%08x", controlWord);
     romFile << buf;
 
     if (addr.flags() == 0 && addr.microtime() == 2)
     {
       printf("%03d: %s: %s\n", (int)addr.opcode(), addr.opcode().bitsToString().c_str(), desc.c_str());
+      descs[addr.opcode()] = desc;
+    }
+
+    uint8_t opcode = addr.opcode();
+    uint8_t flags = addr.flags();
+    if (addr.microtime() >= FIRST_STEP && !ended[opcode][flags])
+    {
+      if ((rawControlWord & 0x7) == BW_PC && (rawControlWord & _MAW))
+      {
+        ++operandReads[opcode][flags];
+        if (operandReads[opcode][flags] > operands[opcode])
+          operands[opcode] = operandReads[opcode][flags];
+      }
+      ended[opcode][flags] = (rawControlWord & _TR) != 0;
     }
   }
+
+  if (!pipelined && !wide && !shiftUnit)
+    writeOpcodeTable("../../../Emulator/SimLib/opcodes.h", descs, operands);
 }
@@ -0,0 +1,1210 @@
+/*
+ * Troy's 8-bit computer - Microcode superoptimizer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: MicrocodeTools superopt [-n limit] [opcode ...]
+//
+// for each opcode (all of them unless hex opcodes are given) search for a
+// shorter sequence of execute steps with the same architectural effect.
+//
+// the search is symbolic: registers, memory and flags hold expressions over
+// the instruction's inputs (registers, flags, operand bytes and memory), and
+// each candidate control word is applied the way computerTick applies it
+// (bus first, then the ALU from the bus and the old Rb, then the latches,
+// then memory at the new MAR; PCC counts at the start of the next step).
+// steps are built from the parts the instruction already uses - its latches,
+// ALU settings, memory space and lcd writes - plus PC and the ALU as
+// scratch. words with two writers of one register (eg. Ra -> Ra, ALU out
+// while latching the ALU, PCC with a PC load, memory read and write) are
+// not generated.
+//
+// sequences are found shortest first (iterative deepening with a
+// transposition table). every hit is then run in the emulator core against
+// the original microcode: every value of each register, Acc, PC and the
+// operand bytes, with random memory and the rest random, for each flag
+// combination sharing the sequence. registers, Acc, flags, memory, Rd
+// outputs and lcd writes must all match.
+//
+// each sequence is searched three times:
+//   exact             everything matches, Acc and flags included
+//   flags free        the flags may differ
+//   Acc, flags free   Acc and the flags may differ
+// (eg. ret saves Acc in PC so it survives the stack pointer increment)
+
+#include "Superoptimizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "Microcode.h"
+#include "Constants.h"
+#include "EmulatorStep.h"
+
+namespace
+{
+  const int OPCODES = 256;
+  const int FLAG_COMBINATIONS = 16;
+  const uint8_t FIRST_STEP = 2;   // steps 0 and 1 fetch the instruction
+  const uint8_t LAST_STEP = 7;
+  const unsigned long long DEFAULT_LIMIT = 50000000ULL;   // steps tried per search
+
+  const uint32_t ALU_SETTINGS = ALU_NOT_A | ALB | ALC | SHF;
+  const uint32_t LATCHES = _ALW | _RdW | _RcW | _RbW | _RaW | _StPW | _MW | _PCW | _MAW;
+
+  // flags, as in the rom address and the emulator's alu
+  const uint8_t FLAG_N = EepromAddress::NegativeFlag;
+  const uint8_t FLAG_O = EepromAddress::OverflowFlag;
+  const uint8_t FLAG_C = EepromAddress::CarryFlag;
+  const uint8_t FLAG_Z = EepromAddress::ZeroFlag;
+
+  enum Ignore
+  {
+    IGNORE_NOTHING,
+    IGNORE_FLAGS,
+    IGNORE_ACC_FLAGS,
+    TIERS
+  };
+
+  const char* tierNames[TIERS] = { "exact", "flags free", "Acc, flags free" };
+
+  // the emulator's alu (Emulator/SimLib/alu.c), for constants
+  void aluConcrete(uint32_t mode, uint8_t a, uint8_t rb, bool useRb, bool carryIn, uint8_t prevAcc,
+                   uint8_t& result, uint8_t& flags)
+  {
+    bool isMinus = mode == AluMode::A_MINUS_B_BITS || mode == AluMode::B_MINUS_A_BITS;
+    unsigned carry = isMinus ? !carryIn : carryIn;
+    unsigned b = useRb ? rb : carry;
+    unsigned addend = useRb ? carry : 0;
+    unsigned wide = 0;
+    bool arithmetic = true;
+
+    switch (mode)
+    {
+      case AluMode::B_MINUS_A_BITS: wide = b - (a + addend); break;
+      case AluMode::A_MINUS_B_BITS: wide = a - (b + addend); break;
+      case AluMode::A_PLUS_B_BITS:  wide = a + b + addend; break;
+      case AluMode::A_XOR_B_BITS:   wide = a ^ b; arithmetic = false; break;
+      case AluMode::A_OR_B_BITS:    wide = a | b; arithmetic = false; break;
+      case AluMode::A_AND_B_BITS:   wide = a & b; arithmetic = false; break;
+      default:                      wide = 0; arithmetic = false; break;
+    }
+
+    result = (uint8_t)wide;
+    bool overflow = arithmetic && (result & 0x80) != (prevAcc & 0x80);
+    bool outOfRange = (wide & 0xff) != wide;
+    flags = ((result & 0x80) ? FLAG_N : 0) |
+            (result == 0 ? FLAG_Z : 0) |
+            ((isMinus ? !outOfRange : outOfRange) ? FLAG_C : 0) |
+            (overflow ? FLAG_O : 0);
+  }
+
+  // the emulator's shift unit, for constants
+  void shiftConcrete(uint32_t mode, uint8_t a, uint8_t& result, uint8_t& flags)
+  {
+    bool carryOut = false;
+    switch (mode << ALU_OFFSET)
+    {
+      case SHIFT_SHL: result = (uint8_t)(a << 1); carryOut = (a & 0x80) != 0; break;
+      case SHIFT_SHR: result = (uint8_t)(a >> 1); carryOut = (a & 0x01) != 0; break;
+      case SHIFT_ROL: result = (uint8_t)((a << 1) | (a >> 7)); carryOut = (a & 0x80) != 0; break;
+      case SHIFT_ROR: result = (uint8_t)((a >> 1) | (a << 7)); carryOut = (a & 0x01) != 0; break;
+      default:        result = 0; break;
+    }
+    flags = ((result & 0x80) ? FLAG_N : 0) | (result == 0 ? FLAG_Z : 0) | (carryOut ? FLAG_C : 0);
+  }
+
+  // ---------------------------------------------------------------------------
+  // expressions, hash consed: equal ids are equal values
+
+  enum ExprOp : uint8_t
+  {
+    E_INPUT,     // a: input
+    E_CONST,     // a: value
+    E_ADDK,      // a + b (mod 256)
+    E_ALU,       // mode: alu mode, a, b, c: carry addend (B_MINUS_A is kept as A_MINUS_B)
+    E_FLAGS,     // mode, a, b, c as E_ALU, d: previous Acc (arithmetic only)
+    E_LOGIC,     // flags of a logical result a (N, Z)
+    E_SHIFT,     // mode: shift mode, a (b: 1 for the flags)
+    E_READ,      // mode: pgm, a: address, b: store chain at the read
+    E_STORE,     // mode: pgm, a: previous store, b: address, c: value
+    E_EVENT      // mode: event type, a: previous event, c: value
+  };
+
+  enum Input
+  {
+    IN_RA, IN_RB, IN_RC, IN_RD, IN_SP, IN_ACC, IN_FLAGS, IN_PC, IN_OPERAND1, IN_OPERAND2,
+    INPUTS
+  };
+
+  enum EventKind
+  {
+    EV_OUTPUT = 0,       // matches SimLib's EventType
+    EV_LCD_COMMAND = 1,
+    EV_LCD_DATA = 2
+  };
+
+  struct Expr
+  {
+    uint8_t op;
+    uint8_t mode;
+    int a, b, c, d;
+
+    bool operator==(const Expr& o) const
+    {
+      return op == o.op && mode == o.mode && a == o.a && b == o.b && c == o.c && d == o.d;
+    }
+  };
+
+  struct ExprHash
+  {
+    size_t operator()(const Expr& e) const
+    {
+      size_t h = e.op * 31u + e.mode;
+      h = h * 1000003u ^ (size_t)e.a;
+      h = h * 1000003u ^ (size_t)e.b;
+      h = h * 1000003u ^ (size_t)e.c;
+      h = h * 1000003u ^ (size_t)e.d;
+      return h;
+    }
+  };
+
+  const int NONE = -1;
+
+  class Exprs
+  {
+    public:
+      explicit Exprs(uint8_t opcode) : m_opcode(opcode)
+      {
+        for (int i = 0; i < INPUTS; ++i)
+          make(E_INPUT, 0, i);
+      }
+
+      int input(Input which) const { return which; }
+
+      int constant(unsigned value) { return make(E_CONST, 0, value & 0xff); }
+
+      bool constValue(int e, uint8_t& value) const
+      {
+        if (m_exprs[e].op != E_CONST)
+          return false;
+        value = (uint8_t)m_exprs[e].a;
+        return true;
+      }
+
+      const Expr& get(int e) const { return m_exprs[e]; }
+
+      int addk(int x, int k)
+      {
+        k &= 0xff;
+        if (k == 0)
+          return x;
+        uint8_t v;
+        if (constValue(x, v))
+          return constant(v + k);
+        if (m_exprs[x].op == E_ADDK)
+          return addk(m_exprs[x].a, m_exprs[x].b + k);
+        return make(E_ADDK, 0, x, k);
+      }
+
+      int aluValue(uint32_t mode, int a, bool useRb, int rb, bool carryIn)
+      {
+        bool isMinus = mode == AluMode::A_MINUS_B_BITS || mode == AluMode::B_MINUS_A_BITS;
+        unsigned carry = isMinus ? !carryIn : carryIn;
+        int b = useRb ? rb : constant(carry);
+        unsigned addend = useRb ? carry : 0;
+
+        uint8_t av = 0, bv = 0;
+        bool ac = constValue(a, av), bc = constValue(b, bv);
+        if (ac && bc)
+        {
+          uint8_t result, flags;
+          aluConcrete(mode, av, useRb ? bv : 0, useRb, carryIn, 0, result, flags);
+          return constant(result);
+        }
+
+        switch (mode)
+        {
+          case AluMode::A_PLUS_B_BITS:
+            if (bc) return addk(a, bv + addend);
+            if (ac) return addk(b, av + addend);
+            return make(E_ALU, AluMode::A_PLUS_B_BITS, std::min(a, b), std::max(a, b), addend);
+
+          case AluMode::B_MINUS_A_BITS:
+            std::swap(a, b);
+            std::swap(ac, bc);
+            std::swap(av, bv);
+            // fall through: b - a == A_MINUS_B with the operands swapped
+          case AluMode::A_MINUS_B_BITS:
+            if (bc) return addk(a, -(int)(bv + addend));
+            return make(E_ALU, AluMode::A_MINUS_B_BITS, a, b, addend);
+
+          case AluMode::A_XOR_B_BITS:
+            if (a == b) return constant(0);
+            if (bc && bv == 0) return a;
+            if (ac && av == 0) return b;
+            return make(E_ALU, (uint8_t)mode, std::min(a, b), std::max(a, b));
+
+          case AluMode::A_OR_B_BITS:
+            if (a == b || (bc && bv == 0)) return a;
+            if (ac && av == 0) return b;
+            if ((bc && bv == 0xff) || (ac && av == 0xff)) return constant(0xff);
+            return make(E_ALU, (uint8_t)mode, std::min(a, b), std::max(a, b));
+
+          case AluMode::A_AND_B_BITS:
+            if (a == b || (bc && bv == 0xff)) return a;
+            if (ac && av == 0xff) return b;
+            if ((bc && bv == 0) || (ac && av == 0)) return constant(0);
+            return make(E_ALU, (uint8_t)mode, std::min(a, b), std::max(a, b));
+
+          default:
+            return constant(0);
+        }
+      }
+
+      int aluFlags(uint32_t mode, int a, bool useRb, int rb, bool carryIn, int prevAcc)
+      {
+        bool isMinus = mode == AluMode::A_MINUS_B_BITS || mode == AluMode::B_MINUS_A_BITS;
+        unsigned carry = isMinus ? !carryIn : carryIn;
+        int b = useRb ? rb : constant(carry);
+        unsigned addend = useRb ? carry : 0;
+
+        uint8_t av = 0, bv = 0, pv = 0;
+        bool ac = constValue(a, av), bc = constValue(b, bv);
+        bool arithmetic = isMinus || mode == AluMode::A_PLUS_B_BITS;
+        if (ac && bc && (!arithmetic || constValue(prevAcc, pv)))
+        {
+          uint8_t result, flags;
+          aluConcrete(mode, av, useRb ? bv : 0, useRb, carryIn, pv, result, flags);
+          return constant(flags);
+        }
+
+        if (!arithmetic)
+        {
+          // N and Z from the result, C and O clear
+          int result = aluValue(mode, a, useRb, rb, carryIn);
+          uint8_t rv;
+          if (constValue(result, rv))
+            return constant(((rv & 0x80) ? FLAG_N : 0) | (rv == 0 ? FLAG_Z : 0));
+          return make(E_LOGIC, 0, result);
+        }
+
+        if (mode == AluMode::B_MINUS_A_BITS)
+        {
+          std::swap(a, b);
+          mode = AluMode::A_MINUS_B_BITS;
+        }
+        else if (mode == AluMode::A_PLUS_B_BITS && a > b)
+        {
+          std::swap(a, b);
+        }
+        return make(E_FLAGS, (uint8_t)mode, a, b, addend, prevAcc);
+      }
+
+      int shift(uint32_t mode, int a, bool flagsOut)
+      {
+        uint8_t av;
+        if (constValue(a, av))
+        {
+          uint8_t result, flags;
+          shiftConcrete(mode, av, result, flags);
+          return constant(flagsOut ? flags : result);
+        }
+        return make(E_SHIFT, (uint8_t)mode, a, flagsOut ? 1 : 0);
+      }
+
+      int read(bool pgm, int address, int chain)
+      {
+        for (int s = chain; s != NONE; s = m_exprs[s].a)
+        {
+          const Expr& store = m_exprs[s];
+          if (store.b == address)
+            return store.c;
+          if (!different(store.b, address))
+            return make(E_READ, pgm, address, s);
+        }
+
+        // the opcode and its operands follow PC
+        if (pgm)
+        {
+          int base, offset;
+          split(address, base, offset);
+          if (base == IN_PC && offset == 0)
+            return constant(m_opcode);
+          if (base == IN_PC && offset == 1)
+            return IN_OPERAND1;
+          if (base == IN_PC && offset == 2)
+            return IN_OPERAND2;
+        }
+        return make(E_READ, pgm, address, NONE);
+      }
+
+      int store(bool pgm, int chain, int address, int value)
+      {
+        // a store over the last one to the same address replaces it
+        if (chain != NONE && m_exprs[chain].b == address)
+          chain = m_exprs[chain].a;
+        return make(E_STORE, pgm, chain, address, value);
+      }
+
+      int event(int chain, EventKind kind, int value)
+      {
+        return make(E_EVENT, (uint8_t)kind, chain, 0, value);
+      }
+
+      size_t size() const { return m_exprs.size(); }
+
+    private:
+      int make(uint8_t op, uint8_t mode, int a, int b = 0, int c = 0, int d = 0)
+      {
+        Expr e = { op, mode, a, b, c, d };
+        auto it = m_index.find(e);
+        if (it != m_index.end())
+          return it->second;
+        int id = (int)m_exprs.size();
+        m_exprs.push_back(e);
+        m_index[e] = id;
+        return id;
+      }
+
+      // address = base + offset. constants have no base
+      void split(int e, int& base, int& offset) const
+      {
+        const Expr& x = m_exprs[e];
+        if (x.op == E_CONST)
+        {
+          base = NONE;
+          offset = x.a;
+        }
+        else if (x.op == E_ADDK)
+        {
+          base = x.a;
+          offset = x.b;
+        }
+        else
+        {
+          base = e;
+          offset = 0;
+        }
+      }
+
+      bool different(int x, int y) const
+      {
+        int bx, ox, by, oy;
+        split(x, bx, ox);
+        split(y, by, oy);
+        return bx == by && ox != oy;
+      }
+
+      uint8_t m_opcode;
+      std::vector<Expr> m_exprs;
+      std::unordered_map<Expr, int, ExprHash> m_index;
+  };
+
+  // ---------------------------------------------------------------------------
+  // machine state over expressions
+
+  enum Reg
+  {
+    R_RA, R_RB, R_RC, R_RD, R_SP, R_PC, R_MAR, R_ACC, R_FLAGS,
+    REGS
+  };
+
+  struct SymState
+  {
+    int reg[REGS];
+    int ram;          // store chains
+    int pgm;
+    int events;
+    uint8_t pending;  // PC increment due at the next step
+    uint8_t stores;   // memory writes so far
+    uint8_t eventCount;
+    uint8_t pad;
+
+    bool operator==(const SymState& o) const { return memcmp(this, &o, sizeof(SymState)) == 0; }
+  };
+
+  struct SymStateHash
+  {
+    size_t operator()(const SymState& s) const
+    {
+      const unsigned char* p = (const unsigned char*)&s;
+      size_t h = 14695981039346656037ULL;
+      for (size_t i = 0; i < sizeof(SymState); ++i)
+        h = (h ^ p[i]) * 1099511628211ULL;
+      return h;
+    }
+  };
+
+  // state at the first execute step: the fetch copied PC to MAR and left an
+  // increment pending
+  SymState initialState()
+  {
+    SymState s;
+    memset(&s, 0, sizeof(s));
+    s.reg[R_RA] = IN_RA;
+    s.reg[R_RB] = IN_RB;
+    s.reg[R_RC] = IN_RC;
+    s.reg[R_RD] = IN_RD;
+    s.reg[R_SP] = IN_SP;
+    s.reg[R_PC] = IN_PC;
+    s.reg[R_MAR] = IN_PC;
+    s.reg[R_ACC] = IN_ACC;
+    s.reg[R_FLAGS] = IN_FLAGS;
+    s.ram = NONE;
+    s.pgm = NONE;
+    s.events = NONE;
+    s.pending = 1;
+    return s;
+  }
+
+  uint32_t sourceLatch(uint32_t source)
+  {
+    switch (source)
+    {
+      case BW_PC:  return _PCW;
+      case BW_StP: return _StPW;
+      case BW_Ra:  return _RaW;
+      case BW_Rb:  return _RbW;
+      case BW_Rc:  return _RcW;
+      case BW_Rd:  return _RdW;
+      case BW_ALU: return _ALW;
+      case BW_MEM: return _MW;
+    }
+    return 0;
+  }
+
+  // one clock cycle with control word w (active high), as computerTick does it
+  SymState step(const SymState& s, uint32_t w, Exprs& ex)
+  {
+    SymState n = s;
+    uint32_t source = w & 0x7;
+    bool pgm = (w & PGM) != 0;
+
+    // low: pending PC increment, memory read at the current MAR
+    if (n.pending)
+      n.reg[R_PC] = ex.addk(n.reg[R_PC], 1);
+    n.pending = (w & PCC) ? 1 : 0;
+
+    int bus = 0;
+    switch (source)
+    {
+      case BW_PC:  bus = n.reg[R_PC]; break;
+      case BW_MEM: bus = ex.read(pgm, s.reg[R_MAR], pgm ? s.pgm : s.ram); break;
+      case BW_StP: bus = s.reg[R_SP]; break;
+      case BW_Ra:  bus = s.reg[R_RA]; break;
+      case BW_Rb:  bus = s.reg[R_RB]; break;
+      case BW_Rc:  bus = s.reg[R_RC]; break;
+      case BW_Rd:  bus = s.reg[R_RD]; break;
+      case BW_ALU: bus = s.reg[R_ACC]; break;
+    }
+
+    // high: the bus writer can't latch its own value
+    uint32_t latches = w & ~sourceLatch(source);
+
+    if (latches & _ALW)
+    {
+      uint32_t mode = (w >> ALU_OFFSET) & AluMode::Mask;
+      if (w & SHF)
+      {
+        n.reg[R_ACC] = ex.shift(mode, bus, false);
+        n.reg[R_FLAGS] = ex.shift(mode, bus, true);
+      }
+      else
+      {
+        n.reg[R_ACC] = ex.aluValue(mode, bus, (w & ALB) != 0, s.reg[R_RB], (w & ALC) != 0);
+        n.reg[R_FLAGS] = ex.aluFlags(mode, bus, (w & ALB) != 0, s.reg[R_RB], (w & ALC) != 0, s.reg[R_ACC]);
+      }
+    }
+    if (latches & _RaW)  n.reg[R_RA] = bus;
+    if (latches & _RbW)  n.reg[R_RB] = bus;
+    if (latches & _RcW)  n.reg[R_RC] = bus;
+    if (latches & _RdW)  n.reg[R_RD] = bus;
+    if (latches & _StPW) n.reg[R_SP] = bus;
+    if (latches & _MAW)  n.reg[R_MAR] = bus;
+    if (latches & _PCW)  n.reg[R_PC] = bus;
+
+    if (latches & _MW)
+    {
+      if (pgm)
+        n.pgm = ex.store(true, n.pgm, n.reg[R_MAR], bus);
+      else
+        n.ram = ex.store(false, n.ram, n.reg[R_MAR], bus);
+      ++n.stores;
+    }
+    if (latches & _RdW)
+    {
+      n.events = ex.event(n.events, EV_OUTPUT, bus);
+      ++n.eventCount;
+    }
+    if (w & LCD)
+    {
+      n.events = ex.event(n.events, pgm ? EV_LCD_DATA : EV_LCD_COMMAND, bus);
+      ++n.eventCount;
+    }
+    return n;
+  }
+
+  // the state as the next instruction sees it
+  SymState settle(const SymState& s, Exprs& ex)
+  {
+    SymState n = s;
+    if (n.pending)
+      n.reg[R_PC] = ex.addk(n.reg[R_PC], 1);
+    n.pending = 0;
+    n.reg[R_MAR] = NONE;   // reloaded by the next fetch
+    return n;
+  }
+
+  // ---------------------------------------------------------------------------
+  // the microcode as generated
+
+  struct Sequence
+  {
+    uint8_t opcode;
+    uint16_t flagsMask;           // flag combinations using this sequence
+    std::string desc;
+    std::vector<uint32_t> steps;  // active high words from FIRST_STEP, _TR left out
+  };
+
+  // execute steps for opcode/flags. false if the instruction halts or
+  // never ends
+  bool executeSteps(uint8_t opcode, uint8_t flags, std::vector<uint32_t>& steps, std::string& desc)
+  {
+    steps.clear();
+    for (uint8_t microtime = FIRST_STEP; microtime <= LAST_STEP; ++microtime)
+    {
+      std::string d;
+      uint32_t w = getControlWord(EepromAddress(flags, microtime, Opcode(opcode)), d);
+      if (microtime == FIRST_STEP)
+        desc = d;
+      if (w & (HLT | _IRW))
+        return false;
+      steps.push_back(w & ~_TR);
+      if (w & _TR)
+        return true;
+    }
+    return false;
+  }
+
+  std::vector<uint32_t> buildRom()
+  {
+    std::vector<uint32_t> words(EepromAddress::TOTAL_BYTES);
+    for (int address = 0; address < EepromAddress::TOTAL_BYTES; ++address)
+    {
+      std::string desc;
+      words[address] = flipActiveLows(getControlWord(EepromAddress((uint16_t)address), desc));
+    }
+    return words;
+  }
+
+  // ---------------------------------------------------------------------------
+  // checking a candidate in the emulator
+
+  struct Rng
+  {
+    uint32_t state = 0x2545f491;
+    uint8_t next()
+    {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return (uint8_t)state;
+    }
+  };
+
+  enum Field
+  {
+    F_RA, F_RB, F_RC, F_RD, F_SP, F_ACC, F_PC, F_OPERAND1, F_OPERAND2,
+    FIELDS,
+    F_RANDOM = FIELDS
+  };
+
+  const int RANDOM_STATES = 512;
+
+  class Checker
+  {
+    public:
+      Checker() : m_rom(buildRom()), m_original(m_rom), m_candidate(m_rom) {}
+
+      // run the candidate against the original microcode. true if no difference
+      bool check(const Sequence& seq, const std::vector<uint32_t>& candidate, Ignore ignore, std::string& why)
+      {
+        install(seq, candidate);
+        bool ok = compare(seq, ignore, why);
+        restore(seq);
+        return ok;
+      }
+
+    private:
+      void install(const Sequence& seq, const std::vector<uint32_t>& candidate)
+      {
+        for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+        {
+          if (!(seq.flagsMask & (1 << flags)))
+            continue;
+          for (size_t i = 0; i < candidate.size(); ++i)
+          {
+            uint32_t w = candidate[i] | (i + 1 == candidate.size() ? _TR : 0);
+            m_candidate.setWord(EepromAddress((uint8_t)flags, (uint8_t)(FIRST_STEP + i), Opcode(seq.opcode)), flipActiveLows(w));
+          }
+        }
+      }
+
+      void restore(const Sequence& seq)
+      {
+        for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+        {
+          for (uint8_t microtime = FIRST_STEP; microtime <= LAST_STEP; ++microtime)
+          {
+            uint16_t address = EepromAddress((uint8_t)flags, microtime, Opcode(seq.opcode));
+            m_candidate.setWord(address, m_rom[address]);
+          }
+        }
+      }
+
+      void randomize(MachineState& s, uint8_t opcode, uint8_t flags)
+      {
+        s.ra = m_rng.next();
+        s.rb = m_rng.next();
+        s.rc = m_rng.next();
+        s.rd = m_rng.next();
+        s.sp = m_rng.next();
+        s.acc = m_rng.next();
+        s.pc = m_rng.next();
+        s.flags = flags;
+        for (int i = 0; i < 256; ++i)
+        {
+          s.ram[i] = m_rng.next();
+          s.pgm[i] = m_rng.next();
+        }
+        s.pgm[s.pc] = opcode;
+      }
+
+      static void setField(MachineState& s, int field, uint8_t value, uint8_t opcode)
+      {
+        switch (field)
+        {
+          case F_RA: s.ra = value; break;
+          case F_RB: s.rb = value; break;
+          case F_RC: s.rc = value; break;
+          case F_RD: s.rd = value; break;
+          case F_SP: s.sp = value; break;
+          case F_ACC: s.acc = value; break;
+          case F_PC:
+            s.pgm[value] = opcode;
+            s.pc = value;
+            break;
+          case F_OPERAND1: s.pgm[(uint8_t)(s.pc + 1)] = value; break;
+          case F_OPERAND2: s.pgm[(uint8_t)(s.pc + 2)] = value; break;
+        }
+      }
+
+      bool compare(const Sequence& seq, Ignore ignore, std::string& why)
+      {
+        for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+        {
+          if (!(seq.flagsMask & (1 << flags)))
+            continue;
+
+          for (int field = 0; field <= F_RANDOM; ++field)
+          {
+            int count = field == F_RANDOM ? RANDOM_STATES : 256;
+            for (int value = 0; value < count; ++value)
+            {
+              MachineState a;
+              randomize(a, seq.opcode, (uint8_t)flags);
+              setField(a, field, (uint8_t)value, seq.opcode);
+              MachineState b = a;
+
+              bool endedA = m_original.run(a);
+              bool endedB = m_candidate.run(b);
+              if (!endedA || !endedB || !same(a, b, ignore, why))
+              {
+                if (endedA != endedB)
+                  why = "doesn't end";
+                return false;
+              }
+            }
+          }
+        }
+        return true;
+      }
+
+      static bool same(const MachineState& a, const MachineState& b, Ignore ignore, std::string& why)
+      {
+        if (a.ra != b.ra) why = "Ra";
+        else if (a.rb != b.rb) why = "Rb";
+        else if (a.rc != b.rc) why = "Rc";
+        else if (a.rd != b.rd) why = "Rd";
+        else if (a.sp != b.sp) why = "SP";
+        else if (a.pc != b.pc) why = "PC";
+        else if (ignore < IGNORE_ACC_FLAGS && a.acc != b.acc) why = "Acc";
+        else if (ignore < IGNORE_FLAGS && a.flags != b.flags) why = "flags";
+        else if (memcmp(a.ram, b.ram, sizeof(a.ram)) != 0) why = "memory";
+        else if (memcmp(a.pgm, b.pgm, sizeof(a.pgm)) != 0) why = "program memory";
+        else if (a.events != b.events) why = "outputs";
+        else return true;
+        return false;
+      }
+
+      std::vector<uint32_t> m_rom;
+      EmulatorStep m_original;
+      EmulatorStep m_candidate;
+      Rng m_rng;
+  };
+
+  // ---------------------------------------------------------------------------
+  // the search
+
+  // control words built from what the original sequence uses
+  std::vector<uint32_t> buildAlphabet(const std::vector<uint32_t>& steps)
+  {
+    uint32_t latches = _ALW | _PCW;
+    uint32_t pcc = 0;
+    std::set<uint32_t> aluSettings = { ALU_A_PLUS_B };   // A + 0: moves a value through the ALU
+    std::set<uint32_t> memSpaces, storeSpaces, lcdWrites;
+
+    for (uint32_t w : steps)
+    {
+      latches |= w & LATCHES;
+      pcc |= w & PCC;
+      if (w & _ALW)
+        aluSettings.insert(w & ALU_SETTINGS);
+      if ((w & 0x7) == BW_MEM)
+        memSpaces.insert(w & PGM);
+      if (w & _MW)
+        storeSpaces.insert(w & PGM);
+      if (w & LCD)
+        lcdWrites.insert(w & (LCD | PGM));
+    }
+
+    std::set<uint32_t> words;
+    for (uint32_t source = 0; source < 8; ++source)
+    {
+      for (uint32_t pgm : { (uint32_t)0, PGM })
+      {
+        // the PGM bit selects program memory for reads, writes and lcd data
+        bool readsMem = source == BW_MEM;
+        if (readsMem && !memSpaces.count(pgm))
+          continue;
+
+        for (uint32_t set = latches; ; set = (set - 1) & latches)
+        {
+          uint32_t sub = set & ~sourceLatch(source);
+          bool valid = sub == set;
+          if (valid && (sub & _MW) && !storeSpaces.count(pgm))
+            valid = false;
+
+          std::vector<uint32_t> lcdOptions = { 0 };
+          for (uint32_t lcd : lcdWrites)
+          {
+            if ((lcd & PGM) == pgm)
+              lcdOptions.push_back(lcd);
+          }
+          // without a memory access or lcd data, PGM means nothing
+          bool pgmUsed = readsMem || (sub & _MW);
+
+          std::vector<uint32_t> alu = { 0 };
+          if (sub & _ALW)
+            alu.assign(aluSettings.begin(), aluSettings.end());
+
+          for (uint32_t lcd : lcdOptions)
+          {
+            if (!valid || (pgm && !pgmUsed && !(lcd & PGM)))
+              continue;
+            for (uint32_t a : alu)
+            {
+              for (uint32_t count : { (uint32_t)0, pcc })
+              {
+                if ((count & PCC) && (sub & _PCW))
+                  continue;
+                uint32_t w = source | pgm | sub | a | count | lcd;
+                if ((w & (LATCHES | PCC | LCD)) == 0)
+                  continue;
+                words.insert(w);
+              }
+            }
+          }
+
+          if (set == 0)
+            break;
+        }
+      }
+    }
+    return std::vector<uint32_t>(words.begin(), words.end());
+  }
+
+  class Search
+  {
+    public:
+      Search(const Sequence& seq, Exprs& ex, Checker& checker, unsigned long long limit)
+        : m_seq(seq), m_ex(ex), m_checker(checker), m_limit(limit)
+      {
+        m_alphabet = buildAlphabet(seq.steps);
+
+        SymState s = initialState();
+        for (uint32_t w : seq.steps)
+          s = step(s, w, m_ex);
+        m_storeCount = s.stores;
+        m_target = settle(s, m_ex);
+
+        for (int e = m_target.events; e != NONE; e = m_ex.get(e).a)
+          m_targetEvents.insert(m_targetEvents.begin(), e);
+      }
+
+      // shortest sequence below maxSteps. false if there is none, or if the
+      // limit was reached first (see exhausted())
+      bool run(Ignore ignore, int maxSteps, std::vector<uint32_t>& found)
+      {
+        m_ignore = ignore;
+        m_exhausted = true;
+        m_nodes = 0;
+        for (int depth = 1; depth <= maxSteps; ++depth)
+        {
+          m_seen.clear();
+          m_path.clear();
+          if (dfs(initialState(), depth))
+          {
+            found = m_path;
+            return true;
+          }
+          if (m_nodes > m_limit)
+          {
+            m_exhausted = false;
+            return false;
+          }
+        }
+        return false;
+      }
+
+      bool exhausted() const { return m_exhausted; }
+      unsigned long long nodes() const { return m_nodes; }
+      size_t alphabetSize() const { return m_alphabet.size(); }
+      const std::vector<std::string>& rejected() const { return m_rejected; }
+
+    private:
+      bool matches(const SymState& s)
+      {
+        SymState n = settle(s, m_ex);
+        for (int r = R_RA; r <= R_PC; ++r)
+        {
+          if (n.reg[r] != m_target.reg[r])
+            return false;
+        }
+        if (m_ignore < IGNORE_ACC_FLAGS && n.reg[R_ACC] != m_target.reg[R_ACC])
+          return false;
+        if (m_ignore < IGNORE_FLAGS && n.reg[R_FLAGS] != m_target.reg[R_FLAGS])
+          return false;
+        return n.ram == m_target.ram && n.pgm == m_target.pgm && n.events == m_target.events;
+      }
+
+      // steps still needed, at least. one step puts one value on the bus (any
+      // number of registers can latch it, and the ALU can latch a result from it)
+      int lowerBound(const SymState& s)
+      {
+        int values[R_SP + 1];
+        int distinct = 0;
+        for (int r = R_RA; r <= R_SP; ++r)
+        {
+          if (s.reg[r] == m_target.reg[r])
+            continue;
+          bool seen = false;
+          for (int i = 0; i < distinct; ++i)
+            seen = seen || values[i] == m_target.reg[r];
+          if (!seen)
+            values[distinct++] = m_target.reg[r];
+        }
+
+        int bound = distinct;
+        int pc = s.pending ? m_ex.addk(s.reg[R_PC], 1) : s.reg[R_PC];
+        if (pc != m_target.reg[R_PC] && bound < 1)
+          bound = 1;
+        if (((m_ignore < IGNORE_ACC_FLAGS && s.reg[R_ACC] != m_target.reg[R_ACC]) ||
+             (m_ignore < IGNORE_FLAGS && s.reg[R_FLAGS] != m_target.reg[R_FLAGS])) && bound < 1)
+          bound = 1;
+
+        // an Rd output and an lcd write can share a step
+        int events = ((int)m_targetEvents.size() - s.eventCount + 1) / 2;
+        if (events > bound)
+          bound = events;
+        if ((int)m_storeCount - s.stores > bound)
+          bound = m_storeCount - s.stores;
+        return bound;
+      }
+
+      bool dfs(const SymState& s, int remaining)
+      {
+        if (!m_path.empty() && matches(s) && verify())
+          return true;
+        if (remaining == 0 || lowerBound(s) > remaining)
+          return false;
+
+        auto it = m_seen.find(s);
+        if (it != m_seen.end() && it->second >= remaining)
+          return false;
+        m_seen[s] = remaining;
+
+        for (uint32_t w : m_alphabet)
+        {
+          if (++m_nodes > m_limit)
+            return false;
+
+          SymState n = step(s, w, m_ex);
+          if (n.stores > m_storeCount || n.eventCount > m_targetEvents.size())
+            continue;
+          if (n.eventCount > s.eventCount && n.events != m_targetEvents[n.eventCount - 1])
+            continue;
+
+          m_path.push_back(w);
+          if (dfs(n, remaining - 1))
+            return true;
+          m_path.pop_back();
+        }
+        return false;
+      }
+
+      bool verify()
+      {
+        std::string why;
+        if (m_checker.check(m_seq, m_path, m_ignore, why))
+          return true;
+        m_rejected.push_back(why);
+        return false;
+      }
+
+      const Sequence& m_seq;
+      Exprs& m_ex;
+      Checker& m_checker;
+      unsigned long long m_limit;
+      unsigned long long m_nodes = 0;
+      bool m_exhausted = true;
+      Ignore m_ignore = IGNORE_NOTHING;
+
+      std::vector<uint32_t> m_alphabet;
+      SymState m_target;
+      uint8_t m_storeCount = 0;
+      std::vector<int> m_targetEvents;   // event chain after each event
+
+      std::unordered_map<SymState, int, SymStateHash> m_seen;
+      std::vector<uint32_t> m_path;
+      std::vector<std::string> m_rejected;
+  };
+
+  std::string flagsText(uint16_t mask)
+  {
+    if (mask == (1 << FLAG_COMBINATIONS) - 1)
+      return "";
+
+    // a single flag deciding (eg. jz) reads better than a list
+    for (uint8_t flag : { FLAG_N, FLAG_O, FLAG_C, FLAG_Z })
+    {
+      uint16_t set = 0;
+      for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+      {
+        if (flags & flag)
+          set |= (uint16_t)(1 << flags);
+      }
+      const char* name = flag == FLAG_N ? "N" : flag == FLAG_O ? "O" : flag == FLAG_C ? "C" : "Z";
+      if (mask == set)
+        return std::string(" [") + name + "]";
+      if (mask == (uint16_t)~set)
+        return std::string(" [!") + name + "]";
+    }
+
+    char buf[16];
+    snprintf(buf, sizeof(buf), " [%04x]", mask);
+    return buf;
+  }
+
+  void printSteps(const std::vector<uint32_t>& steps)
+  {
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+      uint32_t w = steps[i] | (i + 1 == steps.size() ? _TR : 0);
+      printf("        %d: %s\n", (int)(FIRST_STEP + i), describeControlWord(w).c_str());
+    }
+  }
+}
+
+
+std::string describeControlWord(uint32_t w)
+{
+  static const char* sources[] = { "ALU", "Rd", "Rc", "Rb", "Ra", "StP", "MEM", "PC" };
+
+  uint32_t source = w & 0x7;
+  std::string text = (source == BW_MEM && (w & PGM)) ? "PGM" : sources[source];
+
+  std::vector<std::string> targets;
+  if (w & _RaW)  targets.push_back("Ra");
+  if (w & _RbW)  targets.push_back("Rb");
+  if (w & _RcW)  targets.push_back("Rc");
+  if (w & _RdW)  targets.push_back("Rd");
+  if (w & _StPW) targets.push_back("StP");
+  if (w & _PCW)  targets.push_back("PC");
+  if (w & _MAW)  targets.push_back("MAR");
+  if (w & _IRW)  targets.push_back("IR");
+  if (w & _MW)   targets.push_back((w & PGM) ? "PGM" : "MEM");
+
+  if (w & _ALW)
+  {
+    // B is Rb (ALB) or the carry in (inverted for subtraction)
+    uint32_t mode = (w >> ALU_OFFSET) & AluMode::Mask;
+    bool rb = (w & ALB) != 0;
+    bool carry = (w & ALC) != 0;
+    std::string op;
+    if (w & SHF)
+    {
+      switch (mode << ALU_OFFSET)
+      {
+        case SHIFT_SHL: op = "A<<1"; break;
+        case SHIFT_SHR: op = "A>>1"; break;
+        case SHIFT_ROL: op = "rlc A"; break;
+        case SHIFT_ROR: op = "rrc A"; break;
+        default:        op = "0"; break;
+      }
+    }
+    else
+    {
+      switch (mode)
+      {
+        case AluMode::A_PLUS_B_BITS:
+          op = rb ? (carry ? "A+Rb+1" : "A+Rb") : (carry ? "A+1" : "A+0");
+          break;
+        case AluMode::A_MINUS_B_BITS:
+          op = rb ? (carry ? "A-Rb" : "A-Rb-1") : (carry ? "A-0" : "A-1");
+          break;
+        case AluMode::B_MINUS_A_BITS:
+          op = rb ? (carry ? "Rb-A" : "Rb-A-1") : (carry ? "0-A" : "1-A");
+          break;
+        case AluMode::A_XOR_B_BITS: op = rb ? "A^Rb" : (carry ? "A^1" : "A^0"); break;
+        case AluMode::A_OR_B_BITS:  op = rb ? "A|Rb" : (carry ? "A|1" : "A|0"); break;
+        case AluMode::A_AND_B_BITS: op = rb ? "A&Rb" : (carry ? "A&1" : "A&0"); break;
+        default:                    op = "0"; break;
+      }
+    }
+    targets.push_back("ALU[" + op + "]");
+  }
+
+  if (w & LCD)
+    targets.push_back((w & PGM) ? "LCD data" : "LCD command");
+
+  // nothing reads the bus: only the other bits matter
+  if (targets.empty())
+    text.clear();
+  else
+    text += " ->";
+  for (size_t i = 0; i < targets.size(); ++i)
+    text += (i ? ", " : " ") + targets[i];
+
+  if (w & PCC)
+    text += ", PC++";
+  if (w & HLT)
+    text += ", HLT";
+  if (w & _TR)
+    text += ", end";
+  if (text.compare(0, 2, ", ") == 0)
+    text.erase(0, 2);
+  return text.empty() ? "-" : text;
+}
+
+int superoptimize(int argc, char** argv)
+{
+  unsigned long long limit = DEFAULT_LIMIT;
+  std::set<int> only;
+  for (int i = 0; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      limit = strtoull(argv[++i], nullptr, 0);
+    else
+      only.insert((int)strtoul(argv[i], nullptr, 16) & 0xff);
+  }
+
+  // one sequence per opcode and distinct flag behaviour
+  std::vector<Sequence> sequences;
+  for (int opcode = 0; opcode < OPCODES; ++opcode)
+  {
+    if (!only.empty() && !only.count(opcode))
+      continue;
+
+    std::map<std::vector<uint32_t>, size_t> index;
+    for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+    {
+      std::vector<uint32_t> steps;
+      std::string desc;
+      if (!executeSteps((uint8_t)opcode, (uint8_t)flags, steps, desc) || steps.size() < 2)
+        continue;
+
+      auto it = index.find(steps);
+      if (it == index.end())
+      {
+        index[steps] = sequences.size();
+        sequences.push_back(Sequence{ (uint8_t)opcode, (uint16_t)(1 << flags), desc, steps });
+      }
+      else
+      {
+        sequences[it->second].flagsMask |= (uint16_t)(1 << flags);
+      }
+    }
+  }
+
+  Checker checker;
+  int shortened[TIERS] = { 0 };
+  int saved[TIERS] = { 0 };
+  int incomplete = 0;
+
+  for (const Sequence& seq : sequences)
+  {
+    printf("%02x %-36s %d steps\n", seq.opcode, (seq.desc + flagsText(seq.flagsMask)).c_str(), (int)seq.steps.size());
+
+    Exprs ex(seq.opcode);
+    Search search(seq, ex, checker, limit);
+
+    // each tier is at least as free as the one before
+    int best = (int)seq.steps.size();
+    for (int tier = IGNORE_NOTHING; tier < TIERS; ++tier)
+    {
+      std::vector<uint32_t> found;
+      bool ok = best > 1 && search.run((Ignore)tier, best - 1, found);
+      printf("    %-16s ", tierNames[tier]);
+      if (ok)
+      {
+        printf("%d steps\n", (int)found.size());
+        printSteps(found);
+        best = (int)found.size();
+        ++shortened[tier];
+        saved[tier] += (int)(seq.steps.size() - found.size());
+      }
+      else if (!search.exhausted())
+      {
+        printf("search limit reached\n");
+        ++incomplete;
+      }
+      else
+      {
+        printf("%s\n", best < (int)seq.steps.size() ? "-" : "no shorter sequence");
+      }
+    }
+    for (auto& why : search.rejected())
+      printf("    (a candidate failed in the emulator: %s)\n", why.c_str());
+  }
+
+  printf("\n%u sequences searched (%d searches hit the limit of %llu steps)\n", (unsigned)sequences.size(), incomplete, limit);
+  for (int tier = IGNORE_NOTHING; tier < TIERS; ++tier)
+  {
+    printf("  %-16s %d shorter, %d steps saved\n", tierNames[tier], shortened[tier], saved[tier]);
+  }
+  return 0;
+}
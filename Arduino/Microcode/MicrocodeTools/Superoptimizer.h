@@ -0,0 +1,22 @@
+/*
+ * Troy's 8-bit computer - Microcode superoptimizer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// a control word (active high, as returned by getControlWord) as text,
+// eg. "StP -> MAR, ALU[A+1]"
+std::string describeControlWord(uint32_t controlWord);
+
+// MicrocodeTools superopt [-n limit] [opcode ...]
+int superoptimize(int argc, char** argv);
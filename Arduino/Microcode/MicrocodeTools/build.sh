@@ -0,0 +1,16 @@
+#!/bin/sh
+# Linux build of the microcode tools
+
+cd "$(dirname "$0")"
+
+# the superoptimizer checks its results in the emulator core (SimLib)
+sim=../../../Emulator
+obj=$(mktemp -d)
+for src in $sim/SimLib/alu.c $sim/SimLib/computer.c $sim/SimLib/register.c $sim/SimLib/ram.c $sim/SimLib/rom.c \
+           $sim/SimLib/counter.c $sim/SimLib/bus.c $sim/SimLib/events.c $sim/SimLib/lcdshadow.c $sim/vrEmuLcd/src/vrEmuLcd.c
+do
+  cc -O2 -c -I $sim/SimLib -I $sim/vrEmuLcd/src -o "$obj/$(basename "$src" .c).o" "$src"
+done
+c++ -O2 -std=c++14 -o MicrocodeTools -I .. -I $sim/SimLib -I $sim/vrEmuLcd/src \
+    MicrocodeTools.cpp Analyzer.cpp Superoptimizer.cpp EmulatorStep.cpp ../Microcode.cpp "$obj"/*.o
+rm -rf "$obj"
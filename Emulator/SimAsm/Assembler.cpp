@@ -0,0 +1,1444 @@
+/*
+ * Troy's 8-bit computer - Assembler
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "Assembler.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+
+namespace
+{
+  static const int MAX_PASSES = 16;
+
+  struct AsmException
+  {
+    std::string message;
+  };
+
+  [[noreturn]] void fail(const std::string& message)
+  {
+    throw AsmException{ message };
+  }
+
+  std::string toLower(const std::string& str)
+  {
+    std::string lower = str;
+    for (auto& ch : lower)
+    {
+      ch = (char)std::tolower((unsigned char)ch);
+    }
+    return lower;
+  }
+
+
+  // values
+  //
+  // integers of any width, stored two's complement lsb first with at least
+  // the sign bit. size is the declared width (from a literal's digits, a
+  // slice or a concatenation), or -1 if the width isn't known
+  struct Value
+  {
+    std::vector<uint8_t> bits;
+    int size = -1;
+    bool boolean = false;
+    bool isVoid = false;
+
+    uint8_t bit(size_t i) const
+    {
+      return i < bits.size() ? bits[i] : bits.back();
+    }
+
+    bool negative() const
+    {
+      return bits.back() != 0;
+    }
+
+    void trim()
+    {
+      while (bits.size() > 1 && bits[bits.size() - 1] == bits[bits.size() - 2])
+      {
+        bits.pop_back();
+      }
+    }
+
+    // minimum width: unsigned for positive values, two's complement for negative
+    int width() const
+    {
+      if (negative())
+        return (int)bits.size();
+
+      int w = 0;
+      for (size_t i = 0; i < bits.size(); ++i)
+      {
+        if (bits[i]) w = (int)i + 1;
+      }
+      return w;
+    }
+
+    int64_t toInt() const
+    {
+      if (boolean || isVoid)
+        fail("expected an integer");
+      if (bits.size() > 64)
+        fail("value too large for arithmetic");
+
+      uint64_t v = 0;
+      for (size_t i = 0; i < 64; ++i)
+      {
+        v |= (uint64_t)bit(i) << i;
+      }
+      return (int64_t)v;
+    }
+
+    bool toBool() const
+    {
+      if (!boolean)
+        fail("expected a boolean");
+      return bits[0] != 0;
+    }
+
+    static Value fromInt(int64_t v)
+    {
+      Value value;
+      value.bits.resize(64);
+      for (size_t i = 0; i < 64; ++i)
+      {
+        value.bits[i] = (uint8_t)(((uint64_t)v >> i) & 1);
+      }
+      value.trim();
+      return value;
+    }
+
+    static Value fromBool(bool b)
+    {
+      Value value;
+      value.bits.push_back(b ? 1 : 0);
+      value.boolean = true;
+      return value;
+    }
+
+    // the low size bits, zero extended
+    static Value fromBits(const Value& source, int lo, int size)
+    {
+      Value value;
+      value.bits.resize(size + 1);
+      for (int i = 0; i < size; ++i)
+      {
+        value.bits[i] = source.bit(lo + i);
+      }
+      value.bits[size] = 0;
+      value.trim();
+      value.size = size;
+      return value;
+    }
+  };
+
+  Value parseNumber(const std::string& text)
+  {
+    int radix = 10;
+    size_t start = 0;
+    if (text.size() > 2 && text[0] == '0' && text[1] == 'x') { radix = 16; start = 2; }
+    else if (text.size() > 2 && text[0] == '0' && text[1] == 'b') { radix = 2; start = 2; }
+
+    Value value;
+    if (radix == 10)
+    {
+      uint64_t v = 0;
+      for (size_t i = start; i < text.size(); ++i)
+      {
+        if (text[i] == '_') continue;
+        if (!std::isdigit((unsigned char)text[i]))
+          fail("invalid number: " + text);
+        uint64_t next = v * 10 + (text[i] - '0');
+        if (next / 10 != v || next > (uint64_t)INT64_MAX)
+          fail("number too large: " + text);
+        v = next;
+      }
+      return Value::fromInt((int64_t)v);
+    }
+
+    // hex and binary literals have a width: 4 or 1 bits per digit
+    int bitsPerDigit = (radix == 16) ? 4 : 1;
+    std::vector<uint8_t> msbFirst;
+    for (size_t i = start; i < text.size(); ++i)
+    {
+      char ch = (char)std::tolower((unsigned char)text[i]);
+      if (ch == '_') continue;
+
+      int digit = -1;
+      if (ch >= '0' && ch <= '9') digit = ch - '0';
+      else if (ch >= 'a' && ch <= 'f') digit = ch - 'a' + 10;
+      if (digit < 0 || digit >= radix)
+        fail("invalid number: " + text);
+
+      for (int b = bitsPerDigit - 1; b >= 0; --b)
+      {
+        msbFirst.push_back((uint8_t)((digit >> b) & 1));
+      }
+    }
+    if (msbFirst.empty())
+      fail("invalid number: " + text);
+
+    value.bits.assign(msbFirst.rbegin(), msbFirst.rend());
+    value.bits.push_back(0);
+    value.trim();
+    value.size = (int)msbFirst.size();
+    return value;
+  }
+
+
+  // tokens
+
+  enum TokenType
+  {
+    TokIdent,
+    TokNumber,
+    TokString,
+    TokPunct,
+    TokNewline,
+  };
+
+  struct Token
+  {
+    TokenType type;
+    std::string text;   // decoded contents for strings
+    int line;
+  };
+
+  bool isIdentStart(char ch) { return std::isalpha((unsigned char)ch) || ch == '_'; }
+  bool isIdentChar(char ch) { return std::isalnum((unsigned char)ch) || ch == '_'; }
+
+  char decodeEscape(const std::string& text, size_t& i)
+  {
+    char ch = text[i++];
+    switch (ch)
+    {
+      case 'n': return '\n';
+      case 'r': return '\r';
+      case 't': return '\t';
+      case '0': return '\0';
+      case '\\': return '\\';
+      case '"': return '"';
+      case '\'': return '\'';
+      case 'x':
+        if (i + 1 < text.size() && std::isxdigit((unsigned char)text[i]) && std::isxdigit((unsigned char)text[i + 1]))
+        {
+          char hex[3] = { text[i], text[i + 1], 0 };
+          i += 2;
+          return (char)strtol(hex, nullptr, 16);
+        }
+        break;
+    }
+    fail("invalid escape sequence");
+  }
+
+  // tokenize text, starting at the given line number. errors are recorded
+  // against the line they occur on and the rest of that line is skipped
+  std::vector<Token> tokenize(const std::string& text, int firstLine, int lineStep, std::vector<AsmError>& errors)
+  {
+    static const char* punct2[] = { "->", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||" };
+
+    std::vector<Token> tokens;
+    int line = firstLine;
+    size_t i = 0;
+    while (i < text.size())
+    {
+      char ch = text[i];
+      try
+      {
+        if (ch == '\n')
+        {
+          tokens.push_back({ TokNewline, "", line });
+          line += lineStep;
+          ++i;
+        }
+        else if (std::isspace((unsigned char)ch))
+        {
+          ++i;
+        }
+        else if (ch == ';')
+        {
+          while (i < text.size() && text[i] != '\n') ++i;
+        }
+        else if (isIdentStart(ch) || (ch == '.' && i + 1 < text.size() && isIdentStart(text[i + 1])))
+        {
+          size_t start = i++;
+          while (i < text.size() && isIdentChar(text[i])) ++i;
+          tokens.push_back({ TokIdent, text.substr(start, i - start), line });
+        }
+        else if (std::isdigit((unsigned char)ch))
+        {
+          size_t start = i++;
+          while (i < text.size() && isIdentChar(text[i])) ++i;
+          tokens.push_back({ TokNumber, text.substr(start, i - start), line });
+        }
+        else if (ch == '"')
+        {
+          std::string str;
+          ++i;
+          while (i < text.size() && text[i] != '"' && text[i] != '\n')
+          {
+            if (text[i] == '\\')
+            {
+              ++i;
+              if (i >= text.size()) break;
+              str += decodeEscape(text, i);
+            }
+            else
+            {
+              str += text[i++];
+            }
+          }
+          if (i >= text.size() || text[i] != '"')
+            fail("unterminated string");
+          ++i;
+          tokens.push_back({ TokString, str, line });
+        }
+        else
+        {
+          std::string p(1, ch);
+          for (auto p2 : punct2)
+          {
+            if (text.compare(i, 2, p2) == 0)
+            {
+              p = p2;
+              break;
+            }
+          }
+          if (std::string("-<>=!&|+*/%^@#,:(){}[]").find(ch) == std::string::npos)
+            fail(std::string("unexpected character '") + ch + "'");
+          i += p.size();
+          tokens.push_back({ TokPunct, p, line });
+        }
+      }
+      catch (const AsmException& e)
+      {
+        errors.push_back({ line, e.message });
+        while (i < text.size() && text[i] != '\n') ++i;
+      }
+    }
+    tokens.push_back({ TokNewline, "", line });
+    return tokens;
+  }
+
+
+  // expressions
+
+  struct Expr;
+  typedef std::shared_ptr<const Expr> ExprPtr;
+
+  struct Expr
+  {
+    enum Kind
+    {
+      Number,
+      Ident,
+      Unary,
+      Binary,
+      Slice,
+      Call,
+      Block,
+    };
+
+    Kind kind;
+    Value value;                // Number
+    std::string name;           // Ident, Call, operator for Unary/Binary
+    int hi = 0, lo = 0;         // Slice
+    std::vector<ExprPtr> args;  // operands, call arguments, block statements
+  };
+
+  class Parser
+  {
+    public:
+      Parser(const std::vector<Token>& tokens, size_t pos, size_t end) : m_tokens(tokens), m_pos(pos), m_end(end) {}
+
+      size_t pos() const { return m_pos; }
+      bool atEnd() const { return m_pos >= m_end; }
+
+      const Token* peek() const { return atEnd() ? nullptr : &m_tokens[m_pos]; }
+
+      bool isPunct(const char* p) const
+      {
+        const Token* t = peek();
+        return t && t->type == TokPunct && t->text == p;
+      }
+
+      bool isNewline() const
+      {
+        const Token* t = peek();
+        return t && t->type == TokNewline;
+      }
+
+      void expect(const char* p)
+      {
+        if (!isPunct(p))
+          fail(std::string("expected '") + p + "'");
+        ++m_pos;
+      }
+
+      const Token& next()
+      {
+        if (atEnd())
+          fail("unexpected end of line");
+        return m_tokens[m_pos++];
+      }
+
+      void skipNewlines()
+      {
+        while (isNewline()) ++m_pos;
+      }
+
+      ExprPtr parseExpr()
+      {
+        return parseBinary(0);
+      }
+
+      // { statement (newline statement)* }
+      ExprPtr parseBlock()
+      {
+        expect("{");
+        auto block = std::make_shared<Expr>();
+        block->kind = Expr::Block;
+        for (;;)
+        {
+          skipNewlines();
+          if (isPunct("}"))
+            break;
+          block->args.push_back(parseExpr());
+          if (!isNewline() && !isPunct("}"))
+            fail("expected end of statement");
+        }
+        expect("}");
+        return block;
+      }
+
+    private:
+      // lowest to highest precedence
+      int precedence(const std::string& op) const
+      {
+        static const char* levels[][6] = {
+          { "@" },
+          { "||" },
+          { "&&" },
+          { "==", "!=", "<", ">", "<=", ">=" },
+          { "|" },
+          { "^" },
+          { "&" },
+          { "<<", ">>" },
+          { "+", "-" },
+          { "*", "/", "%" },
+        };
+        for (int level = 0; level < (int)(sizeof(levels) / sizeof(levels[0])); ++level)
+        {
+          for (auto o : levels[level])
+          {
+            if (o && op == o) return level;
+          }
+        }
+        return -1;
+      }
+
+      static const int UNARY_LEVEL = 10;
+
+      ExprPtr parseBinary(int level)
+      {
+        if (level >= UNARY_LEVEL)
+          return parseUnary();
+
+        ExprPtr lhs = parseBinary(level + 1);
+        for (;;)
+        {
+          const Token* t = peek();
+          if (!t || t->type != TokPunct || precedence(t->text) != level)
+            return lhs;
+          ++m_pos;
+
+          auto e = std::make_shared<Expr>();
+          e->kind = Expr::Binary;
+          e->name = t->text;
+          e->args.push_back(lhs);
+          e->args.push_back(parseBinary(level + 1));
+          lhs = e;
+        }
+      }
+
+      // unary operators apply before slices: -1[3:0] is (-1)[3:0]
+      ExprPtr parseUnary()
+      {
+        ExprPtr operand = parsePrefix();
+        while (isPunct("["))
+        {
+          ++m_pos;
+          auto e = std::make_shared<Expr>();
+          e->kind = Expr::Slice;
+          e->hi = (int)parseSliceIndex();
+          expect(":");
+          e->lo = (int)parseSliceIndex();
+          expect("]");
+          if (e->hi < e->lo)
+            fail("invalid slice");
+          e->args.push_back(operand);
+          operand = e;
+        }
+        return operand;
+      }
+
+      ExprPtr parsePrefix()
+      {
+        if (isPunct("-") || isPunct("!"))
+        {
+          auto e = std::make_shared<Expr>();
+          e->kind = Expr::Unary;
+          e->name = next().text;
+          e->args.push_back(parsePrefix());
+          return e;
+        }
+        return parsePrimary();
+      }
+
+      int64_t parseSliceIndex()
+      {
+        const Token& t = next();
+        if (t.type != TokNumber)
+          fail("expected slice index");
+        return parseNumber(t.text).toInt();
+      }
+
+      ExprPtr parsePrimary()
+      {
+        if (isPunct("{"))
+          return parseBlock();
+
+        const Token& t = next();
+        auto e = std::make_shared<Expr>();
+        switch (t.type)
+        {
+          case TokNumber:
+            e->kind = Expr::Number;
+            e->value = parseNumber(t.text);
+            return e;
+
+          case TokIdent:
+            if (isPunct("("))
+            {
+              ++m_pos;
+              e->kind = Expr::Call;
+              e->name = t.text;
+              while (!isPunct(")"))
+              {
+                e->args.push_back(parseExpr());
+                if (!isPunct(")"))
+                  expect(",");
+              }
+              ++m_pos;
+              return e;
+            }
+            e->kind = Expr::Ident;
+            e->name = t.text;
+            return e;
+
+          case TokPunct:
+            if (t.text == "(")
+            {
+              ExprPtr inner = parseExpr();
+              expect(")");
+              return inner;
+            }
+            break;
+
+          default:
+            break;
+        }
+        fail("expected expression");
+      }
+
+    private:
+      const std::vector<Token>& m_tokens;
+      size_t m_pos;
+      size_t m_end;
+  };
+
+
+  // cpudef rules
+
+  struct PatternPart
+  {
+    bool param;
+    std::string text;       // literal (lower case for identifiers) or parameter name
+    std::string tokenDef;   // parameter's #tokendef, if any
+  };
+
+  struct Rule
+  {
+    std::vector<PatternPart> pattern;
+    ExprPtr production;
+  };
+
+  typedef std::map<std::string, Value> TokenDef;  // lower case name -> value
+
+
+  // source statements
+
+  struct Argument
+  {
+    std::string name;
+    ExprPtr expr;           // expression parameter, or
+    Value value;            // #tokendef parameter
+  };
+
+  struct Candidate
+  {
+    const Rule* rule;
+    std::vector<Argument> args;
+  };
+
+  struct Statement
+  {
+    enum Kind
+    {
+      Label,
+      Constant,
+      Addr,
+      Data,
+      Str,
+      Instruction,
+    };
+
+    Kind kind;
+    int line;
+    std::string scope;      // global label that .local names belong to
+    std::string key;        // Label, Constant: scoped name
+    ExprPtr expr;           // Constant, Addr
+    std::vector<ExprPtr> exprs;  // Data
+    int dataBits = 0;       // Data
+    std::string text;       // Str
+    std::vector<Candidate> candidates;  // Instruction: rules matching the pattern, in order
+  };
+
+  std::string scopedName(const std::string& name, const std::string& scope)
+  {
+    return name[0] == '.' ? scope + name : name;
+  }
+}
+
+
+struct Assembler::Impl
+{
+  // cpudef
+  int bits = 8;
+  std::map<std::string, TokenDef> tokenDefs;
+  std::vector<Rule> rules;
+  std::map<std::string, std::vector<const Rule*>> rulesByMnemonic;
+  std::vector<Statement> prefix;  // statements following the #cpudef block
+
+  // per assemble
+  std::vector<Statement> statements;
+  std::set<std::string> labelKeys;
+  std::map<std::string, int64_t> labels;
+  std::map<std::string, Value> constants;  // defined so far this pass
+
+  bool finalPass = false;
+  bool guessed = false;   // a forward label without a value yet was used this pass
+
+  std::vector<uint8_t> output;
+  std::vector<AsmSymbol> symbols;
+  std::vector<AsmLineInfo> lineMap;
+  std::vector<AsmError> errors;
+
+  typedef std::map<std::string, Value> Params;
+
+  // evaluation
+
+  Value lookup(const std::string& name, const std::string& scope, const Params* params)
+  {
+    if (params)
+    {
+      auto p = params->find(name);
+      if (p != params->end())
+        return p->second;
+    }
+
+    std::string key = scopedName(name, scope);
+    auto c = constants.find(key);
+    if (c != constants.end())
+      return c->second;
+
+    if (labelKeys.count(key))
+    {
+      auto l = labels.find(key);
+      if (l != labels.end())
+        return Value::fromInt(l->second);
+      if (finalPass)
+        fail("unresolved label: " + name);
+      guessed = true;
+      return Value::fromInt(0);
+    }
+
+    fail("unknown variable: " + name);
+  }
+
+  Value eval(const Expr& e, const std::string& scope, const Params* params)
+  {
+    switch (e.kind)
+    {
+      case Expr::Number:
+        return e.value;
+
+      case Expr::Ident:
+        return lookup(e.name, scope, params);
+
+      case Expr::Block:
+      {
+        Value result;
+        result.isVoid = true;
+        for (auto& stmt : e.args)
+        {
+          result = eval(*stmt, scope, params);
+        }
+        return result;
+      }
+
+      case Expr::Call:
+      {
+        if (e.name != "assert" || e.args.size() != 1)
+          fail("unknown function: " + e.name);
+        if (!eval(*e.args[0], scope, params).toBool())
+          fail("assertion failed");
+        Value result;
+        result.isVoid = true;
+        return result;
+      }
+
+      case Expr::Slice:
+        return Value::fromBits(eval(*e.args[0], scope, params), e.lo, e.hi - e.lo + 1);
+
+      case Expr::Unary:
+      {
+        Value v = eval(*e.args[0], scope, params);
+        if (e.name == "!")
+          return v.boolean ? Value::fromBool(!v.toBool()) : Value::fromInt(~v.toInt());
+        return Value::fromInt(-v.toInt());
+      }
+
+      case Expr::Binary:
+        return evalBinary(e, scope, params);
+    }
+    fail("invalid expression");
+  }
+
+  Value evalBinary(const Expr& e, const std::string& scope, const Params* params)
+  {
+    const std::string& op = e.name;
+    Value a = eval(*e.args[0], scope, params);
+
+    if (op == "&&" || op == "||")
+    {
+      bool lhs = a.toBool();
+      if (op == "&&" ? !lhs : lhs)
+        return Value::fromBool(lhs);
+      return Value::fromBool(eval(*e.args[1], scope, params).toBool());
+    }
+
+    Value b = eval(*e.args[1], scope, params);
+
+    if (op == "@")
+    {
+      if (a.size < 0 || b.size < 0 || a.boolean || b.boolean)
+        fail("argument to concatenation with no known width");
+      Value result;
+      result.size = a.size + b.size;
+      result.bits.resize(result.size + 1);
+      for (int i = 0; i < b.size; ++i) result.bits[i] = b.bit(i);
+      for (int i = 0; i < a.size; ++i) result.bits[b.size + i] = a.bit(i);
+      result.bits[result.size] = 0;
+      result.trim();
+      return result;
+    }
+
+    if (a.boolean && b.boolean && (op == "==" || op == "!="))
+      return Value::fromBool((a.bits[0] == b.bits[0]) == (op == "=="));
+
+    int64_t x = a.toInt();
+    int64_t y = b.toInt();
+
+    if (op == "+") return Value::fromInt(x + y);
+    if (op == "-") return Value::fromInt(x - y);
+    if (op == "*") return Value::fromInt(x * y);
+    if (op == "/" || op == "%")
+    {
+      if (y == 0)
+        fail("division by zero");
+      return Value::fromInt(op == "/" ? x / y : x % y);
+    }
+    if (op == "<<") return Value::fromInt(y >= 64 ? 0 : (int64_t)((uint64_t)x << y));
+    if (op == ">>") return Value::fromInt(y >= 64 ? (x < 0 ? -1 : 0) : x >> y);
+    if (op == "&") return Value::fromInt(x & y);
+    if (op == "|") return Value::fromInt(x | y);
+    if (op == "^") return Value::fromInt(x ^ y);
+    if (op == "==") return Value::fromBool(x == y);
+    if (op == "!=") return Value::fromBool(x != y);
+    if (op == "<") return Value::fromBool(x < y);
+    if (op == ">") return Value::fromBool(x > y);
+    if (op == "<=") return Value::fromBool(x <= y);
+    if (op == ">=") return Value::fromBool(x >= y);
+
+    fail("unknown operator: " + op);
+  }
+
+  Value evalCandidate(const Candidate& c, const std::string& scope)
+  {
+    Params params;
+    for (auto& arg : c.args)
+    {
+      params[arg.name] = arg.expr ? eval(*arg.expr, scope, nullptr) : arg.value;
+    }
+
+    Value v = eval(*c.rule->production, scope, &params);
+    if (v.isVoid || v.boolean || v.size <= 0)
+      fail("instruction has no known width");
+    if (v.size % bits != 0)
+      fail("instruction width is not a multiple of " + std::to_string(bits) + " bits");
+    return v;
+  }
+
+
+  // cpudef parsing
+
+  void parseTokenDef(Parser& p)
+  {
+    const Token& name = p.next();
+    if (name.type != TokIdent)
+      fail("expected #tokendef name");
+
+    TokenDef& def = tokenDefs[name.text];
+    p.skipNewlines();
+    p.expect("{");
+    for (;;)
+    {
+      p.skipNewlines();
+      if (p.isPunct("}"))
+        break;
+      const Token& token = p.next();
+      if (token.type != TokIdent)
+        fail("expected token name");
+      p.expect("=");
+      def[toLower(token.text)] = eval(*p.parseExpr(), "", nullptr);
+    }
+    p.expect("}");
+  }
+
+  void parseRule(Parser& p)
+  {
+    Rule rule;
+    while (!p.isPunct("->"))
+    {
+      if (p.isNewline() || p.atEnd())
+        fail("expected '->'");
+
+      if (p.isPunct("{"))
+      {
+        p.next();
+        PatternPart part;
+        part.param = true;
+        const Token& name = p.next();
+        if (name.type != TokIdent)
+          fail("expected parameter name");
+        part.text = name.text;
+        if (p.isPunct(":"))
+        {
+          p.next();
+          part.tokenDef = p.next().text;
+          if (!tokenDefs.count(part.tokenDef))
+            fail("unknown #tokendef: " + part.tokenDef);
+        }
+        p.expect("}");
+        rule.pattern.push_back(part);
+      }
+      else
+      {
+        const Token& t = p.next();
+        PatternPart part;
+        part.param = false;
+        part.text = (t.type == TokIdent) ? toLower(t.text) : t.text;
+        rule.pattern.push_back(part);
+      }
+    }
+    p.expect("->");
+
+    if (rule.pattern.empty() || rule.pattern[0].param)
+      fail("rule must start with a mnemonic");
+
+    rule.production = p.isPunct("{") ? p.parseBlock() : p.parseExpr();
+    if (!p.isNewline())
+      fail("expected end of rule");
+
+    rules.push_back(rule);
+  }
+
+  bool parseCpuDef(const std::string& text)
+  {
+    std::vector<Token> tokens = tokenize(text, -1, -1, errors);
+
+    // locate the #cpudef { ... } block
+    size_t i = 0;
+    while (i + 1 < tokens.size() && !(tokens[i].text == "#" && tokens[i + 1].text == "cpudef"))
+      ++i;
+    if (i + 1 >= tokens.size())
+    {
+      errors.push_back({ 0, "no #cpudef block" });
+      return false;
+    }
+
+    Parser p(tokens, i + 2, tokens.size());
+    try
+    {
+      p.skipNewlines();
+      p.expect("{");
+    }
+    catch (const AsmException& e)
+    {
+      errors.push_back({ tokens[i].line, e.message });
+      return false;
+    }
+
+    for (;;)
+    {
+      p.skipNewlines();
+      if (p.atEnd())
+      {
+        errors.push_back({ tokens.back().line, "unterminated #cpudef block" });
+        return false;
+      }
+      if (p.isPunct("}"))
+        break;
+
+      int line = p.peek()->line;
+      try
+      {
+        if (p.isPunct("#"))
+        {
+          p.next();
+          std::string directive = p.next().text;
+          if (directive == "bits")
+          {
+            bits = (int)eval(*p.parseExpr(), "", nullptr).toInt();
+            if (bits != 8)
+              fail("only #bits 8 is supported");
+          }
+          else if (directive == "tokendef")
+          {
+            parseTokenDef(p);
+          }
+          else
+          {
+            fail("unknown #cpudef directive: " + directive);
+          }
+        }
+        else
+        {
+          parseRule(p);
+        }
+      }
+      catch (const AsmException& e)
+      {
+        errors.push_back({ line, e.message });
+        while (!p.atEnd() && !p.isNewline()) p.next();
+      }
+    }
+    p.next();
+
+    for (auto& rule : rules)
+    {
+      rulesByMnemonic[rule.pattern[0].text].push_back(&rule);
+    }
+
+    // the rest of the file is assembled ahead of every program
+    std::string scope;
+    parseStatements(tokens, p.pos(), prefix, scope);
+    return errors.empty();
+  }
+
+
+  // source parsing
+
+  bool matchRule(const Rule& rule, const std::vector<Token>& tokens, size_t begin, size_t end, Candidate& c)
+  {
+    c.rule = &rule;
+    c.args.clear();
+
+    size_t pos = begin;
+    for (auto& part : rule.pattern)
+    {
+      if (pos >= end)
+        return false;
+
+      const Token& t = tokens[pos];
+      if (!part.param)
+      {
+        std::string text = (t.type == TokIdent) ? toLower(t.text) : t.text;
+        if ((t.type != TokIdent && t.type != TokPunct) || text != part.text)
+          return false;
+        ++pos;
+      }
+      else if (!part.tokenDef.empty())
+      {
+        if (t.type != TokIdent)
+          return false;
+        const TokenDef& def = tokenDefs[part.tokenDef];
+        auto v = def.find(toLower(t.text));
+        if (v == def.end())
+          return false;
+        c.args.push_back({ part.text, nullptr, v->second });
+        ++pos;
+      }
+      else
+      {
+        Parser p(tokens, pos, end);
+        try
+        {
+          c.args.push_back({ part.text, p.parseExpr(), Value() });
+        }
+        catch (const AsmException&)
+        {
+          return false;
+        }
+        pos = p.pos();
+      }
+    }
+    return pos == end;
+  }
+
+  void parseLine(const std::vector<Token>& tokens, size_t begin, size_t end, std::vector<Statement>& out, std::string& scope)
+  {
+    int line = tokens[begin].line;
+    Statement s;
+    s.line = line;
+
+    // label:
+    if (end - begin >= 2 && tokens[begin].type == TokIdent && tokens[begin + 1].text == ":" && tokens[begin + 1].type == TokPunct)
+    {
+      const std::string& name = tokens[begin].text;
+      if (name[0] != '.')
+        scope = name;
+      s.kind = Statement::Label;
+      s.key = scopedName(name, scope);
+      s.scope = scope;
+      out.push_back(s);
+      begin += 2;
+      if (begin == end)
+        return;
+    }
+    s.scope = scope;
+
+    bool constant = end - begin >= 2 && tokens[begin].type == TokIdent && tokens[begin + 1].text == "=" && tokens[begin + 1].type == TokPunct;
+    Parser p(tokens, constant ? begin + 2 : begin, end);
+
+    // name = expression
+    if (constant)
+    {
+      s.kind = Statement::Constant;
+      s.key = scopedName(tokens[begin].text, scope);
+      s.expr = p.parseExpr();
+    }
+    else if (tokens[begin].type == TokPunct && tokens[begin].text == "#")
+    {
+      p.next();
+      const Token& directive = p.next();
+      if (directive.text == "addr")
+      {
+        s.kind = Statement::Addr;
+        s.expr = p.parseExpr();
+      }
+      else if (directive.text == "str")
+      {
+        const Token& str = p.next();
+        if (str.type != TokString)
+          fail("expected string");
+        s.kind = Statement::Str;
+        s.text = str.text;
+      }
+      else if (directive.text.size() > 1 && directive.text[0] == 'd' && std::isdigit((unsigned char)directive.text[1]))
+      {
+        s.kind = Statement::Data;
+        s.dataBits = (int)parseNumber(directive.text.substr(1)).toInt();
+        if (s.dataBits <= 0)
+          fail("invalid data width");
+        s.exprs.push_back(p.parseExpr());
+        while (p.isPunct(","))
+        {
+          p.next();
+          s.exprs.push_back(p.parseExpr());
+        }
+      }
+      else
+      {
+        fail("unknown directive: #" + directive.text);
+      }
+    }
+    else
+    {
+      s.kind = Statement::Instruction;
+      if (tokens[begin].type == TokIdent)
+      {
+        auto rs = rulesByMnemonic.find(toLower(tokens[begin].text));
+        if (rs != rulesByMnemonic.end())
+        {
+          for (auto rule : rs->second)
+          {
+            Candidate c;
+            if (matchRule(*rule, tokens, begin, end, c))
+              s.candidates.push_back(c);
+          }
+        }
+      }
+      if (s.candidates.empty())
+        fail("no match for instruction found");
+      out.push_back(s);
+      return;
+    }
+
+    if (!p.atEnd())
+      fail("expected end of line");
+
+    out.push_back(s);
+  }
+
+  void parseStatements(const std::vector<Token>& tokens, size_t pos, std::vector<Statement>& out, std::string& scope)
+  {
+    while (pos < tokens.size())
+    {
+      size_t end = pos;
+      while (end < tokens.size() && tokens[end].type != TokNewline) ++end;
+      if (end > pos)
+      {
+        try
+        {
+          parseLine(tokens, pos, end, out, scope);
+        }
+        catch (const AsmException& e)
+        {
+          errors.push_back({ tokens[pos].line, e.message });
+        }
+      }
+      pos = end + 1;
+    }
+  }
+
+
+  // passes
+
+  void writeBits(uint64_t& bitPos, const Value& v, int width)
+  {
+    if (!finalPass)
+    {
+      bitPos += width;
+      return;
+    }
+
+    size_t endByte = (size_t)((bitPos + width + 7) / 8);
+    if (output.size() < endByte)
+      output.resize(endByte, 0);
+
+    for (int i = width - 1; i >= 0; --i, ++bitPos)
+    {
+      if (v.bit(i))
+        output[bitPos / 8] |= (uint8_t)(0x80 >> (bitPos % 8));
+      else
+        output[bitPos / 8] &= (uint8_t)~(0x80 >> (bitPos % 8));
+    }
+  }
+
+  // lay out (and in the final pass, emit) every statement.
+  // returns true if any label moved
+  bool runPass(const std::vector<Statement*>& all)
+  {
+    bool changed = false;
+    uint64_t bitPos = 0;
+    uint64_t endPos = 0;
+    guessed = false;
+    constants.clear();
+
+    for (auto sp : all)
+    {
+      const Statement& s = *sp;
+      uint64_t start = bitPos;
+      try
+      {
+        switch (s.kind)
+        {
+          case Statement::Label:
+          {
+            int64_t addr = (int64_t)(bitPos / bits);
+            auto l = labels.find(s.key);
+            if (l == labels.end() || l->second != addr)
+            {
+              labels[s.key] = addr;
+              changed = true;
+            }
+            if (finalPass && s.line > 0)
+              symbols.push_back({ s.key, addr, true });
+            break;
+          }
+
+          case Statement::Constant:
+          {
+            Value v = eval(*s.expr, s.scope, nullptr);
+            constants[s.key] = v;
+            if (finalPass && s.line > 0)
+              symbols.push_back({ s.key, v.boolean ? (int64_t)v.bits[0] : v.toInt(), false });
+            break;
+          }
+
+          case Statement::Addr:
+          {
+            int64_t addr = eval(*s.expr, s.scope, nullptr).toInt();
+            if (addr < 0)
+              fail("invalid address");
+            bitPos = (uint64_t)addr * bits;
+            break;
+          }
+
+          case Statement::Data:
+            for (auto& e : s.exprs)
+            {
+              Value v = eval(*e, s.scope, nullptr);
+              if (v.boolean || v.isVoid)
+                fail("expected an integer");
+              if (finalPass && v.width() > s.dataBits)
+                fail("value (width = " + std::to_string(v.width()) + ") is larger than the specified width; use a bit slice");
+              writeBits(bitPos, v, s.dataBits);
+            }
+            break;
+
+          case Statement::Str:
+            for (unsigned char ch : s.text)
+            {
+              writeBits(bitPos, Value::fromInt(ch), 8);
+            }
+            break;
+
+          case Statement::Instruction:
+          {
+            Value v = chooseCandidate(s);
+            writeBits(bitPos, v, v.size);
+            break;
+          }
+        }
+      }
+      catch (const AsmException& e)
+      {
+        if (finalPass)
+          errors.push_back({ s.line, e.message });
+      }
+
+      if (bitPos > endPos)
+        endPos = bitPos;
+
+      if (finalPass && s.line > 0 && bitPos > start && s.kind != Statement::Addr)
+        lineMap.push_back({ (uint32_t)(start / 8), (uint32_t)((bitPos - start + 7) / 8), s.line, s.kind == Statement::Instruction });
+    }
+
+    if (finalPass && output.size() < (endPos + 7) / 8)
+      output.resize((size_t)((endPos + 7) / 8), 0);
+
+    return changed;
+  }
+
+  // the first candidate that resolves wins (eg. "jmp Rc" isn't "jmp {addr}"
+  // because Rc is not a variable). the instruction is written by the caller
+  Value chooseCandidate(const Statement& s)
+  {
+    AsmException firstError;
+    for (size_t i = 0; i < s.candidates.size(); ++i)
+    {
+      try
+      {
+        return evalCandidate(s.candidates[i], s.scope);
+      }
+      catch (const AsmException& e)
+      {
+        if (i == 0) firstError = e;
+      }
+    }
+
+    if (finalPass)
+      throw firstError;
+
+    // early passes: size from the first candidate, ignoring what isn't known yet
+    guessed = true;
+    try
+    {
+      return evalLenient(s.candidates[0], s.scope);
+    }
+    catch (const AsmException&)
+    {
+      Value v = Value::fromInt(0);
+      v.size = bits;
+      return v;
+    }
+  }
+
+  Value evalLenient(const Candidate& c, const std::string& scope)
+  {
+    Params params;
+    for (auto& arg : c.args)
+    {
+      try
+      {
+        params[arg.name] = arg.expr ? eval(*arg.expr, scope, nullptr) : arg.value;
+      }
+      catch (const AsmException&)
+      {
+        params[arg.name] = Value::fromInt(0);
+      }
+    }
+    return evalSized(*c.rule->production, scope, params);
+  }
+
+  // evaluate a production for its width only: asserts are skipped
+  Value evalSized(const Expr& e, const std::string& scope, const Params& params)
+  {
+    if (e.kind == Expr::Block)
+    {
+      Value result;
+      result.isVoid = true;
+      for (auto& stmt : e.args)
+      {
+        if (stmt->kind != Expr::Call)
+          result = eval(*stmt, scope, &params);
+      }
+      if (result.size <= 0)
+        fail("instruction has no known width");
+      return result;
+    }
+    return eval(e, scope, &params);
+  }
+
+  bool assemble(const std::string& source)
+  {
+    statements.clear();
+    labelKeys.clear();
+    labels.clear();
+    constants.clear();
+    output.clear();
+    symbols.clear();
+    lineMap.clear();
+    errors.clear();
+
+    if (rules.empty())
+    {
+      errors.push_back({ 0, "no cpudef loaded" });
+      return false;
+    }
+
+    std::vector<Token> tokens = tokenize(source, 1, 1, errors);
+    std::string scope;
+    parseStatements(tokens, 0, statements, scope);
+
+    std::vector<Statement*> all;
+    for (auto& s : prefix) all.push_back(&s);
+    for (auto& s : statements) all.push_back(&s);
+
+    for (auto s : all)
+    {
+      if (s->kind == Statement::Label)
+      {
+        if (!labelKeys.insert(s->key).second)
+          errors.push_back({ s->line, "duplicate label: " + s->key });
+      }
+    }
+    if (!errors.empty())
+      return false;
+
+    // lay out until the labels settle, then emit
+    finalPass = false;
+    int pass = 0;
+    for (; pass < MAX_PASSES; ++pass)
+    {
+      bool changed = runPass(all);
+      if (!changed && !guessed)
+        break;
+    }
+    if (pass == MAX_PASSES)
+    {
+      errors.push_back({ 0, "labels did not converge" });
+      return false;
+    }
+
+    finalPass = true;
+    if (runPass(all) && errors.empty())
+      errors.push_back({ 0, "labels did not converge" });
+    finalPass = false;
+
+    if (!errors.empty())
+    {
+      output.clear();
+      return false;
+    }
+    return true;
+  }
+};
+
+
+Assembler::Assembler() : m_impl(new Impl())
+{
+}
+
+Assembler::~Assembler()
+{
+}
+
+bool Assembler::setCpuDef(const std::string& cpuDef)
+{
+  m_impl.reset(new Impl());
+  return m_impl->parseCpuDef(cpuDef);
+}
+
+bool Assembler::assemble(const std::string& source)
+{
+  return m_impl->assemble(source);
+}
+
+const std::vector<uint8_t>& Assembler::output() const
+{
+  return m_impl->output;
+}
+
+const std::vector<AsmSymbol>& Assembler::symbols() const
+{
+  return m_impl->symbols;
+}
+
+const std::vector<AsmLineInfo>& Assembler::lineMap() const
+{
+  return m_impl->lineMap;
+}
+
+const std::vector<AsmError>& Assembler::errors() const
+{
+  return m_impl->errors;
+}
+
+std::string Assembler::hex() const
+{
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(m_impl->output.size() * 2);
+  for (uint8_t b : m_impl->output)
+  {
+    hex += digits[b >> 4];
+    hex += digits[b & 0xf];
+  }
+  return hex;
+}
@@ -0,0 +1,75 @@
+/*
+ * Troy's 8-bit computer - Assembler
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// native assembler for the instruction set described by Web/asm/troyscpudef.asm
+//
+// implements the subset of customasm (the web assembler) the cpudef and the
+// example programs use: #cpudef rules with #tokendef parameters, @ concatenation,
+// bit slices and assert(), labels (and .local labels), constants, expressions,
+// #addr, #dN and #str.
+//
+// as in Web/asm/main.js, the cpudef file is assembled ahead of each source,
+// so its constants (LCD_CMD_*, RAM_OFFSET, ...) are available to programs.
+// the cpudef is parsed once, so an Assembler can be reused for many sources.
+
+struct AsmSymbol
+{
+  std::string name;     // local labels are scoped: "global.local"
+  int64_t value;
+  bool label;           // false for constants
+};
+
+struct AsmLineInfo
+{
+  uint32_t address;     // byte address of the first byte emitted
+  uint32_t size;        // bytes emitted
+  int line;             // source line (1-based)
+  bool instruction;     // false for #dN / #str data
+};
+
+struct AsmError
+{
+  int line;             // source line (1-based). 0 or less: line -n of the cpudef file
+  std::string message;
+};
+
+class Assembler
+{
+  public:
+    Assembler();
+    ~Assembler();
+
+    // load the cpudef file. returns false (see errors()) if it couldn't be parsed
+    bool setCpuDef(const std::string& cpuDef);
+
+    // assemble a source file. returns false (see errors()) on failure
+    bool assemble(const std::string& source);
+
+    // results of the last assemble()
+    const std::vector<uint8_t>& output() const;
+    const std::vector<AsmSymbol>& symbols() const;
+    const std::vector<AsmLineInfo>& lineMap() const;
+    const std::vector<AsmError>& errors() const;
+
+    // output as the hex string loadProgram() expects (program bytes, then ram)
+    std::string hex() const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
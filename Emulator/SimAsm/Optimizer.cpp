@@ -0,0 +1,1256 @@
+/*
+ * Troy's 8-bit computer - Assembler
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "Optimizer.h"
+
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <set>
+
+namespace
+{
+  // control word bits, as SimLib/computer.h. names starting with _ are active low
+  static const uint32_t BUS_SOURCE = 0x7;
+  static const uint32_t BW_PC  = 7;
+  static const uint32_t BW_MEM = 6;
+  static const uint32_t BW_StP = 5;
+  static const uint32_t BW_Ra  = 4;
+  static const uint32_t BW_Rb  = 3;
+  static const uint32_t BW_Rc  = 2;
+  static const uint32_t BW_Rd  = 1;
+  static const uint32_t BW_ALU = 0;
+
+  static const uint32_t ALB  = 1 << 6;
+  static const uint32_t _ALW = 1 << 8;
+  static const uint32_t _RdW = 1 << 9;
+  static const uint32_t _RcW = 1 << 10;
+  static const uint32_t _RbW = 1 << 11;
+  static const uint32_t _RaW = 1 << 12;
+  static const uint32_t _StPW = 1 << 13;
+  static const uint32_t _MW  = 1 << 14;
+  static const uint32_t PGM  = 1 << 15;
+  static const uint32_t _PCW = 1 << 18;
+  static const uint32_t _MAW = 1 << 19;
+  static const uint32_t LCD  = 1 << 20;
+  static const uint32_t _TR  = 1 << 22;
+  static const uint32_t HLT  = 1 << 23;
+
+  // rom address: opcode | step << 8 | flags << (8 + step bits). the wide
+  // step rom (MicrocodeTools -w) has a 4 bit step counter
+  static const int ROM_WORDS = 1 << 15;
+  static const int WIDE_ROM_WORDS = 1 << 16;
+  static const int STEP_BITS = 3;
+  static const int WIDE_STEP_BITS = 4;
+  static const int FIRST_STEP = 2;     // steps 0 and 1 fetch the instruction
+  static const int FLAG_COMBINATIONS = 16;
+  static const uint8_t FLAG_OVERFLOW = 1 << 1;
+
+  static const int PROGRAM_SIZE = 256;
+  static const int MAX_ROUNDS = 256;
+  static const int LIVENESS_DEPTH = 64;
+
+  struct OptException
+  {
+  };
+
+  enum PcSource
+  {
+    PC_UNCHANGED,
+    PC_OPERAND,
+    PC_RAM,
+    PC_OTHER,
+    PC_SOURCES
+  };
+
+  std::string trim(const std::string& str)
+  {
+    size_t begin = str.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+      return "";
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(begin, end - begin + 1);
+  }
+
+  std::string joinLines(const std::vector<std::string>& lines)
+  {
+    std::string text;
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+      text += lines[i];
+      if (i + 1 < lines.size())
+        text += '\n';
+    }
+    return text;
+  }
+
+  std::vector<std::string> splitLines(const std::string& text)
+  {
+    std::vector<std::string> lines;
+    size_t pos = 0;
+    for (;;)
+    {
+      size_t end = text.find('\n', pos);
+      if (end == std::string::npos)
+      {
+        lines.push_back(text.substr(pos));
+        break;
+      }
+      lines.push_back(text.substr(pos, end - pos));
+      pos = end + 1;
+    }
+    return lines;
+  }
+
+
+  // a source line split into its parts:
+  //   <labels:> <indent> <statement> <comment>
+  struct LineParts
+  {
+    std::string labels;                  // label definitions, as written
+    std::vector<std::string> names;      // the labels defined
+    std::string indent;                  // whitespace before the statement
+    std::string statement;
+    std::string comment;                 // from the ';' (with the whitespace before it)
+    std::string eol;                     // "\r" for crlf files
+
+    std::string join() const
+    {
+      return labels + (statement.empty() ? "" : indent + statement) + comment + eol;
+    }
+  };
+
+  LineParts parseLine(const std::string& line)
+  {
+    LineParts parts;
+    std::string text = line;
+    if (!text.empty() && text.back() == '\r')
+    {
+      parts.eol = "\r";
+      text.pop_back();
+    }
+
+    // comment: the first ';' outside a string
+    bool quoted = false;
+    size_t commentPos = text.size();
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+      if (text[i] == '"')
+        quoted = !quoted;
+      else if (text[i] == '\\' && quoted)
+        ++i;
+      else if (text[i] == ';' && !quoted)
+      {
+        commentPos = i;
+        break;
+      }
+    }
+    while (commentPos > 0 && commentPos < text.size() && (text[commentPos - 1] == ' ' || text[commentPos - 1] == '\t'))
+    {
+      --commentPos;
+    }
+    parts.comment = text.substr(commentPos);
+    text = text.substr(0, commentPos);
+
+    // labels: [.]name:
+    size_t pos = 0;
+    for (;;)
+    {
+      size_t p = pos;
+      while (p < text.size() && (text[p] == ' ' || text[p] == '\t')) ++p;
+      size_t nameBegin = p;
+      if (p < text.size() && text[p] == '.') ++p;
+      if (p >= text.size() || !(std::isalpha((unsigned char)text[p]) || text[p] == '_'))
+        break;
+      while (p < text.size() && (std::isalnum((unsigned char)text[p]) || text[p] == '_')) ++p;
+      size_t nameEnd = p;
+      while (p < text.size() && (text[p] == ' ' || text[p] == '\t')) ++p;
+      if (p >= text.size() || text[p] != ':')
+        break;
+      parts.names.push_back(text.substr(nameBegin, nameEnd - nameBegin));
+      pos = p + 1;
+    }
+    parts.labels = text.substr(0, pos);
+
+    size_t stmt = pos;
+    while (stmt < text.size() && (text[stmt] == ' ' || text[stmt] == '\t')) ++stmt;
+    parts.indent = text.substr(pos, stmt - pos);
+    parts.statement = trim(text.substr(stmt));
+    return parts;
+  }
+
+  // an assembled instruction
+  struct Instr
+  {
+    int address;
+    int length;
+    uint8_t opcode;
+    int line;            // 0-based index into the source lines
+    int target;          // first operand byte (jump/call target), -1 without operands
+  };
+}
+
+
+struct Optimizer::Impl
+{
+  Assembler assembler;
+  bool haveCpuDef = false;
+  bool haveRom = false;
+  int maxInlineBytes = 8;
+
+  OpcodeFacts facts[256];
+  std::map<uint8_t, std::string> mnemonics;   // cpudef mnemonic of each jump, branch, call and ret opcode
+
+  std::vector<std::string> lines;
+  std::string source;
+  std::vector<uint32_t> dataAddresses;  // of each #dN / #str line, as first assembled
+  std::vector<OptEdit> edits;
+  std::vector<std::string> warnings;
+  std::vector<AsmError> errors;
+
+  // analysis of the current source
+  uint8_t image[PROGRAM_SIZE];
+  std::vector<Instr> instrs;
+  int at[PROGRAM_SIZE];                // index into instrs of the instruction starting at each address, or -1
+  bool reachable[PROGRAM_SIZE];
+  bool entry[PROGRAM_SIZE];            // labelled or the target of a jump, branch or call
+  std::set<int> referenced;            // bytes that may be addresses (operands and data)
+  std::vector<std::string> scopes;     // global label scope at the end of each line
+  bool reachUnknown = false;           // jumps into something that isn't a whole instruction
+  bool positionDependent = false;
+  bool overflowObserved = false;
+  bool selfModifying = false;
+
+  std::set<std::string> blocked;       // candidates that failed to assemble
+  int labelCounter = 0;
+
+
+  // microcode facts
+
+  void deriveFacts(const std::vector<uint32_t>& rom, int stepBits)
+  {
+    const int steps = 1 << stepBits;
+    for (int op = 0; op < 256; ++op)
+    {
+      OpcodeFacts& f = facts[op];
+      f = OpcodeFacts();
+      f.flow = FLOW_NEXT;
+
+      std::vector<uint32_t> sequences[FLAG_COMBINATIONS];
+      bool halts = false;
+      PcSource pcSource[FLAG_COMBINATIONS];
+
+      for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+      {
+        uint16_t written = 0;
+        bool marFromPc = false;
+        pcSource[flags] = PC_UNCHANGED;
+        int operands = 0;
+        int cycles = steps;
+
+        for (int step = FIRST_STEP; step < steps; ++step)
+        {
+          uint32_t w = rom[op | (step << 8) | (flags << (8 + stepBits))];
+          sequences[flags].push_back(w);
+          if (w & HLT)
+          {
+            halts = true;
+            break;
+          }
+
+          uint32_t src = w & BUS_SOURCE;
+          bool alw = !(w & _ALW);
+          bool mw = !(w & _MW);
+          bool pcw = !(w & _PCW);
+          bool maw = !(w & _MAW);
+          bool regLatch = !(w & _RaW) || !(w & _RbW) || !(w & _RcW) || !(w & _RdW) || !(w & _StPW);
+          bool consumed = alw || mw || pcw || maw || regLatch || (w & LCD);
+
+          // what is on the bus
+          uint16_t source = 0;
+          bool operand = false;
+          switch (src)
+          {
+            case BW_PC:  source = OPT_PC; break;
+            case BW_StP: source = OPT_SP; break;
+            case BW_Ra:  source = OPT_RA; break;
+            case BW_Rb:  source = OPT_RB; break;
+            case BW_Rc:  source = OPT_RC; break;
+            case BW_Rd:  source = OPT_RD; break;
+            case BW_ALU: source = OPT_ACC; break;
+            case BW_MEM:
+              operand = (w & PGM) && marFromPc;
+              source = operand ? 0 : ((w & PGM) ? OPT_PGM : OPT_RAM);
+              break;
+          }
+
+          if (consumed)
+          {
+            f.reads |= source & ~written;
+            if (src == BW_PC && (regLatch || mw))
+              f.readsPc = true;
+          }
+          if (alw && (w & ALB))
+            f.reads |= OPT_RB & ~written;
+
+          if (maw)
+          {
+            marFromPc = (src == BW_PC);
+            if (marFromPc)
+              ++operands;
+          }
+
+          uint16_t writes = 0;
+          if (!(w & _RaW)) writes |= OPT_RA;
+          if (!(w & _RbW)) writes |= OPT_RB;
+          if (!(w & _RcW)) writes |= OPT_RC;
+          if (!(w & _RdW)) writes |= OPT_RD;
+          if (!(w & _StPW)) writes |= OPT_SP;
+          if (alw) writes |= OPT_ACC;
+          if (pcw) writes |= OPT_PC;
+          if (mw) writes |= (w & PGM) ? OPT_PGM : OPT_RAM;
+          if (w & LCD) writes |= OPT_LCD;
+          written |= writes;
+          f.writes |= writes;
+          if (alw)
+            f.writesFlags = true;
+
+          // the last write to PC decides where execution goes (ret parks Acc
+          // in PC for a few steps)
+          if (pcw)
+            pcSource[flags] = operand ? PC_OPERAND : ((src == BW_MEM && !(w & PGM)) ? PC_RAM : PC_OTHER);
+
+          if (!(w & _TR))
+          {
+            cycles = step + 1;
+            break;
+          }
+        }
+
+        if (operands > f.operands)
+          f.operands = operands;
+        if (cycles > f.cycles)
+          f.cycles = cycles;
+      }
+
+      // flags the behaviour depends on
+      int sources[PC_SOURCES] = { 0 };
+      for (int flags = 0; flags < FLAG_COMBINATIONS; ++flags)
+      {
+        for (int bit = 0; bit < 4; ++bit)
+        {
+          if (sequences[flags] != sequences[flags ^ (1 << bit)])
+            f.flagsRead |= (uint8_t)(1 << bit);
+        }
+        if (pcSource[flags] == PC_OPERAND)
+          f.branchTaken |= (uint16_t)(1 << flags);
+        ++sources[pcSource[flags]];
+      }
+
+      if (halts)
+        f.flow = FLOW_HALT;
+      else if (sources[PC_UNCHANGED] == FLAG_COMBINATIONS)
+        f.flow = FLOW_NEXT;
+      else if (sources[PC_OPERAND] == FLAG_COMBINATIONS)
+        f.flow = ((f.writes & OPT_RAM) && (f.writes & OPT_SP)) ? FLOW_CALL : FLOW_JUMP;
+      else if (sources[PC_OPERAND] + sources[PC_UNCHANGED] == FLAG_COMBINATIONS)
+        f.flow = FLOW_BRANCH;
+      else if (sources[PC_RAM] == FLAG_COMBINATIONS && (f.writes & OPT_SP))
+        f.flow = FLOW_RETURN;
+      else if ((f.writes & OPT_RAM) && (f.writes & OPT_SP))
+        f.flow = FLOW_CALL_INDIRECT;
+      else
+        f.flow = FLOW_INDIRECT;
+    }
+  }
+
+  // cpudef mnemonics for the opcodes the rewrites generate, found by
+  // assembling each candidate
+  void findMnemonics()
+  {
+    static const char* candidates[] = { "jmp", "jc", "jz", "jo", "jn", "jnc", "jnz", "jno", "jnn", "call" };
+
+    mnemonics.clear();
+    for (const char* m : candidates)
+    {
+      if (assembler.assemble(std::string(m) + " 0") && assembler.output().size() == 2)
+        mnemonics.emplace(assembler.output()[0], m);
+    }
+    if (assembler.assemble("ret") && assembler.output().size() == 1)
+      mnemonics.emplace(assembler.output()[0], "ret");
+  }
+
+  uint8_t opcode(const std::string& mnemonic)
+  {
+    for (auto& m : mnemonics)
+    {
+      if (m.second == mnemonic)
+        return m.first;
+    }
+    throw OptException();
+  }
+
+  std::string mnemonic(int flow, uint16_t branchTaken = 0)
+  {
+    for (auto& m : mnemonics)
+    {
+      const OpcodeFacts& f = facts[m.first];
+      if (f.flow == flow && (flow != FLOW_BRANCH || f.branchTaken == branchTaken))
+        return m.second;
+    }
+    throw OptException();
+  }
+
+
+  // analysis
+
+  const OpcodeFacts& factsAt(int address) const
+  {
+    return facts[instrs[at[address]].opcode];
+  }
+
+  bool isInstr(int address) const
+  {
+    return address >= 0 && address < PROGRAM_SIZE && at[address] >= 0;
+  }
+
+  int nextAddress(const Instr& i) const
+  {
+    return i.address + i.length;
+  }
+
+  bool assemble(const std::vector<std::string>& text)
+  {
+    if (!assembler.assemble(joinLines(text)))
+      return false;
+
+    // code must fit the program memory, without overlapping anything else.
+    // rules #addr places past it are ram data (eg. "bin" in the ram section),
+    // but code running on from the program memory doesn't fit
+    std::vector<const AsmLineInfo*> infos;
+    uint32_t runEnd = 0;
+    bool programRun = true;
+    for (auto& info : assembler.lineMap())
+    {
+      if (info.address != runEnd)
+        programRun = info.address < PROGRAM_SIZE;
+      runEnd = info.address + info.size;
+      if (info.instruction && programRun && runEnd > PROGRAM_SIZE)
+        return false;
+      infos.push_back(&info);
+    }
+
+    // data running on past the program memory lands in ram, where the program
+    // may also use fixed addresses. it has to stay where it was
+    size_t data = 0;
+    for (auto info : infos)
+    {
+      if (info->instruction)
+        continue;
+      if (data < dataAddresses.size())
+      {
+        uint32_t was = dataAddresses[data];
+        if (info->address != was && (was + info->size > PROGRAM_SIZE || info->address + info->size > PROGRAM_SIZE))
+          return false;
+      }
+      ++data;
+    }
+    for (size_t i = 1; i < infos.size(); ++i)
+    {
+      if (infos[i]->address < infos[i - 1]->address + infos[i - 1]->size && infos[i]->address >= infos[i - 1]->address)
+        return false;
+    }
+    return true;
+  }
+
+  void analyze()
+  {
+    const std::vector<uint8_t>& out = assembler.output();
+    for (int a = 0; a < PROGRAM_SIZE; ++a)
+    {
+      image[a] = a < (int)out.size() ? out[a] : 0;
+      at[a] = -1;
+      reachable[a] = false;
+      entry[a] = false;
+    }
+
+    instrs.clear();
+    referenced.clear();
+    for (auto& info : assembler.lineMap())
+    {
+      if (info.address >= PROGRAM_SIZE)
+        continue;
+
+      if (!info.instruction)
+      {
+        for (uint32_t a = info.address; a < info.address + info.size && a < PROGRAM_SIZE; ++a)
+        {
+          referenced.insert(image[a]);
+        }
+        continue;
+      }
+
+      uint8_t opcode = image[info.address];
+      const OpcodeFacts& f = facts[opcode];
+      if ((int)info.size != 1 + f.operands)
+      {
+        // eg. "bin label": data written with an instruction rule
+        for (uint32_t a = info.address; a < info.address + info.size && a < PROGRAM_SIZE; ++a)
+        {
+          referenced.insert(image[a]);
+        }
+        continue;
+      }
+
+      Instr i;
+      i.address = (int)info.address;
+      i.length = (int)info.size;
+      i.opcode = opcode;
+      i.line = info.line - 1;
+      i.target = f.operands ? image[(i.address + 1) % PROGRAM_SIZE] : -1;
+      at[i.address] = (int)instrs.size();
+      instrs.push_back(i);
+    }
+
+    for (auto& s : assembler.symbols())
+    {
+      if (s.label && s.value >= 0 && s.value < PROGRAM_SIZE)
+        entry[s.value] = true;
+    }
+    for (auto& i : instrs)
+    {
+      OptFlow flow = facts[i.opcode].flow;
+      if (flow == FLOW_JUMP || flow == FLOW_BRANCH || flow == FLOW_CALL)
+        entry[i.target] = true;
+    }
+
+    // scopes, for naming local labels
+    scopes.clear();
+    std::string scope;
+    for (auto& line : lines)
+    {
+      for (auto& name : parseLine(line).names)
+      {
+        if (name[0] != '.')
+          scope = name;
+      }
+      scopes.push_back(scope);
+    }
+
+    findReachable();
+  }
+
+  void findReachable()
+  {
+    reachUnknown = false;
+    positionDependent = false;
+    overflowObserved = false;
+    selfModifying = false;
+
+    std::vector<int> work;
+    work.push_back(0);
+    bool indirect = false;
+    std::set<int> roots;
+
+    while (!work.empty())
+    {
+      int a = work.back();
+      work.pop_back();
+      if (reachable[a])
+        continue;
+      if (!isInstr(a))
+      {
+        reachUnknown = true;
+        continue;
+      }
+      reachable[a] = true;
+
+      const Instr& i = instrs[at[a]];
+      const OpcodeFacts& f = facts[i.opcode];
+      // calls push PC too, but only as the return address for ret
+      if (f.readsPc && f.flow == FLOW_NEXT)
+        positionDependent = true;
+      if (f.flagsRead & FLAG_OVERFLOW)
+        overflowObserved = true;
+      if (f.writes & OPT_PGM)
+        selfModifying = true;
+      if (i.target >= 0)
+        referenced.insert(i.target);
+
+      int next = nextAddress(i) % PROGRAM_SIZE;
+      switch (f.flow)
+      {
+        case FLOW_NEXT:
+          work.push_back(next);
+          break;
+        case FLOW_JUMP:
+          work.push_back(i.target);
+          break;
+        case FLOW_BRANCH:
+        case FLOW_CALL:
+          work.push_back(i.target);
+          work.push_back(next);
+          break;
+        case FLOW_INDIRECT:
+          indirect = true;
+          break;
+        case FLOW_CALL_INDIRECT:
+          indirect = true;
+          work.push_back(next);
+          break;
+        case FLOW_RETURN:
+        case FLOW_HALT:
+          break;
+      }
+
+      // computed jumps can go to any label whose address the program uses
+      if (work.empty() && indirect)
+      {
+        for (auto& s : assembler.symbols())
+        {
+          if (s.label && s.value >= 0 && s.value < PROGRAM_SIZE && referenced.count((int)s.value) && !roots.count((int)s.value))
+          {
+            roots.insert((int)s.value);
+            work.push_back((int)s.value);
+          }
+        }
+      }
+    }
+  }
+
+  // true if the flags at address may be read before they are next written
+  bool flagsLive(int address)
+  {
+    std::set<int> visited;
+    for (int depth = 0; depth < LIVENESS_DEPTH; ++depth)
+    {
+      if (!isInstr(address) || !visited.insert(address).second)
+        return true;
+
+      const Instr& i = instrs[at[address]];
+      const OpcodeFacts& f = facts[i.opcode];
+      if (f.flagsRead)
+        return true;
+      if (f.writesFlags)
+        return false;
+
+      switch (f.flow)
+      {
+        case FLOW_NEXT:
+          address = nextAddress(i);
+          break;
+        case FLOW_JUMP:
+          address = i.target;
+          break;
+        default:
+          return true;
+      }
+    }
+    return true;
+  }
+
+  // a label for address, usable from line. empty if there isn't one
+  std::string labelFor(int address, int line)
+  {
+    const std::string& scope = scopes[line];
+    std::string local;
+    for (auto& s : assembler.symbols())
+    {
+      if (!s.label || s.value != address)
+        continue;
+      size_t dot = s.name.find('.');
+      if (dot == std::string::npos)
+        return s.name;
+      if (s.name.substr(0, dot) == scope && local.empty())
+        local = s.name.substr(dot);
+    }
+    return local;
+  }
+
+  std::string newLabel()
+  {
+    return ".__opt" + std::to_string(labelCounter++);
+  }
+
+
+  // edits
+
+  struct Candidate
+  {
+    OptEdit edit;
+    std::map<int, std::string> replace;   // line index -> new text (may hold several lines, or be empty to remove)
+  };
+
+  std::string statementLine(int line, const std::string& statement)
+  {
+    LineParts parts = parseLine(lines[line]);
+    parts.statement = statement;
+    if (parts.indent.empty() && !statement.empty())
+      parts.indent = parts.labels.empty() ? "\t" : " ";
+    return parts.join();
+  }
+
+  // the line without its statement. empty if nothing else is left
+  std::string removedLine(int line)
+  {
+    LineParts parts = parseLine(lines[line]);
+    parts.statement.clear();
+    if (parts.labels.empty() && trim(parts.comment).empty())
+      return "";
+    return parts.join();
+  }
+
+  // the only statement on a line is this instruction
+  bool ownsLine(const Instr& i)
+  {
+    int count = 0;
+    for (auto& info : assembler.lineMap())
+    {
+      if ((int)info.line - 1 == i.line)
+        ++count;
+    }
+    return count == 1;
+  }
+
+  Candidate makeCandidate(const char* rule, const Instr& i, int cycles, int bytes)
+  {
+    Candidate c;
+    c.edit.rule = rule;
+    c.edit.line = i.line + 1;
+    c.edit.cycles = cycles;
+    c.edit.bytes = bytes;
+    return c;
+  }
+
+  bool tryCandidate(Candidate& c)
+  {
+    std::string key = c.edit.rule + ":" + std::to_string(c.edit.line) + ":";
+    for (auto& r : c.replace)
+    {
+      key += lines[r.first] + "|";
+    }
+    if (blocked.count(key))
+      return false;
+
+    std::vector<std::string> edited;
+    for (size_t n = 0; n < lines.size(); ++n)
+    {
+      auto r = c.replace.find((int)n);
+      if (r == c.replace.end())
+      {
+        edited.push_back(lines[n]);
+        continue;
+      }
+
+      c.edit.before += (c.edit.before.empty() ? "" : "\n") + trim(lines[n]);
+      if (r->second.empty())
+        continue;
+      for (auto& l : splitLines(r->second))
+      {
+        edited.push_back(l);
+        if (!trim(l).empty())
+          c.edit.after += (c.edit.after.empty() ? "" : "\n") + trim(l);
+      }
+    }
+
+    if (!assemble(edited))
+    {
+      blocked.insert(key);
+      return false;
+    }
+
+    lines = edited;
+    edits.push_back(c.edit);
+    return true;
+  }
+
+  // rewrite the instruction's statement
+  bool rewrite(const char* rule, const Instr& i, const std::string& statement, int cycles, int bytes)
+  {
+    Candidate c = makeCandidate(rule, i, cycles, bytes);
+    c.replace[i.line] = statementLine(i.line, statement);
+    return tryCandidate(c);
+  }
+
+  bool remove(const char* rule, const Instr& i, int cycles)
+  {
+    Candidate c = makeCandidate(rule, i, cycles, i.length);
+    c.replace[i.line] = removedLine(i.line);
+    return tryCandidate(c);
+  }
+
+  bool jumpToNext(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    if ((f.flow != FLOW_JUMP && f.flow != FLOW_BRANCH) || i.target != nextAddress(i) || !ownsLine(i))
+      return false;
+    return remove("jump-to-next", i, f.cycles);
+  }
+
+  bool jumpToRet(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    if (f.flow != FLOW_JUMP || !isInstr(i.target) || factsAt(i.target).flow != FLOW_RETURN || !ownsLine(i))
+      return false;
+    return rewrite("jump-to-ret", i, mnemonic(FLOW_RETURN), f.cycles, f.operands);
+  }
+
+  bool threadJump(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    if (f.flow != FLOW_JUMP && f.flow != FLOW_BRANCH && f.flow != FLOW_CALL)
+      return false;
+    if (!isInstr(i.target) || factsAt(i.target).flow != FLOW_JUMP || !ownsLine(i) || !mnemonics.count(i.opcode))
+      return false;
+
+    const Instr& jump = instrs[at[i.target]];
+    if (jump.target == jump.address || jump.target == i.target)
+      return false;
+
+    std::string label = labelFor(jump.target, i.line);
+    if (label.empty())
+      return false;
+    return rewrite("thread-jump", i, mnemonics[i.opcode] + " " + label, factsAt(i.target).cycles, 0);
+  }
+
+  bool invertBranch(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    int next = nextAddress(i);
+    if (f.flow != FLOW_BRANCH || !isInstr(next) || entry[next] || !ownsLine(i))
+      return false;
+
+    const Instr& jump = instrs[at[next]];
+    const OpcodeFacts& jf = facts[jump.opcode];
+    if (jf.flow != FLOW_JUMP || i.target != nextAddress(jump) || !ownsLine(jump))
+      return false;
+
+    std::string label = labelFor(jump.target, i.line);
+    if (label.empty())
+      return false;
+
+    Candidate c = makeCandidate("invert-branch", i, jf.cycles, jump.length);
+    c.replace[i.line] = statementLine(i.line, mnemonic(FLOW_BRANCH, (uint16_t)~f.branchTaken) + " " + label);
+    c.replace[jump.line] = removedLine(jump.line);
+    return tryCandidate(c);
+  }
+
+  // the callee doesn't look at the stack other than through push, pop, call and ret
+  bool usesStackDiscipline(int address)
+  {
+    std::set<int> visited;
+    std::vector<int> work(1, address);
+    while (!work.empty())
+    {
+      int a = work.back();
+      work.pop_back();
+      if (!visited.insert(a).second)
+        continue;
+      if (!isInstr(a))
+        return false;
+
+      const Instr& i = instrs[at[a]];
+      const OpcodeFacts& f = facts[i.opcode];
+      if ((f.reads & OPT_SP) && !(f.writes & OPT_SP))
+        return false;
+
+      switch (f.flow)
+      {
+        case FLOW_NEXT:
+        case FLOW_CALL:
+          work.push_back(nextAddress(i));
+          break;
+        case FLOW_JUMP:
+          work.push_back(i.target);
+          break;
+        case FLOW_BRANCH:
+          work.push_back(i.target);
+          work.push_back(nextAddress(i));
+          break;
+        case FLOW_RETURN:
+        case FLOW_HALT:
+          break;
+        case FLOW_INDIRECT:
+        case FLOW_CALL_INDIRECT:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  bool tailCall(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    int next = nextAddress(i);
+    if (f.flow != FLOW_CALL || !isInstr(next) || factsAt(next).flow != FLOW_RETURN || !ownsLine(i))
+      return false;
+
+    // the callee's ret leaves different overflow flags (it depends on SP)
+    if (overflowObserved || !usesStackDiscipline(i.target))
+      return false;
+
+    std::string label = labelFor(i.target, i.line);
+    if (label.empty())
+      return false;
+
+    std::string jmp = mnemonic(FLOW_JUMP);
+    int saved = f.cycles + factsAt(next).cycles - facts[opcode(jmp)].cycles;
+    return rewrite("tail-call", i, jmp + " " + label, saved, 0);
+  }
+
+  static bool isMove(const OpcodeFacts& f)
+  {
+    static const uint16_t REGS = OPT_RA | OPT_RB | OPT_RC | OPT_RD | OPT_SP;
+    auto single = [](uint16_t bits) { return bits && !(bits & (bits - 1)); };
+    return f.flow == FLOW_NEXT && f.operands == 0 && !f.writesFlags && !f.flagsRead &&
+           single(f.reads) && (f.reads & REGS) && single(f.writes) && (f.writes & REGS);
+  }
+
+  bool duplicateMove(const Instr& i)
+  {
+    int next = nextAddress(i);
+    if (!isInstr(next) || entry[next])
+      return false;
+
+    const Instr& j = instrs[at[next]];
+    const OpcodeFacts& f = facts[i.opcode];
+    const OpcodeFacts& g = facts[j.opcode];
+    if (!ownsLine(j))
+      return false;
+
+    bool redundant = false;
+    if (isMove(f) && isMove(g))
+    {
+      // mov a, b / mov a, b   or   mov a, b / mov b, a
+      redundant = (i.opcode == j.opcode) || (f.reads == g.writes && f.writes == g.reads);
+    }
+    else if (i.opcode == j.opcode && f.flow == FLOW_NEXT && f.operands == 1 && !f.writesFlags && !f.flagsRead &&
+             f.reads == 0 && !(f.writes & (OPT_RAM | OPT_PGM | OPT_LCD)))
+    {
+      // mov a, 5 / mov a, 5 (the same expression, so they stay equal)
+      redundant = parseLine(lines[i.line]).statement == parseLine(lines[j.line]).statement;
+    }
+
+    return redundant && remove("duplicate-mov", j, g.cycles);
+  }
+
+  bool inlineCall(const Instr& i)
+  {
+    const OpcodeFacts& f = facts[i.opcode];
+    int next = nextAddress(i);
+    if (f.flow != FLOW_CALL || maxInlineBytes <= 0 || !ownsLine(i) || flagsLive(next))
+      return false;
+
+    // the body: from the target to the first ret, with every jump inside it
+    int start = i.target;
+    int end = start;
+    std::vector<const Instr*> body;
+    for (;;)
+    {
+      if (!isInstr(end))
+        return false;
+      const Instr& b = instrs[at[end]];
+      const OpcodeFacts& bf = facts[b.opcode];
+      if (!ownsLine(b))
+        return false;
+      if (bf.flow == FLOW_RETURN)
+        break;
+      if ((bf.flow != FLOW_NEXT && bf.flow != FLOW_JUMP && bf.flow != FLOW_BRANCH) ||
+          ((bf.reads | bf.writes) & OPT_SP) || bf.readsPc)
+        return false;
+
+      body.push_back(&b);
+      end = nextAddress(b);
+      if (end - start > maxInlineBytes || end >= PROGRAM_SIZE)
+        return false;
+    }
+    if (start <= i.address && i.address < end)
+      return false;
+
+    // only forward jumps within the body (the ret is the end label)
+    for (auto b : body)
+    {
+      OptFlow flow = facts[b->opcode].flow;
+      if ((flow == FLOW_JUMP || flow == FLOW_BRANCH) && (b->target <= b->address || b->target > end || !mnemonics.count(b->opcode)))
+        return false;
+    }
+
+    // the call leaves the return address in Acc and its flags: the body mustn't
+    // read either before setting them
+    struct Path { int address; bool acc; bool flags; };
+    std::vector<Path> work(1, Path{ start, false, false });
+    std::set<int> seen;
+    while (!work.empty())
+    {
+      Path p = work.back();
+      work.pop_back();
+      if (p.address == end)
+        continue;
+      int key = p.address * 4 + (p.acc ? 2 : 0) + (p.flags ? 1 : 0);
+      if (!seen.insert(key).second)
+        continue;
+
+      const Instr& b = instrs[at[p.address]];
+      const OpcodeFacts& bf = facts[b.opcode];
+      if (((bf.reads & OPT_ACC) && !p.acc) || (bf.flagsRead && !p.flags))
+        return false;
+      p.acc = p.acc || (bf.writes & OPT_ACC);
+      p.flags = p.flags || bf.writesFlags;
+
+      if (bf.flow == FLOW_JUMP || bf.flow == FLOW_BRANCH)
+        work.push_back(Path{ b.target, p.acc, p.flags });
+      if (bf.flow != FLOW_JUMP)
+        work.push_back(Path{ nextAddress(b), p.acc, p.flags });
+    }
+
+    // labels for the jump targets inside the body
+    std::map<int, std::string> labels;
+    for (auto b : body)
+    {
+      OptFlow flow = facts[b->opcode].flow;
+      if ((flow == FLOW_JUMP || flow == FLOW_BRANCH) && !labels.count(b->target))
+        labels[b->target] = newLabel();
+    }
+
+    // the call's line keeps its labels and comment
+    LineParts site = parseLine(lines[i.line]);
+    std::string indent = site.indent.empty() ? "\t" : site.indent;
+    std::vector<std::string> text;
+    if (!site.labels.empty() || !trim(site.comment).empty())
+      text.push_back(site.labels + (site.labels.empty() ? indent + trim(site.comment) : site.comment) + site.eol);
+
+    for (auto b : body)
+    {
+      if (labels.count(b->address))
+        text.push_back(labels[b->address] + ":" + site.eol);
+
+      std::string statement = parseLine(lines[b->line]).statement;
+      OptFlow flow = facts[b->opcode].flow;
+      if (flow == FLOW_JUMP || flow == FLOW_BRANCH)
+        statement = mnemonics[b->opcode] + " " + labels[b->target];
+      text.push_back(indent + statement + site.eol);
+    }
+    if (labels.count(end))
+      text.push_back(labels[end] + ":" + site.eol);
+
+    Candidate c = makeCandidate("inline", i, f.cycles + factsAt(end).cycles, i.length - (end - start));
+    c.replace[i.line] = joinLines(text);
+    return tryCandidate(c);
+  }
+
+  // remove one run of unreachable instructions
+  bool deadCode()
+  {
+    if (reachUnknown || selfModifying)
+      return false;
+
+    for (size_t n = 0; n < instrs.size(); ++n)
+    {
+      if (reachable[instrs[n].address])
+        continue;
+
+      // the run of unreachable instructions starting here
+      size_t last = n;
+      while (last + 1 < instrs.size() && !reachable[instrs[last + 1].address] &&
+             instrs[last + 1].address == nextAddress(instrs[last]))
+      {
+        ++last;
+      }
+
+      // keep it if the program might use its address (eg. as data, or a computed jump)
+      bool used = false;
+      for (size_t k = n; k <= last && !used; ++k)
+      {
+        int address = instrs[k].address;
+        used = (entry[address] || k == n) && referenced.count(address);
+      }
+
+      bool owned = true;
+      for (size_t k = n; k <= last && owned; ++k)
+      {
+        owned = ownsLine(instrs[k]);
+      }
+
+      if (!used && owned)
+      {
+        Candidate c = makeCandidate("dead-code", instrs[n], 0, 0);
+        for (size_t k = n; k <= last; ++k)
+        {
+          c.replace[instrs[k].line] = removedLine(instrs[k].line);
+          c.edit.bytes += instrs[k].length;
+        }
+        if (tryCandidate(c))
+          return true;
+      }
+      n = last;
+    }
+    return false;
+  }
+
+  bool optimizeOnce()
+  {
+    for (auto& i : instrs)
+    {
+      if (!reachable[i.address])
+        continue;
+
+      if (jumpToNext(i) || jumpToRet(i) || threadJump(i) || invertBranch(i) ||
+          tailCall(i) || duplicateMove(i) || inlineCall(i))
+        return true;
+    }
+    return deadCode();
+  }
+
+  bool optimize(const std::string& text)
+  {
+    edits.clear();
+    warnings.clear();
+    errors.clear();
+    blocked.clear();
+    labelCounter = 0;
+    lines = splitLines(text);
+    source = text;
+
+    if (!haveCpuDef || !haveRom)
+    {
+      errors.push_back({ 0, haveCpuDef ? "no rom loaded" : "no cpudef loaded" });
+      return false;
+    }
+
+    if (!assembler.assemble(text))
+    {
+      errors = assembler.errors();
+      return false;
+    }
+    dataAddresses.clear();
+    if (!assemble(lines))
+    {
+      errors.push_back({ 0, "program doesn't fit the program memory" });
+      return false;
+    }
+    for (auto& info : assembler.lineMap())
+    {
+      if (!info.instruction)
+        dataAddresses.push_back(info.address);
+    }
+
+    try
+    {
+      for (int round = 0; round < MAX_ROUNDS; ++round)
+      {
+        analyze();
+        if (positionDependent)
+        {
+          warnings.push_back("the program reads PC as data, so its layout can't change. not optimized");
+          break;
+        }
+        if (!optimizeOnce())
+          break;
+      }
+    }
+    catch (const OptException&)
+    {
+      warnings.push_back("the cpudef is missing a mnemonic the optimizer needs");
+    }
+
+    if (reachUnknown)
+      warnings.push_back("execution reaches bytes that aren't instructions. dead code was kept");
+    else if (selfModifying)
+      warnings.push_back("the program writes to program memory. dead code was kept");
+
+    source = joinLines(lines);
+    assemble(lines);
+    return true;
+  }
+};
+
+
+Optimizer::Optimizer() : m_impl(new Impl())
+{
+}
+
+Optimizer::~Optimizer()
+{
+}
+
+bool Optimizer::setCpuDef(const std::string& cpuDef)
+{
+  m_impl->haveCpuDef = m_impl->assembler.setCpuDef(cpuDef);
+  if (m_impl->haveCpuDef)
+    m_impl->findMnemonics();
+  return m_impl->haveCpuDef;
+}
+
+bool Optimizer::loadRom(const std::string& romHex)
+{
+  std::vector<uint32_t> rom;
+  rom.reserve(ROM_WORDS);
+
+  uint32_t word = 0;
+  int digits = 0;
+  for (char ch : romHex)
+  {
+    if (!std::isxdigit((unsigned char)ch))
+      continue;
+    word = (word << 4) | (uint32_t)(std::isdigit((unsigned char)ch) ? ch - '0' : (std::tolower((unsigned char)ch) - 'a' + 10));
+    if (++digits == 8)
+    {
+      rom.push_back(word);
+      word = 0;
+      digits = 0;
+    }
+  }
+
+  m_impl->haveRom = rom.size() >= (size_t)ROM_WORDS;
+  if (m_impl->haveRom)
+    m_impl->deriveFacts(rom, rom.size() >= (size_t)WIDE_ROM_WORDS ? WIDE_STEP_BITS : STEP_BITS);
+  return m_impl->haveRom;
+}
+
+void Optimizer::setMaxInlineBytes(int bytes)
+{
+  m_impl->maxInlineBytes = bytes;
+}
+
+bool Optimizer::optimize(const std::string& source)
+{
+  return m_impl->optimize(source);
+}
+
+const std::string& Optimizer::source() const
+{
+  return m_impl->source;
+}
+
+const std::vector<OptEdit>& Optimizer::edits() const
+{
+  return m_impl->edits;
+}
+
+const std::vector<std::string>& Optimizer::warnings() const
+{
+  return m_impl->warnings;
+}
+
+const std::vector<AsmError>& Optimizer::errors() const
+{
+  return m_impl->errors;
+}
+
+const Assembler& Optimizer::assembler() const
+{
+  return m_impl->assembler;
+}
+
+const OpcodeFacts& Optimizer::facts(uint8_t opcode) const
+{
+  return m_impl->facts[opcode];
+}
@@ -0,0 +1,123 @@
+/*
+ * Troy's 8-bit computer - Assembler
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Assembler.h"
+
+// peephole and dead code optimizer for assembly programs
+//
+// costs and instruction behaviour are not hard coded: they are read from the
+// microcode rom (clock cycles, registers and flags read and written, how PC
+// is loaded), so the optimizer stays in step with the microcode. the program
+// is assembled, the instruction stream analysed, and the source edited and
+// re-assembled one rewrite at a time, so labels, constants and comments survive.
+//
+// rewrites:
+//   jump-to-next   a jump (or branch) to the following instruction is removed
+//   jump-to-ret    a jump to a ret becomes ret
+//   thread-jump    a jump, branch or call to a jmp goes straight to its target
+//   invert-branch  "jz a / jmp b / a:" becomes "jnz b"
+//   tail-call      "call f / ret" becomes "jmp f"
+//   duplicate-mov  a move repeating (or reversing) the one before it is removed
+//   inline         calls to small leaf subroutines are replaced by their body
+//   dead-code      unreachable instructions are removed (hlt ends the program)
+//
+// programs that read PC as data (eg. mov Rc, PC) depend on their own layout
+// and are left alone.
+
+enum OptReg
+{
+  OPT_RA   = 1 << 0,
+  OPT_RB   = 1 << 1,
+  OPT_RC   = 1 << 2,
+  OPT_RD   = 1 << 3,
+  OPT_SP   = 1 << 4,
+  OPT_ACC  = 1 << 5,
+  OPT_PC   = 1 << 6,
+  OPT_RAM  = 1 << 7,   // data memory
+  OPT_PGM  = 1 << 8,   // program memory (beyond the instruction's own operands)
+  OPT_LCD  = 1 << 9
+};
+
+enum OptFlow
+{
+  FLOW_NEXT,           // falls through to the next instruction
+  FLOW_JUMP,           // PC = operand
+  FLOW_BRANCH,         // PC = operand, depending on the flags
+  FLOW_CALL,           // push the return address, PC = operand
+  FLOW_RETURN,         // PC = popped address
+  FLOW_INDIRECT,       // PC from a register or memory
+  FLOW_CALL_INDIRECT,  // push the return address, PC from a register
+  FLOW_HALT
+};
+
+// what the microcode does for an opcode. everything is the union over all
+// flag combinations
+struct OpcodeFacts
+{
+  int cycles;          // clock cycles, including the two fetch steps (the most for any flags)
+  int operands;        // operand bytes read from the program at PC
+  uint16_t reads;      // OptReg bits read before being written
+  uint16_t writes;     // OptReg bits written
+  uint8_t flagsRead;   // rom flag bits (N = 1, O = 2, C = 4, Z = 8) the behaviour depends on
+  bool writesFlags;    // latches the ALU (every latch sets the flags)
+  bool readsPc;        // copies PC to a register or memory (position dependent)
+  uint16_t branchTaken;// FLOW_BRANCH: flag combinations (bit per ROM flags value) that jump
+  OptFlow flow;
+};
+
+struct OptEdit
+{
+  std::string rule;    // see above
+  int line;            // 1-based line in the source as it was when the edit was made
+  std::string before;  // the edited line(s)
+  std::string after;   // replacement (empty when removed)
+  int cycles;          // clock cycles saved each time the edited code runs
+  int bytes;           // program bytes saved (negative when inlining grows the code)
+};
+
+class Optimizer
+{
+  public:
+    Optimizer();
+    ~Optimizer();
+
+    bool setCpuDef(const std::string& cpuDef);
+
+    // the microcode rom, as written by MicrocodeTools (rom.hex)
+    bool loadRom(const std::string& romHex);
+
+    // largest subroutine body (bytes, excluding ret) to inline. 0 disables inlining
+    void setMaxInlineBytes(int bytes);
+
+    // optimize a source file. returns false (see errors()) if it doesn't assemble
+    bool optimize(const std::string& source);
+
+    const std::string& source() const;
+    const std::vector<OptEdit>& edits() const;
+    const std::vector<std::string>& warnings() const;
+    const std::vector<AsmError>& errors() const;
+
+    // the assembler, holding the results for source()
+    const Assembler& assembler() const;
+
+    const OpcodeFacts& facts(uint8_t opcode) const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
@@ -0,0 +1,16 @@
+#!/bin/sh
+# Linux build of the assembler and optimizer command lines
+
+cd "$(dirname "$0")"
+
+c++ -O2 -std=c++14 -o simasm simasm.cpp Assembler.cpp
+
+# simopt runs programs in the emulator core (SimLib) to check its rewrites
+obj=$(mktemp -d)
+for src in ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+           ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../vrEmuLcd/src/vrEmuLcd.c
+do
+  cc -O2 -c -I ../SimLib -I ../vrEmuLcd/src -o "$obj/$(basename "$src" .c).o" "$src"
+done
+c++ -O2 -std=c++14 -o simopt -I ../SimLib -I ../vrEmuLcd/src simopt.cpp Optimizer.cpp Assembler.cpp "$obj"/*.o
+rm -rf "$obj"
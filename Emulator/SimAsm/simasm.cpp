@@ -0,0 +1,123 @@
+/*
+ * Troy's 8-bit computer - Assembler command line
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simasm [-d troyscpudef.asm] [-o program.hex] [-s symbols.txt] [-l lines.txt] source.asm
+//
+// writes the program as the hex string loadProgram() expects (stdout if no -o).
+// symbols: one "<value> <name>" line per label and constant
+// lines:   one "<address> <size> <line>" line per source line that emits bytes
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Assembler.h"
+
+static bool readFile(const char* filename, std::string& text)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  std::stringstream ss;
+  ss << file.rdbuf();
+  text = ss.str();
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  const char* cpuDefFile = "troyscpudef.asm";
+  const char* outFile = nullptr;
+  const char* symFile = nullptr;
+  const char* lineFile = nullptr;
+  const char* sourceFile = nullptr;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (i + 1 < argc && strcmp(argv[i], "-d") == 0) cpuDefFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) outFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) symFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-l") == 0) lineFile = argv[++i];
+    else if (argv[i][0] != '-' && sourceFile == nullptr) sourceFile = argv[i];
+    else
+    {
+      sourceFile = nullptr;
+      break;
+    }
+  }
+
+  if (sourceFile == nullptr)
+  {
+    fprintf(stderr, "usage: %s [-d troyscpudef.asm] [-o program.hex] [-s symbols.txt] [-l lines.txt] source.asm\n", argv[0]);
+    return 1;
+  }
+
+  std::string cpuDef, source;
+  if (!readFile(cpuDefFile, cpuDef))
+  {
+    fprintf(stderr, "Unable to open cpudef: %s\n", cpuDefFile);
+    return 1;
+  }
+  if (!readFile(sourceFile, source))
+  {
+    fprintf(stderr, "Unable to open source: %s\n", sourceFile);
+    return 1;
+  }
+
+  Assembler assembler;
+  bool ok = assembler.setCpuDef(cpuDef) && assembler.assemble(source);
+  for (auto& error : assembler.errors())
+  {
+    if (error.line > 0)
+      fprintf(stderr, "%s:%d: error: %s\n", sourceFile, error.line, error.message.c_str());
+    else
+      fprintf(stderr, "%s:%d: error: %s\n", cpuDefFile, -error.line, error.message.c_str());
+  }
+  if (!ok)
+    return 1;
+
+  if (outFile)
+  {
+    std::ofstream out(outFile);
+    out << assembler.hex() << "\n";
+  }
+  else
+  {
+    std::cout << assembler.hex() << "\n";
+  }
+
+  if (symFile)
+  {
+    std::ofstream out(symFile);
+    char buf[32];
+    for (auto& sym : assembler.symbols())
+    {
+      snprintf(buf, sizeof(buf), "0x%04llx ", (unsigned long long)sym.value);
+      out << buf << sym.name << "\n";
+    }
+  }
+
+  if (lineFile)
+  {
+    std::ofstream out(lineFile);
+    char buf[48];
+    for (auto& info : assembler.lineMap())
+    {
+      snprintf(buf, sizeof(buf), "0x%04x %u %d\n", info.address, info.size, info.line);
+      out << buf;
+    }
+  }
+
+  return 0;
+}
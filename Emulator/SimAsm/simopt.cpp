@@ -0,0 +1,246 @@
+/*
+ * Troy's 8-bit computer - Assembly optimizer command line
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simopt [-d troyscpudef.asm] [-r rom.hex] [-o optimized.asm] [-i bytes] [-v cycles] source.asm
+//
+//   -i bytes    inline subroutines of up to this many bytes (default 8, 0 = off)
+//   -v cycles   check the result by running both programs in the emulator for
+//               up to this many cycles: Rd outputs, lcd writes and halting must
+//               match (the optimized program may get further in the budget)
+//
+// writes the optimized source (stdout if no -o) and a report of each rewrite
+// to stderr. exits with 2 if the check fails (nothing is written)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Optimizer.h"
+
+extern "C"
+{
+  #include "computer.h"
+}
+
+struct Trace
+{
+  std::vector<SimEvent> events;
+  unsigned long long cycles;
+  unsigned long long instructions;
+  bool halted;
+};
+
+static bool readFile(const char* filename, std::string& text)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  std::stringstream ss;
+  ss << file.rdbuf();
+  text = ss.str();
+  return true;
+}
+
+static void onEvent(const SimEvent* ev, void* userData)
+{
+  ((Trace*)userData)->events.push_back(*ev);
+}
+
+// memory powers up random (see newRam), so both runs start from zeroed memory
+static Trace run(Rom* rom, const std::string& hex, unsigned budget)
+{
+  Trace trace;
+  Computer* c = newComputerWithRom(rom);
+  for (int i = 0; i < 256; ++i)
+  {
+    writeRam(c->pgm, i, 0);
+    writeRam(c->ram, i, 0);
+  }
+
+  // program bytes are the first 512 characters, ram follows (as in cpemu_ui.js)
+  loadProgram(c, hex.substr(0, 512).c_str());
+  if (hex.size() > 512)
+    loadRam(c, hex.substr(512).c_str());
+
+  computerSetFeatures(c, FEATURE_TRACE | FEATURE_COUNTERS);
+  computerEnableEvents(c, EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) | EVENT_MASK(EventLcdData), 0);
+  computerSetEventCallback(c, onEvent, &trace);
+  computerReset(c);
+
+  trace.cycles = computerRun(c, budget);
+  trace.instructions = c->counters.instructions;
+  trace.halted = (c->controlWord & HLT) != 0;
+
+  destroyComputer(c);
+  return trace;
+}
+
+// the optimized program runs faster, so within the same budget it may get
+// further. everything the original did must happen, in the same order
+static bool sameBehaviour(const Trace& original, const Trace& optimized, std::string& why)
+{
+  if (original.halted && !optimized.halted)
+  {
+    why = "the original halts, the optimized program doesn't";
+    return false;
+  }
+  if (optimized.events.size() < original.events.size() || (original.halted && optimized.events.size() != original.events.size()))
+  {
+    why = "different number of outputs";
+    return false;
+  }
+  for (size_t i = 0; i < original.events.size(); ++i)
+  {
+    const SimEvent& a = original.events[i];
+    const SimEvent& b = optimized.events[i];
+    if (a.type != b.type || a.value != b.value)
+    {
+      char buf[96];
+      snprintf(buf, sizeof(buf), "output %u differs: type %d value %d, now type %d value %d",
+               (unsigned)i, a.type, a.value, b.type, b.value);
+      why = buf;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  const char* cpuDefFile = "troyscpudef.asm";
+  const char* romFile = "rom.hex";
+  const char* outFile = nullptr;
+  const char* sourceFile = nullptr;
+  int inlineBytes = 8;
+  unsigned verifyCycles = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (i + 1 < argc && strcmp(argv[i], "-d") == 0) cpuDefFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-r") == 0) romFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) outFile = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-i") == 0) inlineBytes = atoi(argv[++i]);
+    else if (i + 1 < argc && strcmp(argv[i], "-v") == 0) verifyCycles = (unsigned)strtoul(argv[++i], nullptr, 0);
+    else if (argv[i][0] != '-' && sourceFile == nullptr) sourceFile = argv[i];
+    else
+    {
+      sourceFile = nullptr;
+      break;
+    }
+  }
+
+  if (sourceFile == nullptr)
+  {
+    fprintf(stderr, "usage: %s [-d troyscpudef.asm] [-r rom.hex] [-o optimized.asm] [-i bytes] [-v cycles] source.asm\n", argv[0]);
+    return 1;
+  }
+
+  std::string cpuDef, romHex, source;
+  if (!readFile(cpuDefFile, cpuDef))
+  {
+    fprintf(stderr, "Unable to open cpudef: %s\n", cpuDefFile);
+    return 1;
+  }
+  if (!readFile(romFile, romHex))
+  {
+    fprintf(stderr, "Unable to open rom: %s\n", romFile);
+    return 1;
+  }
+  if (!readFile(sourceFile, source))
+  {
+    fprintf(stderr, "Unable to open source: %s\n", sourceFile);
+    return 1;
+  }
+
+  Optimizer optimizer;
+  if (!optimizer.setCpuDef(cpuDef))
+  {
+    fprintf(stderr, "Unable to parse cpudef: %s\n", cpuDefFile);
+    return 1;
+  }
+  if (!optimizer.loadRom(romHex))
+  {
+    fprintf(stderr, "Not a microcode rom: %s\n", romFile);
+    return 1;
+  }
+  optimizer.setMaxInlineBytes(inlineBytes);
+
+  Assembler original;
+  original.setCpuDef(cpuDef);
+  bool assembled = original.assemble(source);
+  bool ok = assembled && optimizer.optimize(source);
+  for (auto& error : assembled ? optimizer.errors() : original.errors())
+  {
+    if (error.line > 0)
+      fprintf(stderr, "%s:%d: error: %s\n", sourceFile, error.line, error.message.c_str());
+    else
+      fprintf(stderr, "%s:%d: error: %s\n", cpuDefFile, -error.line, error.message.c_str());
+  }
+  if (!ok)
+    return 1;
+
+  for (auto& warning : optimizer.warnings())
+  {
+    fprintf(stderr, "%s: warning: %s\n", sourceFile, warning.c_str());
+  }
+
+  int bytes = 0;
+  for (auto& edit : optimizer.edits())
+  {
+    std::string before = edit.before, after = edit.after.empty() ? "(removed)" : edit.after;
+    for (auto& ch : before) if (ch == '\n') ch = '/';
+    for (auto& ch : after) if (ch == '\n') ch = '/';
+    fprintf(stderr, "%s:%d: %s: %s -> %s (%d cycles, %d bytes)\n", sourceFile, edit.line, edit.rule.c_str(),
+            before.c_str(), after.c_str(), edit.cycles, edit.bytes);
+    bytes += edit.bytes;
+  }
+  fprintf(stderr, "%u rewrites, %d bytes saved\n", (unsigned)optimizer.edits().size(), bytes);
+
+  if (verifyCycles)
+  {
+    Rom* rom = newRomFromFile(romFile);
+    Trace before = run(rom, original.hex(), verifyCycles);
+    Trace after = run(rom, optimizer.assembler().hex(), verifyCycles);
+    destroyRom(rom);
+
+    std::string why;
+    if (!sameBehaviour(before, after, why))
+    {
+      fprintf(stderr, "check failed: %s\n", why.c_str());
+      return 2;
+    }
+
+    fprintf(stderr, "check passed: %u outputs, %s\n", (unsigned)before.events.size(), before.halted ? "halted" : "budget reached");
+    if (before.halted)
+    {
+      fprintf(stderr, "  cycles       %llu -> %llu (%+.1f%%)\n", before.cycles, after.cycles,
+              (after.cycles - (double)before.cycles) * 100.0 / before.cycles);
+      fprintf(stderr, "  instructions %llu -> %llu\n", before.instructions, after.instructions);
+    }
+  }
+
+  if (outFile)
+  {
+    std::ofstream out(outFile, std::ios::binary);
+    out << optimizer.source();
+  }
+  else
+  {
+    std::cout << optimizer.source();
+  }
+
+  return 0;
+}
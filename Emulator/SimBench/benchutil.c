@@ -0,0 +1,72 @@
+/*
+ * Troy's 8-bit computer - Emulator tools
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "benchutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+double nowNs()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+	if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (double)now.QuadPart * 1e9 / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+#endif
+}
+
+int readHex(const char* filename, char* hex, int size)
+{
+	FILE* f = fopen(filename, "r");
+	if (f == NULL)
+		return -1;
+
+	int len = 0;
+	int ch;
+	while ((ch = fgetc(f)) != EOF && len < size - 1)
+	{
+		if (ch != '\n' && ch != '\r' && ch != ' ' && ch != '\t')
+			hex[len++] = (char)ch;
+	}
+	hex[len] = '\0';
+	fclose(f);
+	return len;
+}
+
+void loadHex(Computer* c, const char* hex)
+{
+	char program[513];
+	snprintf(program, sizeof(program), "%.512s", hex);
+	loadProgram(c, program);
+	if (strlen(hex) > 512)
+		loadRam(c, hex + 512);
+}
+
+void clearMemory(Computer* c)
+{
+	for (int i = 0; i < 256; ++i)
+	{
+		writeRam(c->pgm, i, 0);
+		writeRam(c->ram, i, 0);
+	}
+}
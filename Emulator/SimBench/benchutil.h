@@ -0,0 +1,33 @@
+/*
+ * Troy's 8-bit computer - Emulator tools
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMBENCH_BENCHUTIL_H_
+#define _SIMBENCH_BENCHUTIL_H_
+
+#include "computer.h"
+
+// helpers shared by the SimBench tools and SimCli
+
+// monotonic clock in nanoseconds
+double nowNs();
+
+// a hex file with its whitespace removed. returns the number of characters
+// read, or -1 if the file can't be opened
+int readHex(const char* filename, char* hex, int size);
+
+// program bytes are the first 512 characters, RAM follows (as in cpemu_ui.js)
+void loadHex(Computer* c, const char* hex);
+
+// zero program memory and RAM. memory powers up with random contents (see
+// newRam), so the benchmarks clear it to keep cycle counts repeatable
+void clearMemory(Computer* c);
+
+#endif
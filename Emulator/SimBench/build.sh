@@ -0,0 +1,22 @@
+#!/bin/sh
+# Linux build of the SimLib micro benchmarks
+# run from a directory containing rom.hex, or pass -r path/to/rom.hex
+
+cd "$(dirname "$0")"
+
+cc -O2 -o simbench -I ../SimLib -I ../vrEmuLcd/src -D SIMBENCH_WRAP_MALLOC=1 \
+  simbench.c benchutil.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+  ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../SimLib/disasm.c ../vrEmuLcd/src/vrEmuLcd.c \
+  -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+
+cc -O2 -o simcorpus -I ../SimLib -I ../vrEmuLcd/src \
+  simcorpus.c benchutil.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+  ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../vrEmuLcd/src/vrEmuLcd.c -lm
+
+cc -O2 -o simab -I ../SimLib -I ../vrEmuLcd/src \
+  simab.c benchutil.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+  ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../vrEmuLcd/src/vrEmuLcd.c -lm
+
+cc -O2 -o simfuzz -I ../SimLib -I ../vrEmuLcd/src \
+  simfuzz.c benchutil.c ../SimLib/isa.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+  ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../SimLib/disasm.c ../vrEmuLcd/src/vrEmuLcd.c
@@ -0,0 +1,71 @@
+// Troy's 8-bit computer - benchmark corpus assembler
+//
+// Copyright (c) 2020 Troy Schrapel
+//
+// This code is licensed under the MIT license
+//
+// https://github.com/visrealm/vrcpu
+//
+// usage: node assemble.js
+//
+// assembles Programs/*.asm and Web/asm/examples/*.asm with the web assembler
+// (Web/asm/customasm.gc.wasm + troyscpudef.asm, exactly as Web/asm/main.js
+// does) into <name>.hex files in this directory, and the shift unit programs
+// in Web/asm/examples/shift/*.asm (as shift-<name>.hex) with the rules of
+// troyscpudef_shift.asm added to the #cpudef block.
+// programs that fail to assemble are reported and skipped.
+
+const fs = require("fs")
+const path = require("path")
+
+const root = path.join(__dirname, "..", "..", "..")
+const asmDir = path.join(root, "Web", "asm")
+
+const wasm = new WebAssembly.Instance(new WebAssembly.Module(fs.readFileSync(path.join(asmDir, "customasm.gc.wasm"))), {})
+const cpudef = fs.readFileSync(path.join(asmDir, "troyscpudef.asm"), "utf8")
+const shiftRules = fs.readFileSync(path.join(asmDir, "troyscpudef_shift.asm"), "utf8")
+
+// troyscpudef.asm with the shift unit rules before the block's closing brace
+const end = cpudef.lastIndexOf("}")
+const shiftCpudef = cpudef.slice(0, end) + shiftRules + "\n" + cpudef.slice(end)
+
+function makeRustString(str) {
+  let bytes = Buffer.from(str, "utf8")
+  let ptr = wasm.exports.wasm_string_new(bytes.length)
+  for (let i = 0; i < bytes.length; i++)
+    wasm.exports.wasm_string_set_byte(ptr, i, bytes[i])
+  return ptr
+}
+
+function readRustString(ptr) {
+  let len = wasm.exports.wasm_string_get_len(ptr)
+  let bytes = []
+  for (let i = 0; i < len; i++)
+    bytes.push(wasm.exports.wasm_string_get_byte(ptr, i))
+  return Buffer.from(bytes).toString("utf8")
+}
+
+function assemble(def, source) {
+  let asmPtr = makeRustString(def + "\n" + source)
+  let outputPtr = wasm.exports.wasm_assemble(4, asmPtr) // 4 = hex string, as emulate() uses
+  let output = readRustString(outputPtr).trim()
+  wasm.exports.wasm_string_drop(asmPtr)
+  wasm.exports.wasm_string_drop(outputPtr)
+  return /^[0-9a-fA-F]*$/.test(output) ? output : null
+}
+
+function hexName(prefix, file) {
+  return prefix + path.basename(file, ".asm").toLowerCase().replace(/[^a-z0-9]+/g, "-").replace(/^-|-$/g, "") + ".hex"
+}
+
+for (let [dir, prefix, def] of [[path.join(root, "Programs"), "programs-", cpudef], [path.join(asmDir, "examples"), "", cpudef], [path.join(asmDir, "examples", "shift"), "shift-", shiftCpudef]]) {
+  for (let file of fs.readdirSync(dir).filter(f => f.endsWith(".asm")).sort()) {
+    let hex = assemble(def, fs.readFileSync(path.join(dir, file), "utf8"))
+    if (hex == null) {
+      console.log("skipped (does not assemble): " + path.join(path.basename(dir), file))
+      continue
+    }
+    fs.writeFileSync(path.join(__dirname, hexName(prefix, file)), hex + "\n")
+    console.log(hexName(prefix, file))
+  }
+}
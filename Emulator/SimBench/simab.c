@@ -0,0 +1,425 @@
+/*
+ * Troy's 8-bit computer - Emulator microcode A/B harness
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simab [-d corpus] [-s cycles] [-p] [-o results.json] base.hex variant.hex [variant.hex ...]
+//
+// runs every program in corpus/manifest.txt under each microcode rom and
+// compares each variant against the first (base) rom:
+//
+//   cycles      halting programs: cycles to halt. others run to their budget
+//               and are compared by the cycle of the last output both runs
+//               produced (same work, different speed). that needs at least
+//               AB_MIN_OUTPUTS common outputs, the last at least
+//               AB_MIN_CYCLES into the base run, or the program shows "-"
+//               and is left out of the geometric mean
+//   divergence  outputs (Rd, lcd and program memory writes) that differ, a
+//               different halting outcome, or for halting programs any
+//               difference in the final registers and memory
+//
+// each program runs on one computer. the roms are hot-swapped into it with
+// computerSwapRom() between runs. with -s, each variant is also swapped into
+// a program already running on the base rom after that many cycles, and the
+// outputs must still match the base run. with -p, the variants run on the
+// pipelined machine (FEATURE_PIPELINE) and the base on the standard one, so
+// `simab -p rom.hex rom.hex` measures the pipeline on its own.
+//
+// writes one json object per program (stdout if no -o), a table to stderr,
+// and exits with 2 if any variant diverged
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "computer.h"
+#include "benchutil.h"
+
+#define MAX_ROMS 8
+#define MAX_HEX (512 * 2 + 2)
+#define AB_MIN_OUTPUTS 16
+#define AB_MIN_CYCLES 10000
+#define TRACE_EVENTS (EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) | EVENT_MASK(EventLcdData) | EVENT_MASK(EventPgmWrite))
+
+typedef struct
+{
+	SimEvent* events;
+	int count;
+	int capacity;
+} Trace;
+
+typedef struct
+{
+	unsigned long long cycles;
+	unsigned long long instructions;
+	int halted;
+	byte regs[8];   // Ra, Rb, Rc, Rd, SP, PC, Acc, flags
+	byte ram[256];
+	byte pgm[256];
+	Trace trace;
+} Run;
+
+static const char* regNames[8] = { "Ra", "Rb", "Rc", "Rd", "SP", "PC", "Acc", "flags" };
+
+
+static void onEvent(const SimEvent* ev, void* userData)
+{
+	Trace* t = (Trace*)userData;
+	if (t->count == t->capacity)
+	{
+		t->capacity = t->capacity ? t->capacity * 2 : 256;
+		t->events = (SimEvent*)realloc(t->events, t->capacity * sizeof(SimEvent));
+	}
+	t->events[t->count++] = *ev;
+}
+
+// the state of a new computer, so every run starts the same whatever ran
+// before it. memory is cleared rather than left random (see newRam)
+static void powerOn(Computer* c, const char* hex)
+{
+	Register* regs[] = { c->ra, c->rb, c->rc, c->rd, c->sp, c->ir, c->mar, c->pc->r, c->tc->r, c->alu->out };
+	for (int i = 0; i < (int)(sizeof(regs) / sizeof(regs[0])); ++i)
+	{
+		regs[i]->value = 0xff;
+	}
+	c->alu->flags = 0;
+	c->tick = 0;
+
+	clearMemory(c);
+	loadHex(c, hex);
+
+	computerReset(c);
+	computerResetCounters(c);
+}
+
+// cycles as computerRun counts them, like simcorpus and simcli: the cycle
+// that decodes hlt is included (counters.cycles stops short of it)
+static void finishRun(Computer* c, unsigned cycles, Run* r)
+{
+	r->cycles = cycles;
+	r->instructions = c->counters.instructions;
+	r->halted = (c->controlWord & HLT) ? 1 : 0;
+
+	byte regs[8] = { c->ra->value, c->rb->value, c->rc->value, c->rd->value, c->sp->value,
+		c->pc->r->value, c->alu->out->value, (byte)c->alu->flags };
+	memcpy(r->regs, regs, sizeof(regs));
+	for (int i = 0; i < 256; ++i)
+	{
+		r->ram[i] = readRam(c->ram, i);
+		r->pgm[i] = readRam(c->pgm, i);
+	}
+}
+
+// run the program on rom. if swapAt is non-zero, start on swapFrom and swap
+// rom in after that many cycles
+static void runProgram(Computer* c, const char* hex, unsigned budget, Rom* rom, Rom* swapFrom, unsigned swapAt, Run* r)
+{
+	memset(r, 0, sizeof(*r));
+	computerSetEventCallback(c, onEvent, &r->trace);
+
+	computerSwapRom(c, swapAt ? swapFrom : rom, 0);
+	powerOn(c, hex);
+
+	unsigned ran = 0;
+	if (swapAt)
+	{
+		ran = computerRun(c, swapAt < budget ? swapAt : budget);
+		computerSwapRom(c, rom, 0);
+	}
+	if (ran < budget && !(c->controlWord & HLT))
+		ran += computerRun(c, budget - ran);
+
+	finishRun(c, ran, r);
+	computerSetEventCallback(c, NULL, NULL);
+}
+
+// the last output both runs reached: its cycle in each. 0 if there are too
+// few common outputs, or too early on, to say anything about speed (eg. a
+// single clra output before the program loops without output)
+static int commonOutput(const Run* a, const Run* b, unsigned* cycleA, unsigned* cycleB)
+{
+	int common = a->trace.count < b->trace.count ? a->trace.count : b->trace.count;
+	if (common < AB_MIN_OUTPUTS || a->trace.events[common - 1].tick / 2 < AB_MIN_CYCLES)
+		return 0;
+
+	*cycleA = a->trace.events[common - 1].tick / 2;
+	*cycleB = b->trace.events[common - 1].tick / 2;
+	return common;
+}
+
+// empty if the runs agree, otherwise why not
+static void compareRuns(const Run* base, const Run* run, char* why, int size)
+{
+	why[0] = '\0';
+
+	int common = base->trace.count < run->trace.count ? base->trace.count : run->trace.count;
+	for (int i = 0; i < common; ++i)
+	{
+		const SimEvent* a = &base->trace.events[i];
+		const SimEvent* b = &run->trace.events[i];
+		if (a->type != b->type || a->value != b->value || (a->type == EventPgmWrite && a->address != b->address))
+		{
+			snprintf(why, size, "output %d differs: type %d value %d, now type %d value %d", i, a->type, a->value, b->type, b->value);
+			return;
+		}
+	}
+
+	if (base->halted != run->halted)
+	{
+		// a faster variant may halt within a budget the base didn't
+		if (base->halted || run->trace.count < base->trace.count)
+		{
+			snprintf(why, size, base->halted ? "no longer halts" : "halts early");
+			return;
+		}
+	}
+	if (!base->halted || !run->halted)
+		return;
+
+	if (base->trace.count != run->trace.count)
+	{
+		snprintf(why, size, "%d outputs, now %d", base->trace.count, run->trace.count);
+		return;
+	}
+
+	int len = snprintf(why, size, "final state differs:");
+	int differs = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		if (base->regs[i] != run->regs[i])
+		{
+			len += snprintf(why + len, size > len ? size - len : 0, " %s %02x->%02x", regNames[i], base->regs[i], run->regs[i]);
+			differs = 1;
+		}
+	}
+	if (memcmp(base->ram, run->ram, sizeof(base->ram)) != 0)
+	{
+		len += snprintf(why + len, size > len ? size - len : 0, " ram");
+		differs = 1;
+	}
+	if (memcmp(base->pgm, run->pgm, sizeof(base->pgm)) != 0)
+	{
+		len += snprintf(why + len, size > len ? size - len : 0, " pgm");
+		differs = 1;
+	}
+	if (!differs)
+		why[0] = '\0';
+}
+
+static double percent(double before, double after)
+{
+	return before > 0 ? (after - before) * 100.0 / before : 0.0;
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* corpusDir = "corpus";
+	const char* outFile = NULL;
+	const char* romFiles[MAX_ROMS];
+	int numRoms = 0;
+	unsigned swapAt = 0;
+	int pipeline = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && strcmp(argv[i], "-d") == 0) corpusDir = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) outFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) swapAt = (unsigned)strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-p") == 0) pipeline = 1;
+		else if (argv[i][0] != '-' && numRoms < MAX_ROMS) romFiles[numRoms++] = argv[i];
+		else
+		{
+			numRoms = 0;
+			break;
+		}
+	}
+
+	if (numRoms < 2)
+	{
+		fprintf(stderr, "usage: %s [-d corpus] [-s cycles] [-p] [-o results.json] base.hex variant.hex [variant.hex ...]\n", argv[0]);
+		return 1;
+	}
+
+	char path[512];
+	snprintf(path, sizeof(path), "%s/manifest.txt", corpusDir);
+	FILE* manifest = fopen(path, "r");
+	if (manifest == NULL)
+	{
+		fprintf(stderr, "Unable to open manifest: %s\n", path);
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (outFile && (out = fopen(outFile, "w")) == NULL)
+	{
+		fprintf(stderr, "Unable to write: %s\n", outFile);
+		return 1;
+	}
+
+	Rom* roms[MAX_ROMS];
+	for (int v = 0; v < numRoms; ++v)
+	{
+		roms[v] = newRomFromFile(romFiles[v]);
+	}
+
+	Computer* c = newComputerWithRom(roms[0]);
+	computerEnableEvents(c, TRACE_EVENTS, 0);
+
+	int diverged = 0;
+	int programs = 0;
+	double logRatio[MAX_ROMS] = { 0 };
+	int measured[MAX_ROMS] = { 0 };
+
+	fprintf(stderr, "%-28s %12s", "program", "base cycles");
+	for (int v = 1; v < numRoms; ++v)
+	{
+		fprintf(stderr, " %10s%d", "variant ", v);
+	}
+	fprintf(stderr, "\n");
+
+	// manifest lines: <file.hex> <cycle budget>   (# starts a comment)
+	char line[256];
+	while (fgets(line, sizeof(line), manifest))
+	{
+		char file[128];
+		unsigned budget = 0;
+		if (line[0] == '#' || sscanf(line, "%127s %u", file, &budget) != 2)
+			continue;
+
+		char hex[MAX_HEX];
+		snprintf(path, sizeof(path), "%s/%s", corpusDir, file);
+		if (readHex(path, hex, sizeof(hex)) <= 0)
+		{
+			fprintf(stderr, "Unable to read program: %s\n", path);
+			continue;
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%.*s", (int)(strcspn(file, ".")), file);
+		++programs;
+
+		Run base;
+		computerSetFeatures(c, FEATURE_TRACE | FEATURE_COUNTERS);
+		runProgram(c, hex, budget, roms[0], NULL, 0, &base);
+
+		fprintf(out, "{\"name\":\"%s\",\"budget\":%u,\"variants\":[", name, budget);
+		fprintf(stderr, "%-28s %12llu", name, base.cycles);
+
+		char reasons[MAX_ROMS][540];
+		for (int v = 0; v < numRoms; ++v)
+		{
+			Run run;
+			reasons[v][0] = '\0';
+			if (v == 0)
+				run = base;
+			else
+			{
+				computerSetFeatures(c, FEATURE_TRACE | FEATURE_COUNTERS | (pipeline ? FEATURE_PIPELINE : 0));
+				runProgram(c, hex, budget, roms[v], NULL, 0, &run);
+			}
+
+			char why[256] = "";
+			char live[256] = "";
+			if (v > 0)
+			{
+				compareRuns(&base, &run, why, sizeof(why));
+
+				if (swapAt)
+				{
+					Run swapped;
+					runProgram(c, hex, budget, roms[v], roms[0], swapAt, &swapped);
+					compareRuns(&base, &swapped, live, sizeof(live));
+					free(swapped.trace.events);
+				}
+			}
+
+			// same work: the whole program if both halt, otherwise up to the
+			// last output both produced
+			unsigned long long before = base.cycles, after = run.cycles;
+			int comparable = base.halted && run.halted;
+			if (!comparable)
+			{
+				unsigned a = 0, b = 0;
+				comparable = commonOutput(&base, &run, &a, &b) > 0;
+				before = a;
+				after = b;
+			}
+
+			fprintf(out, "%s{\"rom\":\"%s\",\"cycles\":%llu,\"instructions\":%llu,\"halted\":%s,\"outputs\":%d,",
+				v ? "," : "", romFiles[v], run.cycles, run.instructions, run.halted ? "true" : "false", run.trace.count);
+			if (v > 0 && comparable)
+				fprintf(out, "\"compared_cycles\":[%llu,%llu],\"delta_pct\":%.3f,", before, after, percent((double)before, (double)after));
+			else if (v > 0)
+				fprintf(out, "\"compared_cycles\":null,\"delta_pct\":null,");
+			fprintf(out, why[0] ? "\"diverged\":\"%s\"" : "\"diverged\":null", why);
+			if (v > 0 && swapAt)
+				fprintf(out, live[0] ? ",\"live_swap\":\"%s\"" : ",\"live_swap\":null", live);
+			fprintf(out, "}");
+
+			if (v > 0)
+			{
+				if (why[0] || live[0])
+				{
+					fprintf(stderr, " %11s", "DIVERGED");
+					snprintf(reasons[v], sizeof(reasons[v]), "%s%s%s", why, why[0] && live[0] ? "; " : "",
+						live[0] ? "after a live swap: " : "");
+					if (live[0])
+						strncat(reasons[v], live, sizeof(reasons[v]) - strlen(reasons[v]) - 1);
+					++diverged;
+				}
+				else if (comparable && before > 0)
+				{
+					fprintf(stderr, " %+10.2f%%", percent((double)before, (double)after));
+					logRatio[v] += log((double)after / (double)before);
+					++measured[v];
+				}
+				else
+				{
+					fprintf(stderr, " %11s", "-");
+				}
+			}
+
+			if (v > 0)
+				free(run.trace.events);
+		}
+		fprintf(out, "]}\n");
+		fprintf(stderr, "\n");
+		for (int v = 1; v < numRoms; ++v)
+		{
+			if (reasons[v][0])
+				fprintf(stderr, "  variant %d: %s\n", v, reasons[v]);
+		}
+		free(base.trace.events);
+	}
+	fclose(manifest);
+
+	// geometric mean of the cycle ratios over the programs that could be compared
+	fprintf(stderr, "%-28s %12s", "geometric mean", "");
+	for (int v = 1; v < numRoms; ++v)
+	{
+		if (measured[v])
+			fprintf(stderr, " %+10.2f%%", (exp(logRatio[v] / measured[v]) - 1.0) * 100.0);
+		else
+			fprintf(stderr, " %11s", "-");
+	}
+	fprintf(stderr, "\n%d programs, %d divergent runs\n", programs, diverged);
+
+	// the computer shares roms[0]; nothing it holds is owned
+	destroyComputer(c);
+	for (int v = 0; v < numRoms; ++v)
+	{
+		destroyRom(roms[v]);
+	}
+	if (out != stdout)
+		fclose(out);
+
+	return diverged ? 2 : 0;
+}
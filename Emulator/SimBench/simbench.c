@@ -0,0 +1,516 @@
+/*
+ * Troy's 8-bit computer - Emulator micro benchmarks
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simbench [-r rom.hex] [-f filter] [-t seconds] [-o results.json] [-c baseline.json]
+//
+// writes one json object per benchmark per line (sorted, stable field order)
+// so two runs can be diffed directly, or compared with -c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <intrin.h>
+  #define HAVE_TSC 1
+#else
+  #if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define HAVE_TSC 1
+  #endif
+#endif
+
+#include "computer.h"
+#include "disasm.h"
+#include "benchutil.h"
+
+// a program that never halts (triangular numbers, looping)
+#define BENCH_PROGRAM "37c1cf3f012f00"
+
+// allocation counting. build.sh links with -Wl,--wrap=malloc etc.
+#if SIMBENCH_WRAP_MALLOC
+static unsigned long long allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) { ++allocations; return __real_malloc(size); }
+void* __wrap_calloc(size_t n, size_t size) { ++allocations; return __real_calloc(n, size); }
+void* __wrap_realloc(void* ptr, size_t size) { ++allocations; return __real_realloc(ptr, size); }
+
+#define ALLOCATIONS() ((long long)allocations)
+#else
+#define ALLOCATIONS() (-1LL)
+#endif
+
+
+// cpu timestamp counter (reference cycles). falls back to ns where unavailable
+static unsigned long long stamp()
+{
+#if HAVE_TSC
+	return __rdtsc();
+#else
+	return (unsigned long long)nowNs();
+#endif
+}
+
+static double stampsPerNs = 1.0;
+static double stampOverhead = 0.0;
+
+static void calibrateStamps()
+{
+	double t0 = nowNs();
+	unsigned long long s0 = stamp();
+	while (nowNs() - t0 < 50e6);
+	stampsPerNs = (double)(stamp() - s0) / (nowNs() - t0);
+
+	unsigned long long total = 0;
+	for (int i = 0; i < 100000; ++i)
+	{
+		unsigned long long a = stamp();
+		total += stamp() - a;
+	}
+	stampOverhead = total / 100000.0;
+}
+
+
+typedef struct
+{
+	char name[64];
+	unsigned long long ops;
+	double nsPerOp;
+	double cyclesPerOp;
+	double allocsPerOp; // < 0 if not counted
+} Result;
+
+#define MAX_RESULTS 64
+static Result results[MAX_RESULTS];
+static int numResults = 0;
+
+static const char* filter = NULL;
+static double targetNs = 0.25e9;
+
+// a benchmark runs its operation iters times. if it measures its own
+// time (eg. only part of each iteration), it sets *phaseStamps
+typedef void (*BenchFn)(void* ctx, unsigned long long iters, double* phaseStamps);
+
+static void runBench(const char* name, BenchFn fn, void* ctx)
+{
+	if (filter && strstr(name, filter) == NULL)
+		return;
+
+	// calibrate: grow the iteration count until a run takes a measurable time
+	unsigned long long iters = 1;
+	for (;;)
+	{
+		double phase = -1.0;
+		double t0 = nowNs();
+		fn(ctx, iters, &phase);
+		double elapsed = nowNs() - t0;
+		if (elapsed > targetNs / 20 || iters > (1ULL << 40))
+		{
+			iters = (unsigned long long)(iters * (targetNs / (elapsed > 1 ? elapsed : 1)));
+			if (iters == 0) iters = 1;
+			break;
+		}
+		iters *= 4;
+	}
+
+	double phase = -1.0;
+	long long a0 = ALLOCATIONS();
+	unsigned long long s0 = stamp();
+	double t0 = nowNs();
+	fn(ctx, iters, &phase);
+	double elapsed = nowNs() - t0;
+	unsigned long long stamps = stamp() - s0;
+	long long a1 = ALLOCATIONS();
+
+	Result* r = &results[numResults++];
+	snprintf(r->name, sizeof(r->name), "%s", name);
+	r->ops = iters;
+	if (phase >= 0)
+	{
+		r->cyclesPerOp = phase / iters;
+		r->nsPerOp = r->cyclesPerOp / stampsPerNs;
+	}
+	else
+	{
+		r->nsPerOp = elapsed / iters;
+		r->cyclesPerOp = (double)stamps / iters;
+	}
+	r->allocsPerOp = (a0 < 0) ? -1.0 : (double)(a1 - a0) / iters;
+
+	fprintf(stderr, "%-32s %12.2f ns/op\n", r->name, r->nsPerOp);
+}
+
+
+/* computer */
+
+static void benchTickPhase(Computer* c, unsigned long long iters, double* phaseStamps, int phase)
+{
+	double total = 0;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		unsigned long long s0 = stamp();
+		computerTick(c, 0);
+		unsigned long long s1 = stamp();
+		computerTick(c, 1);
+		unsigned long long s2 = stamp();
+
+		total += (phase ? (s2 - s1) : (s1 - s0)) - stampOverhead;
+	}
+	*phaseStamps = total > 0 ? total : 0;
+}
+
+static void benchTickLow(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	benchTickPhase((Computer*)ctx, iters, phaseStamps, 0);
+}
+
+static void benchTickHigh(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	benchTickPhase((Computer*)ctx, iters, phaseStamps, 1);
+}
+
+static void benchTickCycle(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Computer* c = (Computer*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		computerTick(c, 0);
+		computerTick(c, 1);
+	}
+}
+
+static void benchRun(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Computer* c = (Computer*)ctx;
+	while (iters)
+	{
+		unsigned batch = iters > 0x40000000 ? 0x40000000 : (unsigned)iters;
+		computerRun(c, batch);
+		iters -= batch;
+	}
+}
+
+static void benchNewComputer(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Rom* rom = (Rom*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		destroyComputer(newComputerWithRom(rom));
+	}
+}
+
+static const char* romFile = "rom.hex";
+
+static void benchRomLoad(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)ctx;
+	(void)phaseStamps;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		destroyRom(newRomFromFile(romFile));
+	}
+}
+
+typedef struct
+{
+	Computer* c;
+	char hex[513];
+	byte bytes[256];
+} LoadCtx;
+
+static void benchLoadProgram(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	LoadCtx* l = (LoadCtx*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		loadProgram(l->c, l->hex);
+	}
+}
+
+static void benchLoadProgramBytes(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	LoadCtx* l = (LoadCtx*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		loadProgramBytes(l->c, l->bytes, sizeof(l->bytes));
+	}
+}
+
+static void benchDisassemble(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	const byte* pgm = (const byte*)ctx;
+	char text[DISASM_TEXT_SIZE];
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		disassemble(pgm, (byte)i, text);
+	}
+}
+
+static void benchDisassembleProgram(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	const byte* pgm = (const byte*)ctx;
+	DisasmLine lines[256];
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		disassembleProgram(pgm, lines, 256);
+	}
+}
+
+
+/* components */
+
+static void benchAlu(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	ALU* a = (ALU*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		a->out->bus->value = (byte)i;
+		a->carryIn = (int)(i >> 8) & 1;
+		aluTick(a);
+	}
+}
+
+static void benchRam(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Ram* r = (Ram*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		r->mar->value = (byte)i;
+		ramTick(r);
+	}
+}
+
+static void benchRegister(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Register* r = (Register*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		r->bus->value = (byte)i;
+		registerTick(r);
+	}
+}
+
+static void benchCounter(void* ctx, unsigned long long iters, double* phaseStamps)
+{
+	(void)phaseStamps;
+	Counter* c = (Counter*)ctx;
+	for (unsigned long long i = 0; i < iters; ++i)
+	{
+		counterCount(c);
+	}
+}
+
+
+/* results */
+
+static void writeResults(FILE* f)
+{
+	for (int i = 0; i < numResults; ++i)
+	{
+		Result* r = &results[i];
+		fprintf(f, "{\"name\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.3f,\"cycles_per_op\":%.2f,",
+			r->name, r->ops, r->nsPerOp, r->cyclesPerOp);
+		if (r->allocsPerOp < 0)
+			fprintf(f, "\"allocs_per_op\":null}\n");
+		else
+			fprintf(f, "\"allocs_per_op\":%.3f}\n", r->allocsPerOp);
+	}
+}
+
+// compare against a previous results file (one object per line)
+static void compareResults(const char* baselineFile)
+{
+	FILE* f = fopen(baselineFile, "r");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Unable to open baseline: %s\n", baselineFile);
+		return;
+	}
+
+	fprintf(stderr, "\n%-32s %12s %12s %8s\n", "benchmark", "baseline", "current", "change");
+
+	char line[512];
+	while (fgets(line, sizeof(line), f))
+	{
+		char name[64];
+		double ns = 0;
+		char* p = strstr(line, "\"name\":\"");
+		char* q = strstr(line, "\"ns_per_op\":");
+		if (p == NULL || q == NULL || sscanf(p + 8, "%63[^\"]", name) != 1 || sscanf(q + 12, "%lf", &ns) != 1)
+			continue;
+
+		for (int i = 0; i < numResults; ++i)
+		{
+			if (strcmp(results[i].name, name) == 0)
+			{
+				fprintf(stderr, "%-32s %12.2f %12.2f %+7.1f%%\n", name, ns, results[i].nsPerOp,
+					ns > 0 ? (results[i].nsPerOp - ns) * 100.0 / ns : 0.0);
+			}
+		}
+	}
+	fclose(f);
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* outFile = NULL;
+	const char* baselineFile = NULL;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && strcmp(argv[i], "-r") == 0) romFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) filter = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) outFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) baselineFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) targetNs = atof(argv[++i]) * 1e9;
+		else
+		{
+			fprintf(stderr, "usage: %s [-r rom.hex] [-f filter] [-t seconds] [-o results.json] [-c baseline.json]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	calibrateStamps();
+
+	Rom* rom = newRomFromFile(romFile);
+
+	// computer
+	{
+		Computer* c = newComputerWithRom(rom);
+		loadProgram(c, BENCH_PROGRAM);
+		computerReset(c);
+
+		runBench("computerTick/low", benchTickLow, c);
+		runBench("computerTick/high", benchTickHigh, c);
+		runBench("computerTick/cycle", benchTickCycle, c);
+
+		computerSetFeatures(c, FEATURE_ALL);
+		runBench("computerRun/all", benchRun, c);
+		computerSetFeatures(c, FEATURE_LCD);
+		runBench("computerRun/lcd", benchRun, c);
+		computerSetFeatures(c, 0);
+		runBench("computerRun/bare", benchRun, c);
+
+		destroyComputer(c);
+	}
+
+	runBench("newComputer+destroyComputer", benchNewComputer, rom);
+	runBench("newRomFromFile", benchRomLoad, NULL);
+
+	{
+		LoadCtx l;
+		l.c = newComputerWithRom(rom);
+		for (int i = 0; i < 256; ++i)
+		{
+			snprintf(l.hex + i * 2, 3, "%02x", (i * 37) & 0xff);
+			l.bytes[i] = (byte)(i * 37);
+		}
+		runBench("loadProgram/256", benchLoadProgram, &l);
+		runBench("loadProgramBytes/256", benchLoadProgramBytes, &l);
+		destroyComputer(l.c);
+	}
+
+	{
+		// every opcode, so all formats are exercised
+		byte pgm[256];
+		for (int i = 0; i < 256; ++i)
+		{
+			pgm[i] = (byte)i;
+		}
+		runBench("disassemble", benchDisassemble, pgm);
+		runBench("disassembleProgram", benchDisassembleProgram, pgm);
+	}
+
+	// components
+	{
+		static const char* modeNames[] = { "inc", "b-a", "a-b", "a+b", "xor", "or", "and", "not" };
+
+		Bus* bus = newBus();
+		Register* rb = newRegister(bus, "Rb");
+		ALU* alu = newALU(bus, rb);
+		alu->out->state = ReadFromBus;
+		alu->useRb = 1;
+		rb->value = 0x5a;
+
+		char name[64];
+		for (int mode = 0; mode <= ALU_ALL; ++mode)
+		{
+			alu->mode = mode;
+			snprintf(name, sizeof(name), "aluTick/%s", modeNames[mode]);
+			runBench(name, benchAlu, alu);
+		}
+
+		Register* mar = newRegister(bus, "MAR");
+		Ram* ram = newRam(bus, mar, 256);
+		ram->value->state = WriteToBus;
+		runBench("ramTick/read", benchRam, ram);
+		ram->value->state = ReadFromBus;
+		runBench("ramTick/write", benchRam, ram);
+
+		Register* reg = newRegister(bus, "Ra");
+		reg->state = WriteToBus;
+		runBench("registerTick/write", benchRegister, reg);
+		reg->state = ReadFromBus;
+		runBench("registerTick/read", benchRegister, reg);
+
+		Counter* counter = newCounter(bus, "PC", 255);
+		runBench("counterCount", benchCounter, counter);
+
+		destroyCounter(counter);
+		destroyRegister(reg);
+		destroyRam(ram);
+		destroyRegister(mar);
+		destroyALU(alu);
+		destroyRegister(rb);
+		destroyBus(bus);
+	}
+
+	destroyRom(rom);
+
+	if (outFile)
+	{
+		FILE* f = fopen(outFile, "w");
+		if (f == NULL)
+		{
+			fprintf(stderr, "Unable to write: %s\n", outFile);
+			return 1;
+		}
+		writeResults(f);
+		fclose(f);
+	}
+	else
+	{
+		writeResults(stdout);
+	}
+
+	if (baselineFile)
+	{
+		compareResults(baselineFile);
+	}
+
+	return 0;
+}
@@ -0,0 +1,326 @@
+/*
+ * Troy's 8-bit computer - Emulator program corpus benchmark
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simcorpus [-r rom.hex] [-d corpus] [-t seconds] [-p] [-o results.json] [-c baseline.json]
+//
+// runs every program listed in corpus/manifest.txt to halt, or to its cycle
+// budget, and writes one json object per program plus an aggregate line.
+// short programs are re-run (from a fresh computer) until at least -t
+// seconds of emulation have been timed. each program runs in its own
+// process where fork() is available so peak RSS is per program. -p runs the
+// corpus on the pipelined machine (FEATURE_PIPELINE).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <unistd.h>
+  #include <sys/resource.h>
+  #include <sys/wait.h>
+  #define HAVE_FORK 1
+#endif
+
+#include "computer.h"
+#include "benchutil.h"
+
+#define MAX_PROGRAMS 64
+#define MAX_HEX (512 * 2 + 2)
+
+typedef struct
+{
+	char name[64];
+	unsigned long long cycles;       // per run
+	unsigned long long instructions; // per run
+	int halted;
+	int runs;
+	double wallMs;                   // per run
+	double cyclesPerSec;
+	double instructionsPerSec;
+	long peakRssKb;                  // < 0 if unavailable
+} Result;
+
+static Result results[MAX_PROGRAMS];
+static int numResults = 0;
+
+static double minNs = 0.2e9;
+static unsigned machineFeatures = 0;
+
+
+static void runProgram(Rom* rom, const char* hex, unsigned budget, Result* r)
+{
+	double totalNs = 0;
+	unsigned long long totalCycles = 0;
+	unsigned long long totalInstructions = 0;
+
+	r->runs = 0;
+	do
+	{
+		Computer* c = newComputerWithRom(rom);
+		computerSetFeatures(c, FEATURE_LCD | FEATURE_COUNTERS | machineFeatures);
+		clearMemory(c);
+		loadHex(c, hex);
+		computerReset(c);
+
+		double t0 = nowNs();
+		unsigned cycles = computerRun(c, budget);
+		totalNs += nowNs() - t0;
+
+		r->cycles = cycles;
+		r->instructions = c->counters.instructions;
+		r->halted = (c->controlWord & HLT) ? 1 : 0;
+		totalCycles += r->cycles;
+		totalInstructions += r->instructions;
+		++r->runs;
+
+		destroyComputer(c);
+	} while (totalNs < minNs);
+
+	r->wallMs = totalNs / r->runs / 1e6;
+	r->cyclesPerSec = totalCycles * 1e9 / totalNs;
+	r->instructionsPerSec = totalInstructions * 1e9 / totalNs;
+	r->peakRssKb = -1;
+}
+
+// run in a child process so that ru_maxrss covers this program alone
+static int measureProgram(Rom* rom, const char* hex, unsigned budget, Result* r)
+{
+#if HAVE_FORK
+	int fds[2];
+	if (pipe(fds) != 0)
+		return 0;
+
+	fflush(stdout);
+	fflush(stderr);
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		close(fds[0]);
+		runProgram(rom, hex, budget, r);
+		ssize_t written = write(fds[1], r, sizeof(*r));
+		_exit(written == sizeof(*r) ? 0 : 1);
+	}
+	close(fds[1]);
+	if (pid < 0)
+	{
+		close(fds[0]);
+		return 0;
+	}
+
+	Result child;
+	ssize_t got = read(fds[0], &child, sizeof(child));
+	close(fds[0]);
+
+	int status = 0;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) < 0 || got != sizeof(child) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return 0;
+
+	*r = child;
+	r->peakRssKb = usage.ru_maxrss;
+	return 1;
+#else
+	runProgram(rom, hex, budget, r);
+	return 1;
+#endif
+}
+
+
+static void writeResult(FILE* f, const Result* r)
+{
+	fprintf(f, "{\"name\":\"%s\",\"cycles\":%llu,\"instructions\":%llu,\"halted\":%s,\"runs\":%d,"
+		"\"wall_ms\":%.3f,\"cycles_per_sec\":%.0f,\"instructions_per_sec\":%.0f,",
+		r->name, r->cycles, r->instructions, r->halted ? "true" : "false", r->runs,
+		r->wallMs, r->cyclesPerSec, r->instructionsPerSec);
+	if (r->peakRssKb < 0)
+		fprintf(f, "\"peak_rss_kb\":null}\n");
+	else
+		fprintf(f, "\"peak_rss_kb\":%ld}\n", r->peakRssKb);
+}
+
+// aggregate score: geometric mean of emulated cycles per second (millions)
+static double aggregateScore()
+{
+	double logSum = 0;
+	for (int i = 0; i < numResults; ++i)
+	{
+		logSum += log(results[i].cyclesPerSec / 1e6);
+	}
+	return numResults ? exp(logSum / numResults) : 0.0;
+}
+
+static void writeResults(FILE* f)
+{
+	unsigned long long cycles = 0;
+	double ms = 0;
+	long peakRss = 0;
+	for (int i = 0; i < numResults; ++i)
+	{
+		writeResult(f, &results[i]);
+		cycles += results[i].cycles;
+		ms += results[i].wallMs;
+		if (results[i].peakRssKb > peakRss) peakRss = results[i].peakRssKb;
+	}
+	fprintf(f, "{\"name\":\"aggregate\",\"programs\":%d,\"cycles\":%llu,\"wall_ms\":%.3f,\"peak_rss_kb\":%ld,\"score\":%.3f}\n",
+		numResults, cycles, ms, peakRss, aggregateScore());
+}
+
+static int jsonNumber(const char* line, const char* key, double* value)
+{
+	const char* p = strstr(line, key);
+	return p != NULL && sscanf(p + strlen(key), "%lf", value) == 1;
+}
+
+// compare against a previous results file. cycle and instruction counts are
+// deterministic, so any difference there is a behaviour change, not noise
+static int compareResults(const char* baselineFile)
+{
+	FILE* f = fopen(baselineFile, "r");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Unable to open baseline: %s\n", baselineFile);
+		return 1;
+	}
+
+	int mismatches = 0;
+	fprintf(stderr, "\n%-28s %14s %14s %8s\n", "program", "baseline c/s", "current c/s", "change");
+
+	char line[1024];
+	while (fgets(line, sizeof(line), f))
+	{
+		char name[64];
+		const char* p = strstr(line, "\"name\":\"");
+		if (p == NULL || sscanf(p + 8, "%63[^\"]", name) != 1)
+			continue;
+
+		if (strcmp(name, "aggregate") == 0)
+		{
+			double score = 0;
+			if (jsonNumber(line, "\"score\":", &score) && score > 0)
+			{
+				double current = aggregateScore();
+				fprintf(stderr, "%-28s %14.3f %14.3f %+7.1f%%\n", "score (Mcycles/s)", score, current, (current - score) * 100.0 / score);
+			}
+			continue;
+		}
+
+		double rate = 0, cycles = 0, instructions = 0;
+		jsonNumber(line, "\"cycles_per_sec\":", &rate);
+		jsonNumber(line, "\"cycles\":", &cycles);
+		jsonNumber(line, "\"instructions\":", &instructions);
+
+		for (int i = 0; i < numResults; ++i)
+		{
+			Result* r = &results[i];
+			if (strcmp(r->name, name) != 0)
+				continue;
+
+			fprintf(stderr, "%-28s %14.0f %14.0f %+7.1f%%", name, rate, r->cyclesPerSec,
+				rate > 0 ? (r->cyclesPerSec - rate) * 100.0 / rate : 0.0);
+			if ((unsigned long long)cycles != r->cycles || (unsigned long long)instructions != r->instructions)
+			{
+				fprintf(stderr, "  (cycles/instructions differ: %.0f/%.0f -> %llu/%llu)", cycles, instructions, r->cycles, r->instructions);
+				++mismatches;
+			}
+			fprintf(stderr, "\n");
+		}
+	}
+	fclose(f);
+	return mismatches ? 2 : 0;
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* romFile = "rom.hex";
+	const char* corpusDir = "corpus";
+	const char* outFile = NULL;
+	const char* baselineFile = NULL;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && strcmp(argv[i], "-r") == 0) romFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-d") == 0) corpusDir = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) outFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) baselineFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) minNs = atof(argv[++i]) * 1e9;
+		else if (strcmp(argv[i], "-p") == 0) machineFeatures |= FEATURE_PIPELINE;
+		else
+		{
+			fprintf(stderr, "usage: %s [-r rom.hex] [-d corpus] [-t seconds] [-p] [-o results.json] [-c baseline.json]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	char path[512];
+	snprintf(path, sizeof(path), "%s/manifest.txt", corpusDir);
+	FILE* manifest = fopen(path, "r");
+	if (manifest == NULL)
+	{
+		fprintf(stderr, "Unable to open manifest: %s\n", path);
+		return 1;
+	}
+
+	Rom* rom = newRomFromFile(romFile);
+
+	// manifest lines: <file.hex> <cycle budget>   (# starts a comment)
+	char line[256];
+	while (fgets(line, sizeof(line), manifest) && numResults < MAX_PROGRAMS)
+	{
+		char file[128];
+		unsigned budget = 0;
+		if (line[0] == '#' || sscanf(line, "%127s %u", file, &budget) != 2)
+			continue;
+
+		char hex[MAX_HEX];
+		snprintf(path, sizeof(path), "%s/%s", corpusDir, file);
+		if (readHex(path, hex, sizeof(hex)) <= 0)
+		{
+			fprintf(stderr, "Unable to read program: %s\n", path);
+			continue;
+		}
+
+		Result* r = &results[numResults];
+		memset(r, 0, sizeof(*r));
+		snprintf(r->name, sizeof(r->name), "%.*s", (int)(strcspn(file, ".")), file);
+
+		if (!measureProgram(rom, hex, budget, r))
+		{
+			fprintf(stderr, "Failed to run program: %s\n", path);
+			continue;
+		}
+		fprintf(stderr, "%-28s %12llu cycles %8.2f Mcycles/s%s\n", r->name, r->cycles, r->cyclesPerSec / 1e6, r->halted ? " (halted)" : "");
+		++numResults;
+	}
+	fclose(manifest);
+	destroyRom(rom);
+
+	if (outFile)
+	{
+		FILE* f = fopen(outFile, "w");
+		if (f == NULL)
+		{
+			fprintf(stderr, "Unable to write: %s\n", outFile);
+			return 1;
+		}
+		writeResults(f);
+		fclose(f);
+	}
+	else
+	{
+		writeResults(stdout);
+	}
+
+	return baselineFile ? compareResults(baselineFile) : 0;
+}
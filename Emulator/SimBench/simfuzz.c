@@ -0,0 +1,240 @@
+/*
+ * Troy's 8-bit computer - Emulator differential fuzzer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simfuzz [-r rom.hex] [-p] [-n programs] [-i instructions] [-s seed]
+//
+// runs random programs through the microcode core and the instruction level
+// reference interpreter (isa.h) side by side, comparing them after every
+// instruction: registers, Acc, flags, PC, ram, program memory, halting and
+// the events (Rd outputs, lcd bytes, program memory writes) of the
+// instruction. program memory, ram and the starting registers are random.
+// a program ends at hlt or after the given number of instructions
+//
+// with -p the core is the pipelined machine (FEATURE_PIPELINE, use
+// rom-pipelined.hex). a wide step rom (rom.h) also checks mul, cpy, add16
+// and sub16, and a shift unit rom (MicrocodeTools -s) shl/shr/rlc/rrc Rb.
+//
+// stops at the first divergent instruction and prints it with the state
+// before it and the fields that differ, then exits with 2. program n of a
+// run with seed s is program 0 of a run with seed s + n
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "computer.h"
+#include "isa.h"
+#include "disasm.h"
+#include "benchutil.h"
+
+#define TRACE_EVENTS (EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) | EVENT_MASK(EventLcdData) | EVENT_MASK(EventPgmWrite) | EVENT_MASK(EventHalt))
+#define MAX_EVENTS 16
+#define MAX_INSTRUCTION_CYCLES 64  // longer than any instruction: its end was missed
+
+static const char* eventNames[] = { "output", "lcc", "lcd", "halt", "pgm write" };
+
+
+static unsigned long long rngState;
+
+static unsigned rng()
+{
+	// xorshift64*
+	rngState ^= rngState >> 12;
+	rngState ^= rngState << 25;
+	rngState ^= rngState >> 27;
+	return (unsigned)((rngState * 2685821657736338717ULL) >> 32);
+}
+
+static void randomMachine(IsaMachine* m, unsigned long long seed)
+{
+	rngState = seed * 0x9e3779b97f4a7c15ULL + 1;
+
+	m->ra = (byte)rng();
+	m->rb = (byte)rng();
+	m->rc = (byte)rng();
+	m->rd = (byte)rng();
+	m->sp = (byte)rng();
+	m->pc = (byte)rng();
+	m->acc = (byte)rng();
+	m->flags = (byte)(rng() & 0x0f);
+	m->halted = 0;
+	m->instructions = 0;
+
+	for (int i = 0; i < 256; ++i)
+	{
+		m->pgm[i] = (byte)rng();
+		m->ram[i] = (byte)rng();
+	}
+}
+
+// run the core to the end of the instruction: until the step counter is
+// back at the fetch (or the next instruction has been fetched, pipelined)
+static int stepComputer(Computer* c)
+{
+	for (int cycles = 0; cycles < MAX_INSTRUCTION_CYCLES; ++cycles)
+	{
+		computerRun(c, 1);
+		if ((c->controlWord & HLT) || c->fetched || (!(computerGetFeatures(c) & FEATURE_PIPELINE) && c->tc->r->value == 0))
+			return 1;
+	}
+	return 0;
+}
+
+static int sameEvent(const SimEvent* a, const SimEvent* b)
+{
+	// the program counter reported with an event depends on the step it
+	// happened in, so only program memory writes compare addresses
+	return a->type == b->type && a->value == b->value &&
+		(a->type != EventPgmWrite || a->address == b->address);
+}
+
+static void printState(const char* label, const IsaMachine* m)
+{
+	printf("  %-10s Ra %02x Rb %02x Rc %02x Rd %02x SP %02x PC %02x Acc %02x flags %c%c%c%c%s\n", label,
+		m->ra, m->rb, m->rc, m->rd, m->sp, m->pc, m->acc,
+		(m->flags & FLAG_ZERO) ? 'Z' : '-', (m->flags & FLAG_CARRY) ? 'C' : '-',
+		(m->flags & FLAG_OFLOW) ? 'O' : '-', (m->flags & FLAG_NEG) ? 'N' : '-',
+		m->halted ? " halted" : "");
+}
+
+static void printEvents(const char* label, const SimEvent* events, int count)
+{
+	printf("  %-10s", label);
+	for (int i = 0; i < count; ++i)
+	{
+		printf(" %s %02x", eventNames[events[i].type], events[i].value);
+		if (events[i].type == EventPgmWrite)
+			printf("@%02x", events[i].address);
+	}
+	printf(count ? "\n" : " (no events)\n");
+}
+
+static int diverges(const IsaMachine* isa, const IsaMachine* core,
+	const SimEvent* isaEvents, int isaCount, const SimEvent* coreEvents, int coreCount)
+{
+	int diverged = memcmp(isa->ram, core->ram, sizeof(isa->ram)) || memcmp(isa->pgm, core->pgm, sizeof(isa->pgm)) ||
+		isa->ra != core->ra || isa->rb != core->rb || isa->rc != core->rc || isa->rd != core->rd ||
+		isa->sp != core->sp || isa->pc != core->pc || isa->acc != core->acc || isa->flags != core->flags ||
+		isa->halted != core->halted || isaCount != coreCount;
+
+	for (int i = 0; !diverged && i < isaCount; ++i)
+	{
+		diverged = !sameEvent(&isaEvents[i], &coreEvents[i]);
+	}
+	return diverged;
+}
+
+static void printDifferences(const IsaMachine* isa, const IsaMachine* core,
+	const SimEvent* isaEvents, int isaCount, const SimEvent* coreEvents, int coreCount)
+{
+	printState("reference", isa);
+	printState("microcode", core);
+	for (int i = 0; i < 256; ++i)
+	{
+		if (isa->ram[i] != core->ram[i])
+			printf("  ram[%02x]    reference %02x, microcode %02x\n", i, isa->ram[i], core->ram[i]);
+		if (isa->pgm[i] != core->pgm[i])
+			printf("  pgm[%02x]    reference %02x, microcode %02x\n", i, isa->pgm[i], core->pgm[i]);
+	}
+	printEvents("reference", isaEvents, isaCount);
+	printEvents("microcode", coreEvents, coreCount);
+}
+
+int main(int argc, char** argv)
+{
+	const char* romFile = "rom.hex";
+	unsigned long long seed = 1;
+	unsigned programs = 10000;
+	unsigned maxInstructions = 1000;
+	int pipeline = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && strcmp(argv[i], "-r") == 0) romFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) programs = (unsigned)strtoul(argv[++i], NULL, 0);
+		else if (i + 1 < argc && strcmp(argv[i], "-i") == 0) maxInstructions = (unsigned)strtoul(argv[++i], NULL, 0);
+		else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) seed = strtoull(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-p") == 0) pipeline = 1;
+		else
+		{
+			fprintf(stderr, "usage: %s [-r rom.hex] [-p] [-n programs] [-i instructions] [-s seed]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Computer* c = newComputerWithRom(newRomFromFile(romFile));
+	c->ownsRom = 1;
+	computerSetFeatures(c, FEATURE_TRACE | (pipeline ? FEATURE_PIPELINE : 0));
+	computerEnableEvents(c, TRACE_EVENTS, MAX_EVENTS);
+
+	IsaMachine* isa = newIsaMachine();
+	isa->events = newEventQueue(TRACE_EVENTS, MAX_EVENTS);
+	IsaMachine* core = newIsaMachine();
+	IsaMachine* before = newIsaMachine();
+
+	unsigned long long instructions = 0;
+	unsigned long long halted = 0;
+	unsigned run = 0;
+	double start = nowNs();
+	int diverged = 0;
+
+	for (unsigned p = 0; p < programs && !diverged; ++p, ++run)
+	{
+		randomMachine(isa, seed + p);
+		isaCopyToComputer(isa, c);
+		isa->wideSteps = c->rom->stepBits == ROM_WIDE_STEP_BITS;
+		isa->shiftUnit = isaRomHasShiftUnit(c->rom);
+		eventQueueClear(c->events);
+		eventQueueClear(isa->events);
+
+		for (unsigned n = 0; n < maxInstructions && !isa->halted; ++n)
+		{
+			*before = *isa;
+			isaStep(isa);
+			int finished = stepComputer(c);
+			isaCopyFromComputer(core, c);
+			++instructions;
+
+			SimEvent isaEvents[MAX_EVENTS];
+			SimEvent coreEvents[MAX_EVENTS];
+			int isaCount = eventQueueRead(isa->events, isaEvents, MAX_EVENTS);
+			int coreCount = computerReadEvents(c, coreEvents, MAX_EVENTS);
+
+			if (!finished || diverges(isa, core, isaEvents, isaCount, coreEvents, coreCount))
+			{
+				char text[DISASM_TEXT_SIZE];
+				disassemble(before->pgm, before->pc, text);
+				printf("divergence: seed %llu, instruction %u at %02x: %s (opcode %02x)%s\n",
+					seed + p, n, before->pc, text, before->pgm[before->pc],
+					finished ? "" : ", microcode did not finish the instruction");
+				printState("before", before);
+				printDifferences(isa, core, isaEvents, isaCount, coreEvents, coreCount);
+				printf("reproduce: %s -r %s%s -s %llu -n 1\n", argv[0], romFile, pipeline ? " -p" : "", seed + p);
+				diverged = 1;
+				break;
+			}
+		}
+		halted += isa->halted;
+	}
+
+	double seconds = (nowNs() - start) / 1e9;
+	fprintf(stderr, "%llu instructions in %u programs (%llu halted), %.0f instructions/sec, %s\n",
+		instructions, run, halted, seconds > 0 ? instructions / seconds : 0.0,
+		diverged ? "diverged" : "no divergence");
+
+	destroyEventQueue(isa->events);
+	destroyIsaMachine(isa);
+	destroyIsaMachine(core);
+	destroyIsaMachine(before);
+	destroyComputer(c);
+
+	return diverged ? 2 : 0;
+}
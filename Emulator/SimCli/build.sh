@@ -0,0 +1,8 @@
+#!/bin/sh
+# Linux build of the command line runner
+
+cd "$(dirname "$0")"
+
+cc -O2 -o simcli -I ../SimLib -I ../SimBench -I ../vrEmuLcd/src \
+  simcli.c ../SimBench/benchutil.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c ../SimLib/rom.c \
+  ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../SimLib/inputscript.c ../SimLib/isa.c ../vrEmuLcd/src/vrEmuLcd.c
@@ -0,0 +1,408 @@
+/*
+ * Troy's 8-bit computer - Emulator command line runner
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: simcli [options] program.hex
+//
+//   -r rom.hex    microcode rom (default rom.hex)
+//   -m ram.hex    initial ram image (hex). a program hex longer than 512
+//                 characters also carries ram, as in the web emulator
+//   -c cycles     stop after this many clock cycles (default 10000000, 0 = no limit)
+//   -t seconds    stop after this much wall time
+//   -z hz         run in real time, paced to this clock rate
+//   -n count      keep the last count Rd outputs (default 1024)
+//   -s script     scripted input (inputscript.h): set Rd at given cycles, or
+//                 when text appears on the lcd. recorded in the web emulator
+//                 with R. microcode only (not with -i)
+//   -f frames     write the lcd frame hashes (lcdShadowFrameHash) to this
+//                 file, a "<cycle> <hash>" line each time the picture changes
+//   -p lcd.pbm    write the final lcd pixels (cgram characters included) as
+//                 a plain pbm image
+//   -i            fast mode: run on the instruction level interpreter (isa.h)
+//                 instead of the microcode. -c and -z count instructions. the
+//                 rom only selects the instruction set (standard, wide step or
+//                 shift unit)
+//
+// runs until the program halts or a budget is reached, then prints a json
+// object with the final machine state, Rd output history, lcd text and
+// frame hashes, and performance figures. lcd_frames.stream hashes the
+// sequence of frames (not their cycles), so it only changes if the
+// program's lcd output does, whatever the microcode timing
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+#include "computer.h"
+#include "lcdshadow.h"
+#include "inputscript.h"
+#include "isa.h"
+#include "benchutil.h"
+
+#define SLICE_CYCLES 100000
+#define MAX_HEX      (1024 + 2)
+
+typedef struct
+{
+	LcdShadow* lcd;
+
+	byte* outputs;        // ring of the last maxOutputs Rd values
+	int maxOutputs;
+	unsigned long long outputCount;
+
+	unsigned frameHash;   // lcd picture hash (lcdShadowFrameHash)
+	unsigned streamHash;  // hash of the sequence of frame hashes
+	unsigned long long frames;
+	FILE* frameFile;      // -f, or NULL
+	int tickShift;        // event ticks to cycles: 1 (2 edges a cycle), 0 with -i
+} RunState;
+
+
+static void sleepNs(double ns)
+{
+	if (ns <= 0)
+		return;
+#ifdef _WIN32
+	Sleep((DWORD)(ns / 1e6));
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t)(ns / 1e9);
+	ts.tv_nsec = (long)(ns - ts.tv_sec * 1e9);
+	nanosleep(&ts, NULL);
+#endif
+}
+
+// whole file, NULL if it can't be read
+static char* readText(const char* filename)
+{
+	FILE* f = fopen(filename, "rb");
+	if (f == NULL)
+		return NULL;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char* text = (char*)malloc(size + 1);
+	size = (long)fread(text, 1, size, f);
+	text[size] = '\0';
+	fclose(f);
+	return text;
+}
+
+// a frame each time an lcd write changes the picture
+static void trackFrame(RunState* s, const SimEvent* ev)
+{
+	unsigned hash = lcdShadowFrameHash(s->lcd);
+	if (hash == s->frameHash)
+		return;
+
+	s->frameHash = hash;
+	++s->frames;
+	for (int i = 0; i < 4; ++i)
+		s->streamHash = (s->streamHash ^ ((hash >> (i * 8)) & 0xff)) * 16777619u;
+	if (s->frameFile)
+		fprintf(s->frameFile, "%u %08x\n", ev->tick >> s->tickShift, hash);
+}
+
+static int writePixels(LcdShadow* lcd, const char* filename)
+{
+	FILE* f = fopen(filename, "w");
+	if (f == NULL)
+		return 0;
+
+	int width = LCD_PIXELS_X(lcd->width);
+	int height = LCD_PIXELS_Y(lcd->height);
+	byte* pixels = (byte*)malloc(width * height);
+	lcdShadowPixels(lcd, pixels);
+
+	fprintf(f, "P1\n%d %d\n", width, height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+			fputc(pixels[y * width + x] ? '1' : '0', f);
+		fputc('\n', f);
+	}
+	free(pixels);
+	fclose(f);
+	return 1;
+}
+
+static void onEvent(const SimEvent* ev, void* userData)
+{
+	RunState* s = (RunState*)userData;
+	switch (ev->type)
+	{
+	case EventOutput:
+		s->outputs[s->outputCount % s->maxOutputs] = ev->value;
+		++s->outputCount;
+		break;
+
+	case EventLcdCommand:
+		lcdShadowCommand(s->lcd, ev->value);
+		trackFrame(s, ev);
+		break;
+
+	case EventLcdData:
+		lcdShadowData(s->lcd, ev->value);
+		trackFrame(s, ev);
+		break;
+	}
+}
+
+static void printJsonString(const char* str)
+{
+	putchar('"');
+	for (; *str; ++str)
+	{
+		unsigned char ch = (unsigned char)*str;
+		if (ch == '"' || ch == '\\')
+			printf("\\%c", ch);
+		else if (ch < 0x20 || ch > 0x7e)
+			printf("\\u%04x", ch);
+		else
+			putchar(ch);
+	}
+	putchar('"');
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* romFile = "rom.hex";
+	const char* ramFile = NULL;
+	const char* programFile = NULL;
+	const char* scriptFile = NULL;
+	const char* frameFile = NULL;
+	const char* pixelFile = NULL;
+	unsigned long long maxCycles = 10000000;
+	double maxNs = 0;
+	double hz = 0;
+	int maxOutputs = 1024;
+	int fast = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && strcmp(argv[i], "-r") == 0) romFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-m") == 0) ramFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) maxCycles = strtoull(argv[++i], NULL, 0);
+		else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) maxNs = atof(argv[++i]) * 1e9;
+		else if (i + 1 < argc && strcmp(argv[i], "-z") == 0) hz = atof(argv[++i]);
+		else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) maxOutputs = atoi(argv[++i]);
+		else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) scriptFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) frameFile = argv[++i];
+		else if (i + 1 < argc && strcmp(argv[i], "-p") == 0) pixelFile = argv[++i];
+		else if (strcmp(argv[i], "-i") == 0) fast = 1;
+		else if (argv[i][0] != '-' && programFile == NULL) programFile = argv[i];
+		else programFile = NULL, i = argc;
+	}
+
+	if (programFile == NULL || maxOutputs < 1 || (fast && scriptFile))
+	{
+		fprintf(stderr, "usage: %s [-r rom.hex] [-m ram.hex] [-c cycles] [-t seconds] [-z hz] [-n outputs] [-f frames] [-p lcd.pbm] [-s script | -i] program.hex\n", argv[0]);
+		return 1;
+	}
+
+	char hex[MAX_HEX];
+	if (readHex(programFile, hex, sizeof(hex)) < 0)
+	{
+		fprintf(stderr, "Unable to open program: %s\n", programFile);
+		return 1;
+	}
+
+	InputScript* script = NULL;
+	if (scriptFile)
+	{
+		int errorLine = 0;
+		char* text = readText(scriptFile);
+		if (text == NULL)
+		{
+			fprintf(stderr, "Unable to open input script: %s\n", scriptFile);
+			return 1;
+		}
+		script = newInputScript(text, &errorLine);
+		free(text);
+		if (script == NULL)
+		{
+			fprintf(stderr, "%s:%d: malformed input script line\n", scriptFile, errorLine);
+			return 1;
+		}
+	}
+
+	Computer* c = newComputerWithRom(newRomFromFile(romFile));
+	c->ownsRom = 1;
+
+	loadHex(c, hex);
+
+	if (ramFile)
+	{
+		char ram[MAX_HEX];
+		if (readHex(ramFile, ram, sizeof(ram)) < 0)
+		{
+			fprintf(stderr, "Unable to open ram image: %s\n", ramFile);
+			return 1;
+		}
+		loadRam(c, ram);
+	}
+
+	RunState state;
+	state.lcd = newLcdShadow(16, 2);
+	state.outputs = (byte*)malloc(maxOutputs);
+	state.maxOutputs = maxOutputs;
+	state.outputCount = 0;
+	state.frameHash = lcdShadowFrameHash(state.lcd);
+	state.streamHash = 2166136261u;
+	state.frames = 0;
+	state.tickShift = fast ? 0 : 1;
+	state.frameFile = NULL;
+	if (frameFile && (state.frameFile = fopen(frameFile, "w")) == NULL)
+	{
+		fprintf(stderr, "Unable to write lcd frames: %s\n", frameFile);
+		return 1;
+	}
+
+	// the lcd shadow replaces the lcd emulator here, so FEATURE_LCD is left out
+	computerSetFeatures(c, FEATURE_TRACE | FEATURE_COUNTERS);
+	computerEnableEvents(c, EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) | EVENT_MASK(EventLcdData), 0);
+	computerSetEventCallback(c, onEvent, &state);
+	computerReset(c);
+
+	// fast mode starts from the same power on state as the microcode
+	IsaMachine* isa = NULL;
+	if (fast)
+	{
+		isa = newIsaMachine();
+		isaCopyFromComputer(isa, c);
+		isa->events = newEventQueue(EVENT_MASK(EventOutput) | EVENT_MASK(EventLcdCommand) | EVENT_MASK(EventLcdData), 0);
+		isa->events->callback = onEvent;
+		isa->events->userData = &state;
+	}
+
+	// run in slices so the time budget and pacing can be checked. paced
+	// slices are 10ms of emulated time
+	unsigned slice = SLICE_CYCLES;
+	if (hz > 0)
+	{
+		slice = (unsigned)(hz / 100);
+		if (slice == 0) slice = 1;
+	}
+
+	const char* stopReason = "cycles";
+	unsigned long long cycles = 0;
+	double start = nowNs();
+	double elapsed = 0;
+	for (;;)
+	{
+		unsigned run = slice;
+		if (maxCycles && maxCycles - cycles < run)
+			run = (unsigned)(maxCycles - cycles);
+
+		cycles += fast ? isaRun(isa, run) : script ? inputScriptRun(script, c, state.lcd, run) : computerRun(c, run);
+		elapsed = nowNs() - start;
+
+		if (fast ? isa->halted : (c->controlWord & HLT) != 0)
+		{
+			stopReason = "halt";
+			break;
+		}
+		if (maxCycles && cycles >= maxCycles)
+		{
+			stopReason = "cycles";
+			break;
+		}
+		if (maxNs > 0 && elapsed >= maxNs)
+		{
+			stopReason = "time";
+			break;
+		}
+
+		if (hz > 0)
+		{
+			sleepNs(cycles * 1e9 / hz - elapsed);
+		}
+	}
+
+	int halted = fast ? isa->halted : (c->controlWord & HLT) != 0;
+	unsigned long long instructions = c->counters.instructions;
+	if (fast)
+	{
+		// ir, step, mar and bus are not modelled and read as after a reset
+		isaCopyToComputer(isa, c);
+		instructions = isa->instructions;
+	}
+
+	printf("{\n  \"stop\": \"%s\",\n", stopReason);
+	printf("  \"halted\": %s,\n", halted ? "true" : "false");
+
+	printf("  \"state\": {\"pc\": %d, \"ir\": %d, \"step\": %d, \"ra\": %d, \"rb\": %d, \"rc\": %d, \"rd\": %d, \"sp\": %d, \"mar\": %d, \"bus\": %d, \"flags\": %d},\n",
+		c->pc->r->value, c->ir->value, c->tc->r->value, c->ra->value, c->rb->value, c->rc->value,
+		c->rd->value, c->sp->value, c->mar->value, c->bus->value, c->alu->flags);
+
+	printf("  \"ram\": \"");
+	for (int i = 0; i < 256; ++i)
+	{
+		printf("%02x", ramByte(c, i));
+	}
+	printf("\",\n");
+
+	// oldest first
+	unsigned long long kept = state.outputCount < (unsigned long long)maxOutputs ? state.outputCount : (unsigned long long)maxOutputs;
+	printf("  \"output_count\": %llu,\n  \"output\": [", state.outputCount);
+	for (unsigned long long i = state.outputCount - kept; i < state.outputCount; ++i)
+	{
+		printf(i + 1 < state.outputCount ? "%d," : "%d", state.outputs[i % maxOutputs]);
+	}
+	printf("],\n");
+
+	printf("  \"lcd\": [");
+	for (int row = 0; row < state.lcd->height; ++row)
+	{
+		char text[LCD_LINE_LENGTH + 1];
+		lcdShadowRow(state.lcd, row, text);
+		printJsonString(text);
+		printf(row + 1 < state.lcd->height ? ", " : "");
+	}
+	printf("],\n");
+
+	printf("  \"lcd_frames\": {\"count\": %llu, \"hash\": \"%08x\", \"stream\": \"%08x\"},\n",
+		state.frames, state.frameHash, state.streamHash);
+
+	// fast mode has no clock: cycles are instructions
+	double seconds = elapsed / 1e9;
+	printf("  \"perf\": {\"cycles\": %llu, \"instructions\": %llu, \"wall_ms\": %.3f, \"cycles_per_sec\": %.0f, \"instructions_per_sec\": %.0f}\n}\n",
+		cycles, instructions, elapsed / 1e6,
+		seconds > 0 ? cycles / seconds : 0.0, seconds > 0 ? instructions / seconds : 0.0);
+
+	if (isa)
+	{
+		destroyEventQueue(isa->events);
+		destroyIsaMachine(isa);
+	}
+	if (pixelFile && !writePixels(state.lcd, pixelFile))
+	{
+		fprintf(stderr, "Unable to write lcd pixels: %s\n", pixelFile);
+	}
+	if (state.frameFile)
+	{
+		fclose(state.frameFile);
+	}
+
+	destroyInputScript(script);
+	free(state.outputs);
+	destroyLcdShadow(state.lcd);
+	destroyComputer(c);
+
+	return 0;
+}
@@ -12,16 +12,81 @@
 
 #include "siminst.h"
 #include "computer.h"
+#include "inputscript.h"
 #include <stdlib.h>
+#include <string.h>
+
+#if SI_EMBEDDED_ROM
+// built in by SimWasm/build.sh (rompack), rather than read from rom.hex
+#include "rompacked.h"
+#endif
 
 static Computer* _c = NULL;
+static SIStateBlock _state;
+static InputScript* _script = NULL;
+
+// the machine starts over: so does the input script
+static void resetComputer()
+{
+	computerReset(_c);
+	if (_script)
+	{
+		inputScriptRewind(_script);
+	}
+}
+
+// the words front ends poll between frames (halted? lcd written? how far
+// did it get?) are kept current after every call: a few stores, so clock
+// edges stay cheap
+static void updateCounters()
+{
+	if (_c == NULL)
+	{
+		return;
+	}
+
+	_state.tick = _c->tick;
+	_state.controlWord = _c->controlWord;
+	_state.lcdWrites = _c->lcdWrites;
+	_state.instructions = (unsigned)_c->counters.instructions;
+}
+
+// the rest (registers, memory, lcd) is only copied when asked for, by
+// siGetState(), so once per frame rather than per call
+static void updateState()
+{
+	_state.version = SI_STATE_VERSION;
+	_state.size = sizeof(SIStateBlock);
+	if (_c == NULL)
+	{
+		return;
+	}
+
+	++_state.updates;
+	updateCounters();
+	for (int i = 0; i < SI_COMPONENTS; ++i)
+	{
+		_state.values[i] = siGetValue((SIComponent)i);
+	}
+	memcpy(_state.ram, _c->ram->bytes, sizeof(_state.ram));
+	memcpy(_state.pgm, _c->pgm->bytes, sizeof(_state.pgm));
+	_state.lcdFlags = (_c->lcdShadow->displayOn ? SI_LCD_DISPLAY : 0) |
+		(_c->lcdShadow->cursorOn ? SI_LCD_CURSOR : 0) | (_c->lcdShadow->blinkOn ? SI_LCD_BLINK : 0);
+	_state.lcdCursor = lcdShadowCursorCell(_c->lcdShadow);
+}
 
 SIDLLEXPORT void siInitialise()
 {
 	if (_c == NULL)
 	{
+#if SI_EMBEDDED_ROM
+		_c = newComputerWithRom(newRomFromPacked(romPacked, sizeof(romPacked)));
+		_c->ownsRom = 1;
+#else
 		_c = newComputer();
+#endif
 	}
+	updateCounters();
 }
 
 SIDLLEXPORT void siDestroy()
@@ -31,6 +96,9 @@ SIDLLEXPORT void siDestroy()
 		destroyComputer(_c);
 		_c = NULL;
 	}
+	destroyInputScript(_script);
+	_script = NULL;
+	memset(&_state, 0, sizeof(_state));
 }
 
 SIDLLEXPORT void siLoadProgram(const char* program)
@@ -38,7 +106,8 @@ SIDLLEXPORT void siLoadProgram(const char* program)
 	if (_c)
 	{
 		loadProgram(_c, program);
-		computerReset(_c);
+		resetComputer();
+		updateCounters();
 	}
 }
 
@@ -47,10 +116,31 @@ SIDLLEXPORT void siLoadRam(const char* data)
   if (_c)
   {
     loadRam(_c, data);
-    computerReset(_c);
+    resetComputer();
+    updateCounters();
   }
 }
 
+SIDLLEXPORT void siLoadProgramBytes(const byte* data, int length)
+{
+	if (_c)
+	{
+		loadProgramBytes(_c, data, length);
+		resetComputer();
+		updateCounters();
+	}
+}
+
+SIDLLEXPORT void siLoadRamBytes(const byte* data, int length)
+{
+	if (_c)
+	{
+		loadRamBytes(_c, data, length);
+		resetComputer();
+		updateCounters();
+	}
+}
+
 SIDLLEXPORT byte siRamByte(int offset)
 {
   if (_c)
@@ -60,11 +150,20 @@ SIDLLEXPORT byte siRamByte(int offset)
   return 0;
 }
 
+SIDLLEXPORT void siLoadRom(const char* rom)
+{
+  if (_c)
+  {
+    computerSwapRom(_c, newRomFromString(rom), 1);
+  }
+}
+
 SIDLLEXPORT void siSetInput(byte inputByte)
 {
   if (_c)
   {
     setInput(_c, inputByte);
+    updateCounters();
   }
 }
 
@@ -75,6 +174,7 @@ SIDLLEXPORT void siSetClock(int high)
 	if (_c)
 	{
 		computerTick(_c, high);
+		updateCounters();
 	}
 }
 
@@ -82,7 +182,43 @@ SIDLLEXPORT void siReset()
 {
 	if (_c)
 	{
-		computerReset(_c);
+		resetComputer();
+		updateCounters();
+	}
+}
+
+SIDLLEXPORT unsigned siRun(unsigned cycles)
+{
+	if (_c)
+	{
+		// input script triggers see the lcd text when the lcd is emulated
+		unsigned run = _script ?
+			inputScriptRun(_script, _c, (computerGetFeatures(_c) & FEATURE_LCD) ? _c->lcdShadow : NULL, cycles) :
+			computerRun(_c, cycles);
+		updateCounters();
+		return run;
+	}
+	return 0;
+}
+
+SIDLLEXPORT int siSetInputScript(const char* script)
+{
+	destroyInputScript(_script);
+	_script = NULL;
+
+	int errorLine = 0;
+	if (script && *script)
+	{
+		_script = newInputScript(script, &errorLine);
+	}
+	return errorLine;
+}
+
+SIDLLEXPORT void siSetFeatures(unsigned features)
+{
+	if (_c)
+	{
+		computerSetFeatures(_c, features);
 	}
 }
 
@@ -158,3 +294,36 @@ SIDLLEXPORT unsigned siGetControlWord()
 	return 0;
 
 }
+
+SIDLLEXPORT const SIStateBlock* siGetState()
+{
+	updateState();
+	return &_state;
+}
+
+SIDLLEXPORT int siTakeLcdDirty(byte* mask)
+{
+	if (_c)
+	{
+		return computerTakeLcdDirty(_c, mask);
+	}
+	memset(mask, 0, LCD_DIRTY_BYTES);
+	return 0;
+}
+
+SIDLLEXPORT void siEnableEvents(unsigned mask, int capacity)
+{
+	if (_c)
+	{
+		computerEnableEvents(_c, mask, capacity);
+	}
+}
+
+SIDLLEXPORT int siReadEvents(SimEvent* out, int maxEvents)
+{
+	if (_c)
+	{
+		return computerReadEvents(_c, out, maxEvents);
+	}
+	return 0;
+}
@@ -12,7 +12,7 @@
 #ifndef _SIMINST_H_
 #define _SIMINST_H_
 
-#if _EMSCRIPTEN
+#if _EMSCRIPTEN || !_WIN32
 #define SIDLLEXPORT
 #elif SI_COMPILING_DLL
 #define SIDLLEXPORT __declspec(dllexport)
@@ -23,6 +23,8 @@
 #define byte unsigned char
 
 #include "vrEmuLcd.h"
+#include "events.h"
+#include "lcdshadow.h"
 
 typedef enum SIDLLEXPORT
 {
@@ -41,7 +43,52 @@ typedef enum SIDLLEXPORT
 	BU = 12,
 } SIComponent;
 
-
+#define SI_COMPONENTS    13
+#define SI_STATE_VERSION 4
+
+// machine state for front ends, packed so it can be read straight out of
+// memory (eg. as typed array views on the wasm heap) instead of through a
+// call per value. siGetState() refreshes it in place and returns it: call
+// it once per frame, before reading. tick, controlWord, lcdWrites and
+// instructions are also kept current after every call that can change the
+// machine, for polling between refreshes. byte offsets are fixed for a
+// given version:
+//
+//   0   version      SI_STATE_VERSION
+//   4   size         sizeof(SIStateBlock)
+//   8   updates      incremented on every siGetState()
+//   12  tick
+//   16  controlWord
+//   20  lcdWrites    changes whenever the lcd contents may have changed
+//   24  values       siGetValue() of each SIComponent (16 bytes, 13 used)
+//   40  ram          256 bytes
+//   296 pgm          256 bytes
+//   552 instructions instructions fetched (wraps)
+//   556 lcdFlags     SI_LCD_* bits
+//   560 lcdCursor    cell (row * 16 + column) the cursor is on, -1 if none
+typedef struct SIDLLEXPORT
+{
+	unsigned version;
+	unsigned size;
+	unsigned updates;
+	unsigned tick;
+	unsigned controlWord;
+	unsigned lcdWrites;
+	byte values[16];
+	byte ram[256];
+	byte pgm[256];
+	unsigned instructions;
+	unsigned lcdFlags;
+	int lcdCursor;
+} SIStateBlock;
+
+#define SI_LCD_DISPLAY 0x01
+#define SI_LCD_CURSOR  0x02
+#define SI_LCD_BLINK   0x04  // the cursor cell changes over time: redraw it periodically
+
+
+// the rom is rom.hex in the working directory, or the one built in with
+// SI_EMBEDDED_ROM (SimWasm/build.sh)
 SIDLLEXPORT void siInitialise();
 SIDLLEXPORT void siDestroy();
 
@@ -49,8 +96,17 @@ SIDLLEXPORT void siLoadProgram(const char* program);
 
 SIDLLEXPORT void siLoadRam(const char* data);
 
+// binary images rather than hex text (up to 256 bytes)
+SIDLLEXPORT void siLoadProgramBytes(const byte* data, int length);
+
+SIDLLEXPORT void siLoadRamBytes(const byte* data, int length);
+
 SIDLLEXPORT byte siRamByte(int offset);
 
+// replace the microcode (rom.hex text). takes effect at the next instruction
+// fetch, so a running program continues on the new microcode
+SIDLLEXPORT void siLoadRom(const char* rom);
+
 SIDLLEXPORT void siSetInput(byte inputByte);
 
 // set the clock state (1 = high, 0 = low)
@@ -58,11 +114,36 @@ SIDLLEXPORT void siSetClock(int high);
 
 SIDLLEXPORT void siReset();
 
+// run up to the given number of whole clock cycles. stops early on HLT
+// or a breakpoint. returns the number of cycles run
+SIDLLEXPORT unsigned siRun(unsigned cycles);
+
+// scripted input (inputscript.h), applied during siRun(). cycles count from
+// now and from each reset or program load. NULL or "" removes the script.
+// returns 0, or the line number of a malformed line (and no script is set)
+SIDLLEXPORT int siSetInputScript(const char* script);
+
+// select the specialized core (FEATURE_* flags from computer.h)
+SIDLLEXPORT void siSetFeatures(unsigned features);
+
 SIDLLEXPORT byte siGetValue(SIComponent component);
 
 SIDLLEXPORT VrEmuLcd* siGetLcd();
 
 SIDLLEXPORT unsigned siGetControlWord();
 
+// the state block, refreshed. the pointer stays valid until siDestroy()
+SIDLLEXPORT const SIStateBlock* siGetState();
+
+// the lcd cells changed since the last call (computerTakeLcdDirty). mask is
+// LCD_DIRTY_BYTES, a bit per cell. returns how many
+SIDLLEXPORT int siTakeLcdDirty(byte* mask);
+
+// record events (EVENT_MASK() bits) to a bounded queue. mask of 0 disables
+SIDLLEXPORT void siEnableEvents(unsigned mask, int capacity);
+
+// read up to maxEvents queued events into out. returns the number read
+SIDLLEXPORT int siReadEvents(SimEvent* out, int maxEvents);
+
 
 #endif
\ No newline at end of file
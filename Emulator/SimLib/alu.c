@@ -20,6 +20,7 @@ DLLEXPORT ALU* newALU(Bus *b, Register* rb)
 		a->rb = rb;
 		a->carryIn = 0;
 		a->useRb = 0;
+		a->shift = 0;
 		a->flags = 0;
 		a->out = newRegister(b, "ALU");
 		a->mode = INC_A;
@@ -34,9 +35,52 @@ DLLEXPORT void destroyALU(ALU* a)
 }
 
 
+static void shiftTick(ALU* a)
+{
+	byte valA = a->out->bus->value;
+	byte valOut = 0;
+	int carryOut = 0;
+
+	switch (a->mode)
+	{
+		case SHIFT_SHL:
+			valOut = valA << 1;
+			carryOut = valA & 0x80;
+			break;
+
+		case SHIFT_SHR:
+			valOut = valA >> 1;
+			carryOut = valA & 0x01;
+			break;
+
+		case SHIFT_ROL:
+			valOut = (valA << 1) | (valA >> 7);
+			carryOut = valA & 0x80;
+			break;
+
+		case SHIFT_ROR:
+			valOut = (valA >> 1) | (valA << 7);
+			carryOut = valA & 0x01;
+			break;
+
+		default:
+			break;
+	}
+
+	a->flags = ((valOut & 0x80) ? FLAG_NEG : 0) |
+			   ((valOut == 0) ? FLAG_ZERO : 0) |
+			   (carryOut ? FLAG_CARRY : 0);
+
+	setRegisterValue(a->out, valOut);
+}
+
 DLLEXPORT void aluTick(ALU* a)
 {
-	if (a->out->state == ReadFromBus)
+	if (a->out->state == ReadFromBus && a->shift)
+	{
+		shiftTick(a);
+	}
+	else if (a->out->state == ReadFromBus)
 	{
 		byte valA = a->out->bus->value;
 
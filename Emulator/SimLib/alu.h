@@ -29,6 +29,12 @@
 
 #define ALU_ALL   0b111
 
+// shift unit modes (on the alu mode bits when the shift unit is selected)
+#define SHIFT_SHL 0b000
+#define SHIFT_SHR 0b001
+#define SHIFT_ROL 0b010
+#define SHIFT_ROR 0b011
+
 
 #define FLAG_NEG   0b0001
 #define FLAG_OFLOW 0b0010
@@ -41,6 +47,7 @@ typedef struct DLLEXPORT
 	byte mode;
 	int useRb;
 	int carryIn;
+	int shift;     // latch the shift unit output instead
 
 	byte flags;
 
@@ -17,6 +17,16 @@
 #include <memory.h>
 
 DLLEXPORT Computer* newComputer()
+{
+	Computer* c = newComputerWithRom(newRomFromFile("rom.hex"));
+	if (c != NULL)
+	{
+		c->ownsRom = 1;
+	}
+	return c;
+}
+
+DLLEXPORT Computer* newComputerWithRom(Rom* rom)
 {
 	Computer* c = (Computer*)malloc(sizeof(Computer));
 	if (c != NULL)
@@ -33,17 +43,31 @@ DLLEXPORT Computer* newComputer()
 		c->pc = newCounter(c->bus, "PC", 255);
 		c->pc->enabled = 0;
 		c->controlWord = 0;
+		c->fetchPending = 0;
+		c->fetched = 0;
 
-		c->tc = newCounter(c->bus, "Step", 0x07);
+		c->tc = newCounter(c->bus, "Step", (1 << rom->stepBits) - 1);
 
 		c->ram = newRam(c->bus, c->mar, 256);
 		c->pgm = newRam(c->bus, c->mar, 256);
 
     c->alu = newALU(c->bus, c->rb);
     c->lcd = vrEmuLcdNew(16, 2, EmuLcdRomA00);
-    c->rom= newRomFromFile("rom.hex");
+		c->lcdShadow = newLcdShadow(16, 2);
+    c->rom = rom;
+    c->ownsRom = 0;
+    c->nextRom = NULL;
+    c->ownsNextRom = 0;
 
 		c->writingToBus = NULL;
+		c->events = NULL;
+
+		c->breakpoints = NULL;
+		c->breakHit = 0;
+		c->breakSkip = 0;
+		c->lcdWrites = 0;
+		computerResetCounters(c);
+		computerSetFeatures(c, FEATURE_ALL);
 	}
 	return c;
 }
@@ -63,12 +87,43 @@ DLLEXPORT void destroyComputer(Computer* c)
 	destroyRegister(c->mar);
   destroyALU(c->alu);
   vrEmuLcdDestroy(c->lcd);
+	destroyLcdShadow(c->lcdShadow);
   destroyBus(c->bus);
+	if (c->events)
+		destroyEventQueue(c->events);
+	free(c->breakpoints);
+	if (c->ownsRom)
+		destroyRom(c->rom);
+	if (c->nextRom && c->ownsNextRom)
+		destroyRom(c->nextRom);
 	memset(c, sizeof(Computer), 0);
 	free(c);
 }
 
 
+DLLEXPORT void computerSwapRom(Computer* c, Rom* rom, int owns)
+{
+	// a swap still pending is superseded
+	if (c->nextRom && c->ownsNextRom)
+		destroyRom(c->nextRom);
+
+	c->nextRom = rom;
+	c->ownsNextRom = owns;
+}
+
+// called by the tick at step 0, before the control word is read
+static void applyRomSwap(Computer* c)
+{
+	if (c->ownsRom)
+		destroyRom(c->rom);
+
+	c->rom = c->nextRom;
+	c->ownsRom = c->ownsNextRom;
+	c->tc->maxValue = (1 << c->rom->stepBits) - 1;
+	c->nextRom = NULL;
+	c->ownsNextRom = 0;
+}
+
 void setWriting(Computer* c, Register* r)
 {
 	if (c->writingToBus != NULL && c->writingToBus->state == WriteToBus)
@@ -79,26 +134,55 @@ void setWriting(Computer* c, Register* r)
 	r->state = WriteToBus;
 }
 
-DLLEXPORT void loadProgram(Computer* c, const char* hex)
+// hex digit values + 1, 0 for anything else
+static const byte hexDigits[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+// decode up to size bytes from pairs of hex digits. returns the number
+// decoded. a pair that isn't two hex digits reads as its first digit, or 0
+static int decodeHex(const char* hex, byte* out, int size)
 {
-	size_t bytes = strlen(hex) / 2;
-	for (int i = 0; i < bytes; ++i)
+	int n = 0;
+	for (; n < size && hex[0] && hex[1]; hex += 2, ++n)
 	{
-		byte b = 0;
-		sscanf(hex + i * 2, "%02hhX", &b);
-		writeRam(c->pgm, i, b);
+		int high = hexDigits[(byte)hex[0]];
+		int low = hexDigits[(byte)hex[1]];
+		out[n] = !high ? 0 : !low ? (byte)(high - 1) : (byte)((high - 1) << 4 | (low - 1));
 	}
+	return n;
+}
+
+static void loadBytes(Ram* r, const byte* data, int length)
+{
+	if (length > r->size)
+		length = r->size;
+	if (length > 0)
+		memcpy(r->bytes, data, length);
+}
+
+DLLEXPORT void loadProgram(Computer* c, const char* hex)
+{
+	byte bytes[256];
+	loadBytes(c->pgm, bytes, decodeHex(hex, bytes, sizeof(bytes)));
 }
 
 DLLEXPORT void loadRam(Computer* c, const char* hex)
 {
-  size_t bytes = strlen(hex) / 2;
-  for (int i = 0; i < bytes; ++i)
-  {
-    byte b = 0;
-    sscanf(hex + i * 2, "%02hhX", &b);
-    writeRam(c->ram, i, b);
-  }
+	byte bytes[256];
+	loadBytes(c->ram, bytes, decodeHex(hex, bytes, sizeof(bytes)));
+}
+
+DLLEXPORT void loadProgramBytes(Computer* c, const byte* data, int length)
+{
+	loadBytes(c->pgm, data, length);
+}
+
+DLLEXPORT void loadRamBytes(Computer* c, const byte* data, int length)
+{
+	loadBytes(c->ram, data, length);
 }
 
 DLLEXPORT byte ramByte(Computer* c, int offset)
@@ -111,128 +195,146 @@ DLLEXPORT void setInput(Computer* c, byte inputByte)
   setRegisterValue(c->rd, inputByte);
 }
 
+static void emitEvent(Computer* c, EventType type, byte address, byte value)
+{
+	if (c->events)
+	{
+		eventQueuePush(c->events, c->tick, type, address, value);
+	}
+}
+
+// specialized cores. one per combination of FEATURE_* flags
+#define TICK_FEATURES 0x00
+#include "computertick.h"
+#define TICK_FEATURES 0x01
+#include "computertick.h"
+#define TICK_FEATURES 0x02
+#include "computertick.h"
+#define TICK_FEATURES 0x03
+#include "computertick.h"
+#define TICK_FEATURES 0x04
+#include "computertick.h"
+#define TICK_FEATURES 0x05
+#include "computertick.h"
+#define TICK_FEATURES 0x06
+#include "computertick.h"
+#define TICK_FEATURES 0x07
+#include "computertick.h"
+#define TICK_FEATURES 0x08
+#include "computertick.h"
+#define TICK_FEATURES 0x09
+#include "computertick.h"
+#define TICK_FEATURES 0x0a
+#include "computertick.h"
+#define TICK_FEATURES 0x0b
+#include "computertick.h"
+#define TICK_FEATURES 0x0c
+#include "computertick.h"
+#define TICK_FEATURES 0x0d
+#include "computertick.h"
+#define TICK_FEATURES 0x0e
+#include "computertick.h"
+#define TICK_FEATURES 0x0f
+#include "computertick.h"
+#define TICK_FEATURES 0x10
+#include "computertick.h"
+#define TICK_FEATURES 0x11
+#include "computertick.h"
+#define TICK_FEATURES 0x12
+#include "computertick.h"
+#define TICK_FEATURES 0x13
+#include "computertick.h"
+#define TICK_FEATURES 0x14
+#include "computertick.h"
+#define TICK_FEATURES 0x15
+#include "computertick.h"
+#define TICK_FEATURES 0x16
+#include "computertick.h"
+#define TICK_FEATURES 0x17
+#include "computertick.h"
+#define TICK_FEATURES 0x18
+#include "computertick.h"
+#define TICK_FEATURES 0x19
+#include "computertick.h"
+#define TICK_FEATURES 0x1a
+#include "computertick.h"
+#define TICK_FEATURES 0x1b
+#include "computertick.h"
+#define TICK_FEATURES 0x1c
+#include "computertick.h"
+#define TICK_FEATURES 0x1d
+#include "computertick.h"
+#define TICK_FEATURES 0x1e
+#include "computertick.h"
+#define TICK_FEATURES 0x1f
+#include "computertick.h"
+
+#define VARIANT(f) { f, computerTick_##f, computerRun_##f }
+
+static const ComputerVariant variants[FEATURE_VARIANTS] = {
+	VARIANT(0x00), VARIANT(0x01), VARIANT(0x02), VARIANT(0x03),
+	VARIANT(0x04), VARIANT(0x05), VARIANT(0x06), VARIANT(0x07),
+	VARIANT(0x08), VARIANT(0x09), VARIANT(0x0a), VARIANT(0x0b),
+	VARIANT(0x0c), VARIANT(0x0d), VARIANT(0x0e), VARIANT(0x0f),
+	VARIANT(0x10), VARIANT(0x11), VARIANT(0x12), VARIANT(0x13),
+	VARIANT(0x14), VARIANT(0x15), VARIANT(0x16), VARIANT(0x17),
+	VARIANT(0x18), VARIANT(0x19), VARIANT(0x1a), VARIANT(0x1b),
+	VARIANT(0x1c), VARIANT(0x1d), VARIANT(0x1e), VARIANT(0x1f),
+};
+
 DLLEXPORT void computerTick(Computer* c, int high)
 {
-	if (c->controlWord & HLT)
-		return;
+	c->variant->tick(c, high);
+}
+
+DLLEXPORT unsigned computerRun(Computer* c, unsigned cycles)
+{
+	return c->variant->run(c, cycles);
+}
+
+DLLEXPORT void computerSetFeatures(Computer* c, unsigned features)
+{
+	c->variant = &variants[features & (FEATURE_VARIANTS - 1)];
+}
+
+DLLEXPORT unsigned computerGetFeatures(Computer* c)
+{
+	return c->variant->features;
+}
 
-	if (high == 0)
+DLLEXPORT void computerSetBreakpoint(Computer* c, byte address, int enabled)
+{
+	if (c->breakpoints == NULL)
 	{
-		unsigned romAddr = c->ir->value | (c->tc->r->value << 8) | (c->alu->flags << 11);
-		counterCount(c->tc);
-		counterCount(c->pc);
-
-		c->controlWord = *((unsigned*) & (c->rom->bytes[romAddr * 4]));
-		//printf("%u: %u\n", romAddr, c->controlWord);
-
-		c->alu->out->state = (c->controlWord & _ALW) ? Floating : ReadFromBus;
-		c->rd->state = (c->controlWord & _RdW) ? Floating : ReadFromBus;
-		c->rc->state = (c->controlWord & _RcW) ? Floating : ReadFromBus;
-		c->rb->state = (c->controlWord & _RbW) ? Floating : ReadFromBus;
-		c->ra->state = (c->controlWord & _RaW) ? Floating : ReadFromBus;
-		c->sp->state = (c->controlWord & _StPW) ? Floating : ReadFromBus;
-		c->ram->value->state = (c->controlWord & _MW) ? Floating : ((c->controlWord & PGM) ? Floating : ReadFromBus);
-		c->pgm->value->state = (c->controlWord & _MW) ? Floating : ((c->controlWord & PGM) ? ReadFromBus : Floating);
-		c->ir->state = (c->controlWord & _IRW) ? Floating : ReadFromBus;
-		c->pc->r->state = (c->controlWord & _PCW) ? Floating : ReadFromBus;
-		c->mar->state = (c->controlWord & _MAW) ? Floating : ReadFromBus;
-
-		if ((c->controlWord & _TR) == 0)
-		{
-			counterReset(c->tc);
-		}
-
-		c->pc->enabled = (c->controlWord & PCC) ? 1 : 0;
-
-
-
-		switch (c->controlWord & 0x7)
-		{
-		case BW_PC:
-			setWriting(c, c->pc->r);
-			break;
-
-		case BW_MEM:
-			if ((c->controlWord & PGM) != 0)
-			{
-				setWriting(c, c->pgm->value);
-				ramTick(c->pgm);
-			}
-			else
-			{
-				setWriting(c, c->ram->value);
-				ramTick(c->ram);
-			}
-			break;
-
-		case BW_StP:
-			setWriting(c, c->sp);
-			break;
-
-		case BW_Ra:
-			setWriting(c, c->ra);
-			break;
-
-		case BW_Rb:
-			setWriting(c, c->rb);
-			break;
-
-		case BW_Rc:
-			setWriting(c, c->rc);
-			break;
-
-		case BW_Rd:
-			setWriting(c, c->rd);
-			break;
-
-		case BW_ALU:
-			setWriting(c, c->alu->out);
-			break;
-		}
-
-		c->alu->carryIn = (c->controlWord & ALC) ? 1 : 0;
-		c->alu->useRb = (c->controlWord & ALB) ? 1 : 0;
-		c->alu->mode = (c->controlWord & ALS(ALU_ALL)) >> 3;
+		if (!enabled)
+			return;
+
+		c->breakpoints = (byte*)malloc(256);
+		memset(c->breakpoints, 0, 256);
 	}
-	else
+	c->breakpoints[address] = enabled ? 1 : 0;
+}
+
+DLLEXPORT void computerClearBreakpoints(Computer* c)
+{
+	free(c->breakpoints);
+	c->breakpoints = NULL;
+	c->breakHit = 0;
+	c->breakSkip = 0;
+}
+
+DLLEXPORT void computerResume(Computer* c)
+{
+	if (c->breakHit)
 	{
-		if (c->writingToBus)
-		{
-			registerTick(c->writingToBus);
-		}
-
-		aluTick(c->alu);
-
-
-		registerTick(c->ra);
-		registerTick(c->rb);
-		registerTick(c->rc);
-		registerTick(c->rd);
-		registerTick(c->ir);
-		registerTick(c->sp);
-		registerTick(c->ra);
-		registerTick(c->mar);
-		registerTick(c->pc->r);
-
-		if (c->ram->value->state == ReadFromBus)
-			ramTick(c->ram);
-		if (c->pgm->value->state == ReadFromBus)
-			ramTick(c->pgm);
-
-    if (c->controlWord & LCD)
-    {
-      if (c->controlWord & LCD_DATA)
-      {
-        vrEmuLcdWriteByte(c->lcd, c->bus->value);
-      }
-      else
-      {
-        vrEmuLcdSendCommand(c->lcd, c->bus->value);
-      }
-    }
+		c->breakHit = 0;
+		c->breakSkip = 1;
 	}
+}
 
-	++c->tick;
+DLLEXPORT void computerResetCounters(Computer* c)
+{
+	memset(&c->counters, 0, sizeof(c->counters));
 }
 
 
@@ -240,5 +342,55 @@ DLLEXPORT void computerReset(Computer* c)
 {
 	counterReset(c->pc);
 	counterReset(c->tc);
+	c->pc->enabled = 0; // drop an increment pending from the last step
 	c->controlWord = 0;
+	c->fetchPending = 0;
+	c->fetched = 0;
+	c->breakHit = 0;
+}
+
+DLLEXPORT void computerEnableEvents(Computer* c, unsigned mask, int capacity)
+{
+	EventCallback callback = NULL;
+	void* userData = NULL;
+
+	if (c->events)
+	{
+		callback = c->events->callback;
+		userData = c->events->userData;
+		destroyEventQueue(c->events);
+		c->events = NULL;
+	}
+
+	if (mask)
+	{
+		c->events = newEventQueue(mask, capacity);
+		c->events->callback = callback;
+		c->events->userData = userData;
+	}
+}
+
+DLLEXPORT void computerSetEventCallback(Computer* c, EventCallback callback, void* userData)
+{
+	if (c->events == NULL)
+	{
+		computerEnableEvents(c, EVENT_ALL, 0);
+	}
+	c->events->callback = callback;
+	c->events->userData = userData;
+}
+
+DLLEXPORT int computerReadEvents(Computer* c, SimEvent* out, int maxEvents)
+{
+	if (c->events == NULL)
+		return 0;
+
+	return eventQueueRead(c->events, out, maxEvents);
+}
+
+DLLEXPORT int computerTakeLcdDirty(Computer* c, byte* mask)
+{
+	int count = lcdShadowDirtyCells(c->lcdShadow, mask);
+	lcdShadowClearDirty(c->lcdShadow);
+	return count;
 }
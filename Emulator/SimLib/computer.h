@@ -17,6 +17,8 @@
 #include "ram.h"
 #include "rom.h"
 #include "alu.h"
+#include "events.h"
+#include "lcdshadow.h"
 #include "vrEmuLcd.h"
 
 #define uint32_t unsigned
@@ -49,7 +51,7 @@
 #define _MAW ((uint32_t)1 << 19)
 
 #define LCD ((uint32_t)1 << 20)
-//#define RdS ((uint32_t)1 << 21) //Output in signed mode
+#define SHF ((uint32_t)1 << 21) // (emulator only) ALU register takes the shift unit output (SHIFT_* mode)
 
 #define _TR  ((uint32_t)1 << 22) // Reset microcode counter
 #define HLT ((uint32_t)1 << 23) /// Halt
@@ -60,8 +62,45 @@
 
 #define ALS(S) ((uint32_t)S << 3)
 
+// optional core features. each combination is compiled into its own
+// specialized tick function. see computerSetFeatures()
+#define FEATURE_LCD         0x01 // drive the lcd emulator
+#define FEATURE_TRACE       0x02 // event stream (see events.h)
+#define FEATURE_BREAKPOINTS 0x04 // stop before instructions at flagged addresses
+#define FEATURE_COUNTERS    0x08 // cycle/instruction counters
+#define FEATURE_ALL         0x0f
+
+// machine variant (not part of FEATURE_ALL): the next instruction is fetched
+// during the last execute step (the one with _TR) instead of in steps 0 and 1.
+// the fetch has its own path to program memory: IR is loaded from PC after
+// the step's latches and memory writes, MAR is left alone and the step
+// counter continues at the first execute step. steps 0 and 1 only run after
+// a reset. saves 2 cycles per instruction. a breakpoint stops after the
+// instruction has been fetched (IR holds it, PC its address)
+#define FEATURE_PIPELINE    0x10
+#define FEATURE_VARIANTS    0x20 // number of specialized cores
+#define PIPELINE_FIRST_STEP 2
 
 typedef struct DLLEXPORT
+{
+	unsigned long long cycles;        // full clock cycles
+	unsigned long long instructions;  // instructions fetched
+	unsigned long long opcodes[256];  // instructions fetched, by opcode
+} ComputerCounters;
+
+struct Computer_s;
+typedef void (*ComputerTickFn)(struct Computer_s* c, int high);
+typedef unsigned (*ComputerRunFn)(struct Computer_s* c, unsigned cycles);
+
+typedef struct
+{
+	unsigned features;
+	ComputerTickFn tick;
+	ComputerRunFn run;
+} ComputerVariant;
+
+
+typedef struct DLLEXPORT Computer_s
 {
 	unsigned tick;
 	Bus* bus;
@@ -78,19 +117,50 @@ typedef struct DLLEXPORT
 	Ram* pgm;
 	ALU* alu;
   VrEmuLcd *lcd;
+	LcdShadow* lcdShadow;  // fed the lcd's bytes to track changed cells. see computerTakeLcdDirty()
 
 	Rom* rom;
+	int ownsRom; // destroy rom with the computer
+	Rom* nextRom;     // swapped in at the next instruction fetch. see computerSwapRom()
+	int ownsNextRom;
 	unsigned controlWord;
+	int fetchPending;   // FEATURE_PIPELINE: fetch the next instruction on this high edge
+	int fetched;        // FEATURE_PIPELINE: an instruction was fetched on the last high edge
 
 	Register *writingToBus;
+
+	EventQueue* events; // NULL unless events are enabled
+
+	const ComputerVariant* variant; // specialized core for the enabled features
+
+	byte* breakpoints;  // NULL, or 256 flags. non-zero = stop before the instruction at that address
+	int breakHit;       // set when a breakpoint stopped the clock. see computerResume()
+	int breakSkip;      // ignore the breakpoint at the current address once (resuming)
+	unsigned lcdWrites; // lcd generation: commands and data bytes sent (wraps). unchanged = lcd unchanged
+
+	ComputerCounters counters;
 } Computer;
 
 DLLEXPORT Computer* newComputer();
+
+// create a computer using an already loaded microcode rom. the rom can be shared
+// between computers and is not destroyed with them
+DLLEXPORT Computer* newComputerWithRom(Rom* rom);
 DLLEXPORT void destroyComputer(Computer* r);
 
+// replace the microcode rom. the swap happens at the start of the next
+// instruction fetch, so no instruction runs partly on each rom. if owns is set
+// the computer destroys the rom when it is swapped out or destroyed
+DLLEXPORT void computerSwapRom(Computer* c, Rom* rom, int owns);
+
+// hex text, 2 digits per byte from address 0. anything past 256 bytes is ignored
 DLLEXPORT void loadProgram(Computer* c, const char* hex);
 DLLEXPORT void loadRam(Computer* c, const char* data);
 
+// binary images, copied from address 0. anything past 256 bytes is ignored
+DLLEXPORT void loadProgramBytes(Computer* c, const byte* data, int length);
+DLLEXPORT void loadRamBytes(Computer* c, const byte* data, int length);
+
 DLLEXPORT byte ramByte(Computer* c, int offset);
 
 DLLEXPORT void setInput(Computer* c, byte inputByte);
@@ -98,6 +168,39 @@ DLLEXPORT void setInput(Computer* c, byte inputByte);
 // state: 1 = high, 0 = low
 DLLEXPORT void computerTick(Computer* r, int high);
 
+// run up to the given number of whole clock cycles (low then high). stops early
+// on HLT or a breakpoint. returns the number of cycles run
+DLLEXPORT unsigned computerRun(Computer* c, unsigned cycles);
+
+// select the specialized core with the given FEATURE_* flags compiled in.
+// features left out cost nothing (eg. no lcd updates, no event checks).
+// default is FEATURE_ALL. FEATURE_PIPELINE can be added to any combination
+DLLEXPORT void computerSetFeatures(Computer* c, unsigned features);
+DLLEXPORT unsigned computerGetFeatures(Computer* c);
+
+DLLEXPORT void computerSetBreakpoint(Computer* c, byte address, int enabled);
+DLLEXPORT void computerClearBreakpoints(Computer* c);
+
+// continue after a breakpoint was hit
+DLLEXPORT void computerResume(Computer* c);
+
+DLLEXPORT void computerResetCounters(Computer* c);
+
 DLLEXPORT void computerReset(Computer* c);
 
+// record the events in mask (EVENT_MASK() bits) to a queue holding up to capacity events.
+// a mask of 0 disables events entirely
+DLLEXPORT void computerEnableEvents(Computer* c, unsigned mask, int capacity);
+
+// called for each recorded event as it happens (in addition to any queueing)
+DLLEXPORT void computerSetEventCallback(Computer* c, EventCallback callback, void* userData);
+
+// read (and remove) up to maxEvents queued events. returns the number read
+DLLEXPORT int computerReadEvents(Computer* c, SimEvent* out, int maxEvents);
+
+// the lcd cells changed since the last call, a bit per cell (row * 16 +
+// column) in mask (LCD_DIRTY_BYTES). returns how many. only tracked with
+// FEATURE_LCD
+DLLEXPORT int computerTakeLcdDirty(Computer* c, byte* mask);
+
 #endif
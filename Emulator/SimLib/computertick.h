@@ -0,0 +1,282 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// computerTick template
+//
+// included by computer.c once for each combination of FEATURE_* flags, with
+// TICK_FEATURES defined to that combination. each inclusion produces a tick
+// function and a run loop with only the selected features compiled in.
+// no include guard: this file is meant to be included multiple times
+
+#ifndef TICK_FEATURES
+#error "TICK_FEATURES must be defined before including computertick.h"
+#endif
+
+#define TICK_PASTE_(name, f) name##f
+#define TICK_PASTE(name, f) TICK_PASTE_(name, f)
+
+static void TICK_PASTE(computerTick_, TICK_FEATURES)(Computer* c, int high)
+{
+	if (c->controlWord & HLT)
+		return;
+
+#if TICK_FEATURES & FEATURE_BREAKPOINTS
+	if (c->breakHit)
+		return;
+#endif
+
+	if (high == 0)
+	{
+#if TICK_FEATURES & FEATURE_PIPELINE
+		// an instruction fetched on the last high edge starts here. pc holds
+		// its address (the increment past it is still pending)
+		int newInstruction = c->tc->r->value == 0 || c->fetched;
+#else
+		int newInstruction = c->tc->r->value == 0;
+#endif
+
+#if TICK_FEATURES & FEATURE_BREAKPOINTS
+		// about to fetch a new instruction? the program counter may still
+		// have an increment pending from the last step
+		if (c->breakpoints && newInstruction)
+		{
+			byte nextPc = (byte)(c->pc->r->value + (c->pc->enabled ? 1 : 0));
+#if TICK_FEATURES & FEATURE_PIPELINE
+			if (c->fetched)
+				nextPc = c->pc->r->value;
+#endif
+			if (c->breakpoints[nextPc] && !c->breakSkip)
+			{
+				c->breakHit = 1;
+				return;
+			}
+			c->breakSkip = 0;
+		}
+#endif
+
+		if (c->nextRom && newInstruction)
+		{
+			applyRomSwap(c);
+		}
+
+#if TICK_FEATURES & FEATURE_PIPELINE
+		c->fetched = 0;
+#endif
+
+		unsigned romAddr = c->ir->value | (c->tc->r->value << 8) | (c->alu->flags << (8 + c->rom->stepBits));
+		counterCount(c->tc);
+		counterCount(c->pc);
+
+		c->controlWord = *((unsigned*) & (c->rom->bytes[romAddr * 4]));
+		//printf("%u: %u\n", romAddr, c->controlWord);
+
+#if TICK_FEATURES & FEATURE_TRACE
+		if (c->controlWord & HLT)
+		{
+			emitEvent(c, EventHalt, c->pc->r->value, c->rd->value);
+		}
+#endif
+
+		c->alu->out->state = (c->controlWord & _ALW) ? Floating : ReadFromBus;
+		c->rd->state = (c->controlWord & _RdW) ? Floating : ReadFromBus;
+		c->rc->state = (c->controlWord & _RcW) ? Floating : ReadFromBus;
+		c->rb->state = (c->controlWord & _RbW) ? Floating : ReadFromBus;
+		c->ra->state = (c->controlWord & _RaW) ? Floating : ReadFromBus;
+		c->sp->state = (c->controlWord & _StPW) ? Floating : ReadFromBus;
+		c->ram->value->state = (c->controlWord & _MW) ? Floating : ((c->controlWord & PGM) ? Floating : ReadFromBus);
+		c->pgm->value->state = (c->controlWord & _MW) ? Floating : ((c->controlWord & PGM) ? ReadFromBus : Floating);
+		c->ir->state = (c->controlWord & _IRW) ? Floating : ReadFromBus;
+		c->pc->r->state = (c->controlWord & _PCW) ? Floating : ReadFromBus;
+		c->mar->state = (c->controlWord & _MAW) ? Floating : ReadFromBus;
+
+		if ((c->controlWord & _TR) == 0)
+		{
+#if TICK_FEATURES & FEATURE_PIPELINE
+			// the next instruction is fetched alongside this step, so it
+			// starts at its first execute step
+			setRegisterValue(c->tc->r, PIPELINE_FIRST_STEP);
+			c->fetchPending = 1;
+#else
+			counterReset(c->tc);
+#endif
+		}
+
+		c->pc->enabled = (c->controlWord & PCC) ? 1 : 0;
+
+
+
+		switch (c->controlWord & 0x7)
+		{
+		case BW_PC:
+			setWriting(c, c->pc->r);
+			break;
+
+		case BW_MEM:
+			if ((c->controlWord & PGM) != 0)
+			{
+				setWriting(c, c->pgm->value);
+				ramTick(c->pgm);
+			}
+			else
+			{
+				setWriting(c, c->ram->value);
+				ramTick(c->ram);
+			}
+			break;
+
+		case BW_StP:
+			setWriting(c, c->sp);
+			break;
+
+		case BW_Ra:
+			setWriting(c, c->ra);
+			break;
+
+		case BW_Rb:
+			setWriting(c, c->rb);
+			break;
+
+		case BW_Rc:
+			setWriting(c, c->rc);
+			break;
+
+		case BW_Rd:
+			setWriting(c, c->rd);
+			break;
+
+		case BW_ALU:
+			setWriting(c, c->alu->out);
+			break;
+		}
+
+		c->alu->carryIn = (c->controlWord & ALC) ? 1 : 0;
+		c->alu->useRb = (c->controlWord & ALB) ? 1 : 0;
+		c->alu->mode = (c->controlWord & ALS(ALU_ALL)) >> 3;
+		c->alu->shift = (c->controlWord & SHF) ? 1 : 0;
+	}
+	else
+	{
+		if (c->writingToBus)
+		{
+			registerTick(c->writingToBus);
+		}
+
+		aluTick(c->alu);
+
+
+		registerTick(c->ra);
+		registerTick(c->rb);
+		registerTick(c->rc);
+		registerTick(c->rd);
+		registerTick(c->ir);
+		registerTick(c->sp);
+		registerTick(c->ra);
+		registerTick(c->mar);
+		registerTick(c->pc->r);
+
+#if TICK_FEATURES & FEATURE_COUNTERS
+		++c->counters.cycles;
+		if (c->ir->state == ReadFromBus)
+		{
+			++c->counters.instructions;
+			++c->counters.opcodes[c->ir->value];
+		}
+#endif
+
+		if (c->ram->value->state == ReadFromBus)
+			ramTick(c->ram);
+		if (c->pgm->value->state == ReadFromBus)
+		{
+			ramTick(c->pgm);
+#if TICK_FEATURES & FEATURE_TRACE
+			emitEvent(c, EventPgmWrite, c->mar->value, c->bus->value);
+#endif
+		}
+
+#if TICK_FEATURES & FEATURE_TRACE
+		if (c->rd->state == ReadFromBus)
+		{
+			emitEvent(c, EventOutput, c->pc->r->value, c->rd->value);
+		}
+#endif
+
+    if (c->controlWord & LCD)
+    {
+      ++c->lcdWrites;
+      if (c->controlWord & LCD_DATA)
+      {
+#if TICK_FEATURES & FEATURE_LCD
+        vrEmuLcdWriteByte(c->lcd, c->bus->value);
+        lcdShadowData(c->lcdShadow, c->bus->value);
+#endif
+#if TICK_FEATURES & FEATURE_TRACE
+        emitEvent(c, EventLcdData, c->pc->r->value, c->bus->value);
+#endif
+      }
+      else
+      {
+#if TICK_FEATURES & FEATURE_LCD
+        vrEmuLcdSendCommand(c->lcd, c->bus->value);
+        lcdShadowCommand(c->lcdShadow, c->bus->value);
+#endif
+#if TICK_FEATURES & FEATURE_TRACE
+        emitEvent(c, EventLcdCommand, c->pc->r->value, c->bus->value);
+#endif
+      }
+    }
+
+#if TICK_FEATURES & FEATURE_PIPELINE
+		// fetch over the separate instruction path, after this step's latches
+		// and memory writes: a jump in the last step is forwarded to the fetch
+		// and so is an increment still pending from it. the increment past the
+		// fetched byte is left pending, as step 1 (PCC) would
+		if (c->fetchPending)
+		{
+			byte addr = (byte)(c->pc->r->value + (c->pc->enabled ? 1 : 0));
+			setRegisterValue(c->pc->r, addr);
+			c->pc->enabled = 1;
+			setRegisterValue(c->ir, c->pgm->bytes[addr]);
+			c->fetchPending = 0;
+			c->fetched = 1;
+#if TICK_FEATURES & FEATURE_COUNTERS
+			++c->counters.instructions;
+			++c->counters.opcodes[c->ir->value];
+#endif
+		}
+#endif
+	}
+
+	++c->tick;
+}
+
+// run whole clock cycles (low, then high) with the tick above inlined
+static unsigned TICK_PASTE(computerRun_, TICK_FEATURES)(Computer* c, unsigned cycles)
+{
+	unsigned i = 0;
+	for (; i < cycles; ++i)
+	{
+		TICK_PASTE(computerTick_, TICK_FEATURES)(c, 0);
+		TICK_PASTE(computerTick_, TICK_FEATURES)(c, 1);
+
+		if (c->controlWord & HLT)
+			return i + 1;
+
+#if TICK_FEATURES & FEATURE_BREAKPOINTS
+		if (c->breakHit)
+			return i;
+#endif
+	}
+	return i;
+}
+
+#undef TICK_PASTE
+#undef TICK_PASTE_
+#undef TICK_FEATURES
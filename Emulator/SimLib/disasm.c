@@ -0,0 +1,210 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "disasm.h"
+#include "opcodes.h"
+
+#include <string.h>
+
+// format templates, built once from the opcode descriptions. bytes below
+// FMT_LAST are placeholders, expanded to "0xNN" when decoding
+#define FMT_OPERAND1  1
+#define FMT_OPERAND2  2
+#define FMT_OPCODE    3
+#define FMT_LAST      FMT_OPCODE
+
+static char formats[256][DISASM_TEXT_SIZE];
+static int formatsBuilt = 0;
+
+static const char hexDigits[] = "0123456789abcdef";
+
+
+static int isWordChar(char ch)
+{
+	return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+}
+
+// "Imm1", "Imm2", "Imm" or "imm" as a whole word at desc. returns the
+// placeholder and its length, or 0
+static int matchImmediate(const char* desc, int pos, int* length)
+{
+	const char* p = desc + pos;
+	if ((p[0] != 'I' && p[0] != 'i') || p[1] != 'm' || p[2] != 'm')
+		return 0;
+	if (pos > 0 && isWordChar(desc[pos - 1]))
+		return 0;
+
+	int placeholder = FMT_OPERAND1;
+	*length = 3;
+	if (p[3] == '1' || p[3] == '2')
+	{
+		placeholder = p[3] == '1' ? FMT_OPERAND1 : FMT_OPERAND2;
+		*length = 4;
+	}
+	return isWordChar(p[*length]) ? 0 : placeholder;
+}
+
+static void buildFormat(int opcode)
+{
+	const OpcodeInfo* info = &opcodeTable[opcode];
+	char* f = formats[opcode];
+	int len = 0;
+
+	if (info->desc == NULL || strcmp(info->desc, "<Unassigned>") == 0)
+	{
+		f[len++] = 'd';
+		f[len++] = 'b';
+		f[len++] = ' ';
+		f[len++] = FMT_OPCODE;
+		f[len] = '\0';
+		return;
+	}
+
+	int substituted = 0;
+	int insertAt = -1;
+	const char* desc = info->desc;
+	for (int i = 0; desc[i] && len < DISASM_TEXT_SIZE - 1; )
+	{
+		int matchLength = 0;
+		int placeholder = info->operands ? matchImmediate(desc, i, &matchLength) : 0;
+		if (placeholder && placeholder <= info->operands)
+		{
+			f[len++] = (char)placeholder;
+			substituted = 1;
+			i += matchLength;
+			continue;
+		}
+
+		// descriptions without a placeholder get their operands ahead of any
+		// "(...)" explanation: "lod Ra PC (Ra = *PC)" -> "lod Ra PC 0x3c (Ra = *PC)"
+		if (insertAt < 0 && desc[i] == ' ' && desc[i + 1] == '(')
+			insertAt = len;
+		f[len++] = desc[i++];
+	}
+	f[len] = '\0';
+
+	if (info->operands && !substituted)
+	{
+		char tail[DISASM_TEXT_SIZE];
+		if (insertAt < 0)
+			insertAt = len;
+		strcpy(tail, f + insertAt);
+		len = insertAt;
+		for (int op = 1; op <= info->operands; ++op)
+		{
+			f[len++] = ' ';
+			f[len++] = (char)op;
+		}
+		int tailLength = (int)strlen(tail);
+		if (len + tailLength > DISASM_TEXT_SIZE - 1)
+			tailLength = DISASM_TEXT_SIZE - 1 - len;
+		memcpy(f + len, tail, tailLength);
+		f[len + tailLength] = '\0';
+	}
+}
+
+static void buildFormats()
+{
+	for (int opcode = 0; opcode < 256; ++opcode)
+	{
+		buildFormat(opcode);
+	}
+	formatsBuilt = 1;
+}
+
+
+DLLEXPORT const OpcodeInfo* opcodeInfo(byte opcode)
+{
+	return &opcodeTable[opcode];
+}
+
+DLLEXPORT int opcodeLength(byte opcode)
+{
+	return 1 + opcodeTable[opcode].operands;
+}
+
+DLLEXPORT int disassemble(const byte* pgm, byte address, char* out)
+{
+	if (!formatsBuilt)
+		buildFormats();
+
+	byte opcode = pgm[address];
+	for (const char* f = formats[opcode]; *f; ++f)
+	{
+		if ((unsigned char)*f > FMT_LAST)
+		{
+			*out++ = *f;
+			continue;
+		}
+
+		byte value = (*f == FMT_OPCODE) ? opcode : pgm[(byte)(address + *f)];
+		*out++ = '0';
+		*out++ = 'x';
+		*out++ = hexDigits[value >> 4];
+		*out++ = hexDigits[value & 0x0f];
+	}
+	*out = '\0';
+
+	return 1 + opcodeTable[opcode].operands;
+}
+
+DLLEXPORT int disassembleLine(const byte* pgm, byte address, DisasmLine* line)
+{
+	int length = disassemble(pgm, address, line->text);
+	line->address = address;
+	line->length = (byte)length;
+	for (int i = 0; i < length; ++i)
+	{
+		line->bytes[i] = pgm[(byte)(address + i)];
+	}
+	return length;
+}
+
+DLLEXPORT int disassembleProgram(const byte* pgm, DisasmLine* out, int maxLines)
+{
+	int lines = 0;
+	for (int address = 0; address < 256 && lines < maxLines; ++lines)
+	{
+		address += disassembleLine(pgm, (byte)address, &out[lines]);
+	}
+	return lines;
+}
+
+DLLEXPORT int disassembleWindow(const byte* pgm, byte pc, int before, int after, DisasmLine* out, int* pcLine)
+{
+	// instruction starts that end at or before pc, kept in a ring of 'before'
+	byte starts[256];
+	int count = 0;
+	if (before > 256)
+		before = 256;
+	for (int address = 0; before > 0 && address + opcodeLength(pgm[address]) <= pc; )
+	{
+		starts[count++ % before] = (byte)address;
+		address += opcodeLength(pgm[address]);
+	}
+
+	int lines = 0;
+	int first = count > before ? count - before : 0;
+	for (int i = first; i < count; ++i)
+	{
+		disassembleLine(pgm, starts[i % before], &out[lines++]);
+	}
+
+	if (pcLine)
+		*pcLine = lines;
+
+	int address = pc;
+	for (int i = 0; i <= after; ++i)
+	{
+		address += disassembleLine(pgm, (byte)address, &out[lines++]);
+	}
+	return lines;
+}
@@ -0,0 +1,66 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMLIB_DISASM_H_
+#define _SIMLIB_DISASM_H_
+
+#include "simlib.h"
+
+// table driven disassembler
+//
+// the opcode table (opcodes.h) is generated by Arduino/Microcode/MicrocodeTools
+// from the same getControlWord() descriptions the microcode is built from, so
+// mnemonics and operand lengths always match the rom. operands are substituted
+// into the descriptions ("lod Ra Imm (Ra = *Imm)" -> "lod Ra 0x3c (Ra = *0x3c)")
+// and unassigned opcodes decode as data ("db 0x09")
+
+#define DISASM_MAX_LENGTH  3   // opcode + operands
+#define DISASM_TEXT_SIZE   48
+
+typedef struct
+{
+	const char* desc;
+	byte operands;      // operand bytes following the opcode
+} OpcodeInfo;
+
+typedef struct DLLEXPORT
+{
+	byte address;
+	byte length;
+	byte bytes[DISASM_MAX_LENGTH];
+	char text[DISASM_TEXT_SIZE];
+} DisasmLine;
+
+DLLEXPORT const OpcodeInfo* opcodeInfo(byte opcode);
+
+// length in bytes of the instruction starting with opcode
+DLLEXPORT int opcodeLength(byte opcode);
+
+// decode the instruction at address in a 256 byte program image. writes the
+// text to out (DISASM_TEXT_SIZE bytes) and returns the instruction length.
+// operands are read modulo 256, as PC wraps
+DLLEXPORT int disassemble(const byte* pgm, byte address, char* out);
+
+DLLEXPORT int disassembleLine(const byte* pgm, byte address, DisasmLine* line);
+
+// linear sweep of the whole image from address 0. returns the number of lines
+// written to out (at most maxLines, never more than 256)
+DLLEXPORT int disassembleProgram(const byte* pgm, DisasmLine* out, int maxLines);
+
+// up to 'before' instructions ending at or before pc, the instruction at pc and
+// 'after' instructions following it. instruction boundaries before pc come
+// from a sweep from address 0, so a pc that jumped into the middle of an
+// instruction (or data) still decodes from pc itself. returns the number of
+// lines written to out (at most before + 1 + after). *pcLine is set to the
+// index of the line at pc
+DLLEXPORT int disassembleWindow(const byte* pgm, byte pc, int before, int after, DisasmLine* out, int* pcLine);
+
+#endif
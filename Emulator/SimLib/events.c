@@ -0,0 +1,93 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "events.h"
+#include <stdlib.h>
+#include <string.h>
+
+DLLEXPORT EventQueue* newEventQueue(unsigned mask, int capacity)
+{
+	EventQueue* q = (EventQueue*)malloc(sizeof(EventQueue));
+	if (q != NULL)
+	{
+		q->mask = mask;
+		q->capacity = capacity > 0 ? capacity : 0;
+		q->head = 0;
+		q->count = 0;
+		q->dropped = 0;
+		q->events = q->capacity ? (SimEvent*)malloc(q->capacity * sizeof(SimEvent)) : NULL;
+		q->callback = NULL;
+		q->userData = NULL;
+	}
+	return q;
+}
+
+DLLEXPORT void destroyEventQueue(EventQueue* q)
+{
+	free(q->events);
+	free(q);
+}
+
+DLLEXPORT void eventQueuePush(EventQueue* q, unsigned tick, byte type, byte address, byte value)
+{
+	if ((q->mask & EVENT_MASK(type)) == 0)
+		return;
+
+	SimEvent ev;
+	ev.tick = tick;
+	ev.type = type;
+	ev.address = address;
+	ev.value = value;
+	ev.reserved = 0;
+
+	if (q->callback)
+	{
+		q->callback(&ev, q->userData);
+	}
+
+	if (q->capacity == 0)
+		return;
+
+	if (q->count == q->capacity)
+	{
+		// full. overwrite the oldest event so the most recent history is kept
+		q->head = (q->head + 1) % q->capacity;
+		--q->count;
+		++q->dropped;
+	}
+
+	q->events[(q->head + q->count) % q->capacity] = ev;
+	++q->count;
+}
+
+DLLEXPORT int eventQueueRead(EventQueue* q, SimEvent* out, int maxEvents)
+{
+	int n = q->count < maxEvents ? q->count : maxEvents;
+	if (n <= 0)
+		return 0;
+
+	// at most two contiguous runs in the ring
+	int first = q->capacity - q->head;
+	if (first > n) first = n;
+	memcpy(out, q->events + q->head, first * sizeof(SimEvent));
+	memcpy(out + first, q->events, (n - first) * sizeof(SimEvent));
+
+	q->head = (q->head + n) % q->capacity;
+	q->count -= n;
+	return n;
+}
+
+DLLEXPORT void eventQueueClear(EventQueue* q)
+{
+	q->head = 0;
+	q->count = 0;
+	q->dropped = 0;
+}
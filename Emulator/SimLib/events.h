@@ -0,0 +1,66 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMLIB_EVENTS_H_
+#define _SIMLIB_EVENTS_H_
+
+#include "simlib.h"
+
+typedef enum
+{
+	EventOutput     = 0, // Rd latched a value from the bus
+	EventLcdCommand = 1, // byte sent to the lcd command register
+	EventLcdData    = 2, // byte written to lcd ddram/cgram
+	EventHalt       = 3, // HLT control word latched
+	EventPgmWrite   = 4, // program wrote to its own program memory
+} EventType;
+
+#define EVENT_MASK(type) (1u << (type))
+#define EVENT_ALL        0x1f
+
+// 8 bytes, so hosts can walk an array of them directly
+// (eg. from a typed array view over the wasm heap)
+typedef struct DLLEXPORT
+{
+	unsigned tick;  // computer tick the event occurred on
+	byte type;      // EventType
+	byte address;   // PGM address for EventPgmWrite, otherwise the program counter
+	byte value;     // value written (Rd for EventHalt)
+	byte reserved;
+} SimEvent;
+
+typedef void (*EventCallback)(const SimEvent* ev, void* userData);
+
+typedef struct DLLEXPORT
+{
+	unsigned mask;      // EVENT_MASK() bits of the events to record
+	int capacity;       // 0 = callback only
+	int head;           // index of the oldest queued event
+	int count;
+	unsigned dropped;   // events overwritten before they were read
+	SimEvent* events;
+
+	EventCallback callback;
+	void* userData;
+} EventQueue;
+
+DLLEXPORT EventQueue* newEventQueue(unsigned mask, int capacity);
+DLLEXPORT void destroyEventQueue(EventQueue* q);
+
+DLLEXPORT void eventQueuePush(EventQueue* q, unsigned tick, byte type, byte address, byte value);
+
+// copy up to maxEvents of the oldest events to out and remove them from the queue
+// returns the number of events copied
+DLLEXPORT int eventQueueRead(EventQueue* q, SimEvent* out, int maxEvents);
+
+DLLEXPORT void eventQueueClear(EventQueue* q);
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "inputscript.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+static const char* skipSpace(const char* p)
+{
+	while (*p == ' ' || *p == '\t' || *p == '\r')
+		++p;
+	return p;
+}
+
+static int atLineEnd(const char* p)
+{
+	p = skipSpace(p);
+	return *p == '\0' || *p == '\n' || *p == '#';
+}
+
+// unsigned number in the given base. returns the position after it, or NULL
+static const char* parseNumber(const char* p, int base, unsigned long long* out)
+{
+	p = skipSpace(p);
+	char* end;
+	if (!isxdigit((unsigned char)*p))
+		return NULL;
+	*out = strtoull(p, &end, base);
+	return end == p ? NULL : end;
+}
+
+static const char* parseValue(const char* p, byte* out)
+{
+	unsigned long long value;
+	p = parseNumber(p, 16, &value);
+	if (p == NULL || value > 0xff)
+		return NULL;
+	*out = (byte)value;
+	return p;
+}
+
+static int parseTrigger(const char* p, InputTrigger* t)
+{
+	p = skipSpace(p + 2);
+	if (*p++ != '"')
+		return 0;
+
+	int length = 0;
+	while (*p != '"')
+	{
+		if (*p == '\0' || *p == '\n' || length == LCD_LINE_LENGTH)
+			return 0;
+		t->text[length++] = *p++;
+	}
+	t->text[length] = '\0';
+
+	unsigned long long hold = 0;
+	p = parseValue(p + 1, &t->value);
+	if (p != NULL && !atLineEnd(p))
+		p = parseNumber(p, 10, &hold);
+	if (p == NULL || !atLineEnd(p) || length == 0 || hold > 0xffffffffu)
+		return 0;
+
+	t->hold = (unsigned)hold;
+	t->shown = 0;
+	return 1;
+}
+
+DLLEXPORT InputScript* newInputScript(const char* text, int* errorLine)
+{
+	// entries are at most one per line
+	int lines = 1;
+	for (const char* p = text; *p; ++p)
+		lines += *p == '\n';
+
+	InputScript* s = (InputScript*)calloc(1, sizeof(InputScript));
+	s->events = (InputEvent*)malloc(lines * sizeof(InputEvent));
+	s->triggers = (InputTrigger*)malloc(lines * sizeof(InputTrigger));
+
+	int line = 1;
+	for (const char* p = text; *p; ++line)
+	{
+		const char* start = skipSpace(p);
+		int ok = 1;
+		if (atLineEnd(start))
+		{
+		}
+		else if (strncmp(start, "on", 2) == 0 && (start[2] == ' ' || start[2] == '\t'))
+		{
+			ok = parseTrigger(start, &s->triggers[s->triggerCount]);
+			s->triggerCount += ok;
+		}
+		else
+		{
+			InputEvent* e = &s->events[s->eventCount];
+			const char* q = parseNumber(start, 10, &e->cycle);
+			if (q != NULL)
+				q = parseValue(q, &e->value);
+			ok = q != NULL && atLineEnd(q) && (s->eventCount == 0 || e[-1].cycle <= e->cycle);
+			s->eventCount += ok;
+		}
+
+		if (!ok)
+		{
+			if (errorLine)
+				*errorLine = line;
+			destroyInputScript(s);
+			return NULL;
+		}
+
+		while (*p && *p != '\n')
+			++p;
+		if (*p)
+			++p;
+	}
+
+	inputScriptRewind(s);
+	return s;
+}
+
+DLLEXPORT void destroyInputScript(InputScript* s)
+{
+	if (s)
+	{
+		free(s->events);
+		free(s->triggers);
+		free(s);
+	}
+}
+
+DLLEXPORT void inputScriptRewind(InputScript* s)
+{
+	s->cycle = 0;
+	s->next = 0;
+	s->releaseAt = 0;
+	for (int i = 0; i < s->triggerCount; ++i)
+		s->triggers[i].shown = 0;
+}
+
+static int lcdShows(LcdShadow* lcd, const char* text)
+{
+	if (!lcd->displayOn)
+		return 0;
+
+	char row[LCD_LINE_LENGTH + 1];
+	for (int r = 0; r < lcd->height; ++r)
+	{
+		lcdShadowRow(lcd, r, row);
+		if (strstr(row, text))
+			return 1;
+	}
+	return 0;
+}
+
+// everything due at the current cycle
+static void applyDue(InputScript* s, Computer* c, LcdShadow* lcd)
+{
+	while (s->next < s->eventCount && s->events[s->next].cycle <= s->cycle)
+		setInput(c, s->events[s->next++].value);
+
+	if (s->releaseAt && s->releaseAt <= s->cycle)
+	{
+		setInput(c, 0);
+		s->releaseAt = 0;
+	}
+
+	if (lcd && s->cycle % INPUT_TRIGGER_CYCLES == 0)
+	{
+		for (int i = 0; i < s->triggerCount; ++i)
+		{
+			InputTrigger* t = &s->triggers[i];
+			int shown = lcdShows(lcd, t->text);
+			if (shown && !t->shown)
+			{
+				setInput(c, t->value);
+				if (t->hold)
+					s->releaseAt = s->cycle + t->hold;
+			}
+			t->shown = shown;
+		}
+	}
+}
+
+DLLEXPORT unsigned inputScriptRun(InputScript* s, Computer* c, LcdShadow* lcd, unsigned cycles)
+{
+	unsigned done = 0;
+	for (;;)
+	{
+		applyDue(s, c, lcd);
+		if (done == cycles)
+			break;
+
+		// run to whichever comes first: the end, the next event, the end of a
+		// hold or the next trigger check
+		unsigned long long stop = s->cycle + (cycles - done);
+		if (s->next < s->eventCount && s->events[s->next].cycle < stop)
+			stop = s->events[s->next].cycle;
+		if (s->releaseAt && s->releaseAt < stop)
+			stop = s->releaseAt;
+		if (lcd && s->triggerCount)
+		{
+			unsigned long long check = (s->cycle / INPUT_TRIGGER_CYCLES + 1) * INPUT_TRIGGER_CYCLES;
+			if (check < stop)
+				stop = check;
+		}
+
+		unsigned want = (unsigned)(stop - s->cycle);
+		unsigned ran = computerRun(c, want);
+		s->cycle += ran;
+		done += ran;
+		if (ran < want)
+			break;
+	}
+	return done;
+}
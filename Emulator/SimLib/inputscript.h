@@ -0,0 +1,83 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMLIB_INPUTSCRIPT_H_
+#define _SIMLIB_INPUTSCRIPT_H_
+
+#include "simlib.h"
+#include "computer.h"
+#include "lcdshadow.h"
+
+// scripted input (setInput) for headless and repeatable runs
+//
+// a script is text, a line per entry, # to the end of a line is a comment:
+//
+//   <cycle> <value>               set the input (Rd) to value (hex) when
+//                                 cycle whole clock cycles have run
+//   on "<text>" <value> [<hold>]  set the input to value when text appears
+//                                 on the lcd, and back to 00 hold cycles
+//                                 later. fires again once the text has gone
+//                                 and comes back
+//
+// cycles are decimal and count from the start of the run (the reset).
+// timed entries must be in order. eg. snake, turning left at cycle 120000
+// and pressing up whenever it's over:
+//
+//   120000 40
+//   120400 00
+//   on "GAME OVER" 80 2000
+//
+// timed entries are applied at exactly their cycle however the run is
+// batched. lcd text is checked every INPUT_TRIGGER_CYCLES cycles (counted
+// from the start, so also independent of batching)
+
+#define INPUT_TRIGGER_CYCLES 256
+
+typedef struct
+{
+	unsigned long long cycle;
+	byte value;
+} InputEvent;
+
+typedef struct
+{
+	char text[LCD_LINE_LENGTH + 1];
+	byte value;
+	unsigned hold;      // 0 = no release
+	int shown;          // text was on the lcd at the last check
+} InputTrigger;
+
+typedef struct DLLEXPORT
+{
+	InputEvent* events;
+	int eventCount;
+	InputTrigger* triggers;
+	int triggerCount;
+
+	unsigned long long cycle;       // cycles run since inputScriptRewind()
+	int next;                       // next event to apply
+	unsigned long long releaseAt;   // a trigger's hold ends (0 = none)
+} InputScript;
+
+// parse script text. returns NULL on a malformed line, and its line number
+// (from 1) in errorLine if it isn't NULL
+DLLEXPORT InputScript* newInputScript(const char* text, int* errorLine);
+DLLEXPORT void destroyInputScript(InputScript* s);
+
+// back to cycle 0 (call along with computerReset)
+DLLEXPORT void inputScriptRewind(InputScript* s);
+
+// computerRun() up to cycles, stopping at each scripted input to apply it.
+// lcd is the display text the triggers are checked against, NULL to ignore
+// them. returns the number of cycles run
+DLLEXPORT unsigned inputScriptRun(InputScript* s, Computer* c, LcdShadow* lcd, unsigned cycles);
+
+#endif
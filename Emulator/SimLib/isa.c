@@ -0,0 +1,560 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "isa.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// register fields of an opcode: 00/01/10 ddd sss, 11 c mmm rr
+#define REG_RA   0
+#define REG_RB   1
+#define REG_RC   2
+#define REG_RD   3
+#define REG_SP   4
+#define REG_PC   5
+#define REG_ACC  6  // also SP indirect (push/pop) in the lod/sto groups
+#define REG_IMM  7
+
+DLLEXPORT IsaMachine* newIsaMachine()
+{
+	IsaMachine* m = (IsaMachine*)malloc(sizeof(IsaMachine));
+	if (m != NULL)
+	{
+		memset(m, 0, sizeof(IsaMachine));
+	}
+	return m;
+}
+
+DLLEXPORT void destroyIsaMachine(IsaMachine* m)
+{
+	free(m);
+}
+
+static void emit(IsaMachine* m, EventType type, byte address, byte value)
+{
+	if (m->events)
+	{
+		eventQueuePush(m->events, (unsigned)m->instructions, type, address, value);
+	}
+}
+
+// the alu, as latched into Acc: a is the bus, b is Rb (useRb) or the carry
+// in. subtraction carries in unless carryIn is set (a - b, no borrow). the
+// overflow flag is set when the sign differs from the previous Acc
+static byte alu(IsaMachine* m, int mode, byte a, int useRb, int carryIn)
+{
+	int minus = mode == A_MINUS_B || mode == B_MINUS_A;
+	int carry = minus ? 1 - carryIn : carryIn;
+	int b = useRb ? m->rb : carry;
+	int extra = useRb ? carry : 0;
+	int result = 0;
+	int arithmetic = 1;
+
+	switch (mode)
+	{
+	case B_MINUS_A: result = b - (a + extra); break;
+	case A_MINUS_B: result = a - (b + extra); break;
+	case A_PLUS_B:  result = a + b + extra; break;
+	case A_XOR_B:   result = a ^ b; arithmetic = 0; break;
+	case A_OR_B:    result = a | b; arithmetic = 0; break;
+	case A_AND_B:   result = a & b; arithmetic = 0; break;
+	default:        arithmetic = 0; break;
+	}
+
+	byte value = (byte)result;
+	int outOfRange = result < 0 || result > 0xff;
+
+	m->flags = ((value & 0x80) ? FLAG_NEG : 0) |
+	           (value == 0 ? FLAG_ZERO : 0) |
+	           ((outOfRange != minus) ? FLAG_CARRY : 0) |
+	           ((arithmetic && (value & 0x80) != (m->acc & 0x80)) ? FLAG_OFLOW : 0);
+
+	m->acc = value;
+	return value;
+}
+
+// the shift unit. carry is the bit shifted out, overflow is cleared
+static byte shift(IsaMachine* m, int mode, byte a)
+{
+	byte value = 0;
+	int out = 0;
+
+	switch (mode)
+	{
+	case SHIFT_SHL: value = (byte)(a << 1);            out = a & 0x80; break;
+	case SHIFT_SHR: value = a >> 1;                    out = a & 0x01; break;
+	case SHIFT_ROL: value = (byte)((a << 1) | (a >> 7)); out = a & 0x80; break;
+	case SHIFT_ROR: value = (byte)((a >> 1) | (a << 7)); out = a & 0x01; break;
+	}
+
+	m->flags = ((value & 0x80) ? FLAG_NEG : 0) |
+	           (value == 0 ? FLAG_ZERO : 0) |
+	           (out ? FLAG_CARRY : 0);
+
+	m->acc = value;
+	return value;
+}
+
+// a register driving the bus. Imm and SP indirect have no bus driver of
+// their own: their encoding selects the alu
+static byte readReg(IsaMachine* m, int reg)
+{
+	switch (reg)
+	{
+	case REG_RA: return m->ra;
+	case REG_RB: return m->rb;
+	case REG_RC: return m->rc;
+	case REG_RD: return m->rd;
+	case REG_SP: return m->sp;
+	case REG_PC: return m->pc;
+	default:     return m->acc;
+	}
+}
+
+// a register latching the bus. Acc and Imm don't latch
+static void writeReg(IsaMachine* m, int reg, byte value)
+{
+	switch (reg)
+	{
+	case REG_RA: m->ra = value; break;
+	case REG_RB: m->rb = value; break;
+	case REG_RC: m->rc = value; break;
+	case REG_RD: m->rd = value; emit(m, EventOutput, m->pc, value); break;
+	case REG_SP: m->sp = value; break;
+	case REG_PC: m->pc = value; break;
+	}
+}
+
+static byte fetch(IsaMachine* m)
+{
+	return m->pgm[m->pc++];
+}
+
+// program memory is written by sto with Rc as the address and by stoi with
+// two immediates. everything else addresses ram
+static void writePgm(IsaMachine* m, byte address, byte value)
+{
+	m->pgm[address] = value;
+	emit(m, EventPgmWrite, address, value);
+}
+
+static void lcdCommand(IsaMachine* m, byte value)
+{
+	if (m->lcd)
+		vrEmuLcdSendCommand(m->lcd, value);
+	emit(m, EventLcdCommand, m->pc, value);
+}
+
+static void lcdData(IsaMachine* m, byte value)
+{
+	if (m->lcd)
+		vrEmuLcdWriteByte(m->lcd, value);
+	emit(m, EventLcdData, m->pc, value);
+}
+
+static byte decrementSp(IsaMachine* m)
+{
+	m->sp = alu(m, A_MINUS_B, m->sp, 0, 0);
+	return m->sp;
+}
+
+// pop: the value at SP, then SP + 1 (through Acc)
+static byte pop(IsaMachine* m)
+{
+	byte top = m->sp;
+	m->sp = alu(m, A_PLUS_B, m->sp, 0, 1);
+	return m->ram[top];
+}
+
+static int condition(IsaMachine* m, int cond)
+{
+	switch (cond)
+	{
+	case 0: return (m->flags & FLAG_CARRY) != 0;   // jc
+	case 1: return (m->flags & FLAG_ZERO) != 0;    // jz
+	case 2: return (m->flags & FLAG_OFLOW) != 0;   // jo
+	case 4: return (m->flags & FLAG_NEG) != 0;     // jn
+	case 7: return (m->flags & FLAG_CARRY) == 0;   // jnc
+	case 6: return (m->flags & FLAG_ZERO) == 0;    // jnz
+	case 5: return (m->flags & FLAG_OFLOW) == 0;   // jno
+	default: return (m->flags & FLAG_NEG) == 0;    // jnn
+	}
+}
+
+// 00 ddd sss
+static void movGroup(IsaMachine* m, int dest, int src)
+{
+	if (dest == REG_IMM)
+	{
+		byte target = fetch(m);
+		if (condition(m, src))
+			m->pc = target;
+	}
+	else if (src == REG_IMM)
+	{
+		if (dest == REG_ACC)
+		{
+			// clra
+			byte zero = alu(m, A_AND_B, m->pc, 0, 0);
+			m->ra = m->rb = m->rc = m->sp = zero;
+			writeReg(m, REG_RD, zero);
+		}
+		else if (dest == REG_PC)
+		{
+			m->pc = m->pgm[m->pc];
+		}
+		else
+		{
+			writeReg(m, dest, fetch(m));
+		}
+	}
+	else if (dest == REG_ACC)
+	{
+		if (src == REG_PC)
+		{
+			// jmz
+			m->pc = alu(m, A_AND_B, m->pc, 0, 0);
+		}
+		else if (src != REG_ACC)
+		{
+			// tst
+			alu(m, A_PLUS_B, readReg(m, src), 0, 0);
+		}
+	}
+	else if (src != dest)
+	{
+		writeReg(m, dest, readReg(m, src));
+	}
+	else if (dest == REG_PC)
+	{
+		m->halted = 1;
+		emit(m, EventHalt, m->pc, m->rd);
+	}
+	else if (dest != REG_RA && m->shiftUnit)
+	{
+		// shifts of Rb in the "mov X, X" slots
+		static const int modes[] = { 0, SHIFT_SHL, SHIFT_SHR, SHIFT_ROL, SHIFT_ROR };
+		m->rb = shift(m, modes[dest], m->rb);
+	}
+}
+
+// 01 ddd sss
+static void lodGroup(IsaMachine* m, int dest, int src)
+{
+	if (dest == REG_ACC)
+	{
+		if (src < REG_SP)
+		{
+			// peek
+			writeReg(m, src, m->ram[m->sp]);
+		}
+		else
+		{
+			byte address = fetch(m);
+			switch (src)
+			{
+			case REG_SP:  lcdCommand(m, m->ram[address]); break;                      // lcc mem
+			case REG_PC:  lcdData(m, alu(m, A_PLUS_B, m->ram[address], 0, 0)); break; // lcd mem
+			case REG_ACC: lcdCommand(m, alu(m, A_PLUS_B, m->pgm[address], 0, 0)); break; // lcc pgm
+			default:      lcdData(m, m->pgm[address]); break;                         // lcd pgm
+			}
+		}
+	}
+	else if (src == REG_ACC)
+	{
+		if (dest == REG_PC)
+		{
+			// ret: Acc goes through PC and back, and is flagged again
+			byte acc = m->acc;
+			byte value = pop(m);
+			alu(m, A_PLUS_B, acc, 0, 0);
+			m->pc = value;
+		}
+		else if (dest != REG_IMM)
+		{
+			writeReg(m, dest, pop(m));
+		}
+		else
+		{
+			// lcc imm
+			lcdCommand(m, alu(m, A_PLUS_B, fetch(m), 0, 0));
+		}
+	}
+	else if (src == REG_IMM)
+	{
+		if (dest != REG_IMM)
+			writeReg(m, dest, m->ram[fetch(m)]);
+		else
+			lcdData(m, fetch(m));   // lcd imm
+	}
+	else if (dest == REG_IMM)
+	{
+		// clr
+		writeReg(m, src, alu(m, A_AND_B, m->pc, 0, 0));
+	}
+	else
+	{
+		byte address = readReg(m, src);
+		writeReg(m, dest, src == REG_RC ? m->pgm[address] : m->ram[address]);
+	}
+}
+
+// 10 ddd sss
+static void stoGroup(IsaMachine* m, int dest, int src)
+{
+	if (dest == REG_ACC)
+	{
+		if (src == REG_IMM)
+		{
+			// pushi
+			decrementSp(m);
+			m->ram[m->sp] = alu(m, A_PLUS_B, fetch(m), 0, 0);
+		}
+		else if (src == REG_PC)
+		{
+			// call Rc
+			decrementSp(m);
+			m->ram[m->sp] = m->pc;
+			m->pc = m->rc;
+		}
+		else
+		{
+			// push. SP - 1 is already on the bus for SP and Acc
+			decrementSp(m);
+			m->ram[m->sp] = readReg(m, src);
+		}
+	}
+	else if (dest == REG_IMM)
+	{
+		if (src == REG_PC)
+		{
+			// calli
+			decrementSp(m);
+			m->ram[m->sp] = alu(m, A_PLUS_B, m->pc, 0, 1);
+			m->pc = m->pgm[m->pc];
+		}
+		else if (src == REG_IMM)
+		{
+			// stoi: program memory at the second immediate = the first
+			byte value = alu(m, A_PLUS_B, fetch(m), 0, 0);
+			writePgm(m, fetch(m), value);
+		}
+		else
+		{
+			m->ram[fetch(m)] = readReg(m, src);
+		}
+	}
+	else if (src == REG_ACC)
+	{
+		// pop => dest, ret
+		lodGroup(m, dest, REG_ACC);
+	}
+	else
+	{
+		byte address = readReg(m, dest);
+		byte value = readReg(m, src);
+		if (dest == REG_RC)
+			writePgm(m, address, value);
+		else
+			m->ram[address] = value;
+	}
+}
+
+// wide step rom only: one pass of mul or cpy, or a whole add16/sub16.
+// returns 0 for the other alu opcodes
+static int wideOp(IsaMachine* m, byte opcode)
+{
+	switch (opcode)
+	{
+	case 0xe5: // mul: Ra += Rb * Rc, a multiplier bit per pass
+		m->rc = shift(m, SHIFT_SHR, m->rc);
+		m->ra = alu(m, A_PLUS_B, m->ra, (m->flags & FLAG_CARRY) != 0, 0);
+		m->rb = shift(m, SHIFT_SHL, m->rb);
+		break;
+
+	case 0xe9: // cpy: *Rd++ = *Ra++, a byte per pass
+	{
+		byte from = m->ra;
+		byte to = m->rd;
+		m->ra = alu(m, A_PLUS_B, from, 0, 1);
+		m->rb = m->ram[from];
+		writeReg(m, REG_RD, alu(m, A_PLUS_B, to, 0, 1));
+		m->ram[to] = m->rb;
+		m->rc = alu(m, A_MINUS_B, m->rc, 0, 0);
+		break;
+	}
+
+	case 0xf5: // add16
+	case 0xf9: // sub16
+	{
+		int mode = opcode == 0xf5 ? A_PLUS_B : A_MINUS_B;
+		byte src = m->rd;
+		byte dest = m->ra;
+
+		m->rc = alu(m, A_PLUS_B, src, 0, 1);
+		m->rb = m->ram[src];
+		writeReg(m, REG_RD, alu(m, A_PLUS_B, dest, 0, 1));
+		m->ram[dest] = alu(m, mode, m->ram[dest], 1, mode == A_MINUS_B);
+
+		m->rb = m->ram[m->rc];
+		m->ram[m->rd] = alu(m, mode, m->ram[m->rd], 1, (m->flags & FLAG_CARRY) != 0);
+		return 1;
+	}
+
+	default:
+		return 0;
+	}
+
+	// mul and cpy repeat until their count reaches zero
+	if (opcode == 0xe5)
+		alu(m, A_PLUS_B, m->rc, 0, 0);
+	if ((m->flags & FLAG_ZERO) == 0)
+		m->pc = alu(m, A_MINUS_B, m->pc, 0, 0);
+	return 1;
+}
+
+// 11 c mmm rr
+static void aluGroup(IsaMachine* m, byte opcode)
+{
+	int useCarry = (opcode >> 5) & 1;
+	int mode = (opcode >> 2) & 0x7;
+	int reg = opcode & 0x3;
+	int carrySet = (m->flags & FLAG_CARRY) != 0;
+	byte value = readReg(m, reg);
+
+	if (m->wideSteps && wideOp(m, opcode))
+		return;
+
+	switch (mode)
+	{
+	case INC_A:
+		writeReg(m, reg, useCarry ? alu(m, A_MINUS_B, value, 0, 0) : alu(m, A_PLUS_B, value, 0, 1));
+		break;
+
+	case A_PLUS_B:
+		writeReg(m, reg, alu(m, mode, value, 1, useCarry && carrySet));
+		break;
+
+	case A_MINUS_B:
+	case B_MINUS_A:
+		writeReg(m, reg, alu(m, mode, value, 1, !(useCarry && carrySet)));
+		break;
+
+	case A_XOR_B:
+		if (useCarry)
+			lcdCommand(m, value);
+		else
+			writeReg(m, reg, alu(m, mode, value, 1, 0));
+		break;
+
+	case A_OR_B:
+		if (useCarry)
+			alu(m, B_MINUS_A, value, 1, 1);   // cmp Rb, reg
+		else
+			writeReg(m, reg, alu(m, mode, value, 1, 0));
+		break;
+
+	case A_AND_B:
+		if (useCarry)
+			alu(m, A_MINUS_B, value, 1, 1);   // cmp reg, Rb
+		else
+			writeReg(m, reg, alu(m, mode, value, 1, 0));
+		break;
+
+	case NOT_A:
+		if (useCarry)
+			lcdData(m, value);
+		else
+			writeReg(m, reg, alu(m, B_MINUS_A, value, 1, 0));
+		break;
+	}
+}
+
+DLLEXPORT int isaStep(IsaMachine* m)
+{
+	if (m->halted)
+		return 0;
+
+	byte opcode = fetch(m);
+	int dest = (opcode >> 3) & 0x7;
+	int src = opcode & 0x7;
+
+	switch (opcode >> 6)
+	{
+	case 0: movGroup(m, dest, src); break;
+	case 1: lodGroup(m, dest, src); break;
+	case 2: stoGroup(m, dest, src); break;
+	case 3: aluGroup(m, opcode); break;
+	}
+
+	++m->instructions;
+	return 1;
+}
+
+DLLEXPORT unsigned isaRun(IsaMachine* m, unsigned instructions)
+{
+	unsigned i = 0;
+	while (i < instructions && isaStep(m))
+		++i;
+	return i;
+}
+
+DLLEXPORT void isaCopyFromComputer(IsaMachine* m, Computer* c)
+{
+	m->ra = c->ra->value;
+	m->rb = c->rb->value;
+	m->rc = c->rc->value;
+	m->rd = c->rd->value;
+	m->sp = c->sp->value;
+	m->acc = c->alu->out->value;
+	m->flags = c->alu->flags;
+
+	// an increment left pending by the last step is still to be counted. on
+	// the pipelined machine, one is pending past the fetched instruction
+	m->pc = (byte)(c->pc->r->value + (c->pc->enabled ? 1 : 0));
+	if (c->fetched)
+		m->pc = c->pc->r->value;
+
+	m->halted = (c->controlWord & HLT) ? 1 : 0;
+	m->wideSteps = c->rom->stepBits == ROM_WIDE_STEP_BITS;
+	m->shiftUnit = isaRomHasShiftUnit(c->rom);
+
+	memcpy(m->ram, c->ram->bytes, sizeof(m->ram));
+	memcpy(m->pgm, c->pgm->bytes, sizeof(m->pgm));
+}
+
+DLLEXPORT int isaRomHasShiftUnit(Rom* r)
+{
+	// shl Rb (09) latches the shift unit in its first execute step
+	unsigned address = 0x09 | (2 << 8);
+	unsigned controlWord = 0;
+	if ((int)(address * 4 + 4) <= r->size)
+		memcpy(&controlWord, r->bytes + address * 4, sizeof(controlWord));
+	return (controlWord & SHF) != 0;
+}
+
+DLLEXPORT void isaCopyToComputer(IsaMachine* m, Computer* c)
+{
+	computerReset(c);
+
+	setRegisterValue(c->ra, m->ra);
+	setRegisterValue(c->rb, m->rb);
+	setRegisterValue(c->rc, m->rc);
+	setRegisterValue(c->rd, m->rd);
+	setRegisterValue(c->sp, m->sp);
+	setRegisterValue(c->alu->out, m->acc);
+	setRegisterValue(c->pc->r, m->pc);
+	c->alu->flags = m->flags;
+
+	memcpy(c->ram->bytes, m->ram, sizeof(m->ram));
+	memcpy(c->pgm->bytes, m->pgm, sizeof(m->pgm));
+}
@@ -0,0 +1,75 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMLIB_ISA_H_
+#define _SIMLIB_ISA_H_
+
+#include "simlib.h"
+#include "computer.h"
+
+// instruction level reference interpreter
+//
+// runs each instruction's architectural effect directly, without the
+// microcode rom: registers, Acc (the alu register, which mov/jmp/push can
+// read), flags, ram, program memory and the lcd. it is written from the
+// instruction set, not from the rom, so it also serves as an oracle for the
+// microcode (see SimBench/simfuzz). side effects of the microcode that a
+// program can observe are part of the architecture and are reproduced here:
+// eg. push/pop/call leave SP -/+ 1 in Acc with its flags, and the
+// overflow flag compares the sign of an alu result with the previous Acc.
+// MAR, IR and the bus are not architectural and are not modelled
+//
+// events (events.h) are the same as the microcode core's, with the
+// instruction count in place of the tick
+
+typedef struct DLLEXPORT
+{
+	byte ra, rb, rc, rd, sp;
+	byte pc;        // address of the next instruction
+	byte acc;
+	byte flags;     // FLAG_* (alu.h)
+
+	byte ram[256];
+	byte pgm[256];
+
+	int halted;
+	int wideSteps;  // execute the wide step rom's mul, cpy, add16 and sub16 (rom.h)
+	int shiftUnit;  // execute the shift unit rom's shl/shr/rlc/rrc Rb, else they do nothing
+
+	unsigned long long instructions;
+
+	VrEmuLcd* lcd;       // NULL = no lcd
+	EventQueue* events;  // NULL = no events
+} IsaMachine;
+
+DLLEXPORT IsaMachine* newIsaMachine();
+DLLEXPORT void destroyIsaMachine(IsaMachine* m);
+
+// run one instruction. returns 0 (and does nothing) once halted
+DLLEXPORT int isaStep(IsaMachine* m);
+
+// run up to the given number of instructions. stops early on hlt.
+// returns the number of instructions run
+DLLEXPORT unsigned isaRun(IsaMachine* m, unsigned instructions);
+
+// architectural state of a computer stopped between instructions (after
+// computerRun() returned on an instruction boundary, a breakpoint or a
+// halt). lcd and events are left alone
+DLLEXPORT void isaCopyFromComputer(IsaMachine* m, Computer* c);
+
+// whether a rom has the shift unit instructions (MicrocodeTools -s): on the
+// standard rom, as on the EEPROMs, their "mov X, X" opcodes do nothing
+DLLEXPORT int isaRomHasShiftUnit(Rom* r);
+
+// put a computer at the start of the machine's next instruction
+DLLEXPORT void isaCopyToComputer(IsaMachine* m, Computer* c);
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#include "lcdshadow.h"
+#include "vrEmuLcd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CMD_CLEAR          0x01
+#define CMD_HOME           0x02
+#define CMD_ENTRY_MODE     0x04
+#define CMD_DISPLAY        0x08
+#define CMD_SHIFT          0x10
+#define CMD_FUNCTION       0x20
+#define CMD_SET_CGRAM_ADDR 0x40
+#define CMD_SET_DDRAM_ADDR 0x80
+
+#define LINE2_OFFSET       0x40
+
+// a ddram (0-127) or cgram (128-191) byte's share of the frame hash. the
+// shares are summed, so a write changes the sum by the difference
+static unsigned contentHash(int address, byte value)
+{
+	unsigned h = value * 0x9e3779b1u ^ (unsigned)(address + 1) * 0x85ebca77u;
+	h ^= h >> 15;
+	h *= 0x2c1b3c6du;
+	return h ^ (h >> 12);
+}
+
+static void setContent(LcdShadow* s, int address, byte* at, byte value)
+{
+	if (!s->contentStale)
+		s->contentSum += contentHash(address, value) - contentHash(address, *at);
+	*at = value;
+}
+
+DLLEXPORT LcdShadow* newLcdShadow(int width, int height)
+{
+	LcdShadow* s = (LcdShadow*)malloc(sizeof(LcdShadow));
+	if (s != NULL)
+	{
+		s->width = width;
+		s->height = height;
+		memset(s->cgram, 0, sizeof(s->cgram));
+		lcdShadowReset(s);
+	}
+	return s;
+}
+
+DLLEXPORT void destroyLcdShadow(LcdShadow* s)
+{
+	free(s);
+}
+
+DLLEXPORT void lcdShadowReset(LcdShadow* s)
+{
+	memset(s->ddram, ' ', sizeof(s->ddram));
+	s->address = 0;
+	s->cgramMode = 0;
+	s->increment = 1;
+	s->shiftOnWrite = 0;
+	s->scroll = 0;
+	s->displayOn = 0;
+	s->cursorOn = 0;
+	s->blinkOn = 0;
+	memset(s->dirty, 0, sizeof(s->dirty));
+	s->dirtyAll = 1;
+	s->contentStale = 1;
+}
+
+static void markDirty(LcdShadow* s, int address)
+{
+	s->dirty[(address >> 3) & (sizeof(s->dirty) - 1)] |= (byte)(1 << (address & 7));
+}
+
+// the cell under the cursor changes when it moves or is shown or hidden
+static void markCursor(LcdShadow* s)
+{
+	if (!s->cgramMode && (s->cursorOn || s->blinkOn))
+	{
+		markDirty(s, s->address);
+	}
+}
+
+// cells showing a cgram character (codes 0-15) change with its pattern
+static void markCharacter(LcdShadow* s, int character)
+{
+	for (int i = 0; i < LCD_DDRAM_SIZE; ++i)
+	{
+		if (s->ddram[i] < 16 && (s->ddram[i] & 7) == character)
+		{
+			markDirty(s, i);
+		}
+	}
+}
+
+// step the ddram address counter. the two lines are 0x00-0x27 and 0x40-0x67
+static int nextDdramAddress(int address, int delta)
+{
+	address += delta;
+	if (delta > 0)
+	{
+		if (address == LCD_LINE_LENGTH) address = LINE2_OFFSET;
+		else if (address >= LINE2_OFFSET + LCD_LINE_LENGTH) address = 0;
+	}
+	else
+	{
+		if (address < 0) address = LINE2_OFFSET + LCD_LINE_LENGTH - 1;
+		else if (address == LINE2_OFFSET - 1) address = LCD_LINE_LENGTH - 1;
+	}
+	return address;
+}
+
+static void scrollDisplay(LcdShadow* s, int delta)
+{
+	s->scroll = (s->scroll + delta + LCD_LINE_LENGTH) % LCD_LINE_LENGTH;
+}
+
+DLLEXPORT void lcdShadowCommand(LcdShadow* s, byte command)
+{
+	markCursor(s);
+	if (command & CMD_SET_DDRAM_ADDR)
+	{
+		s->address = command & 0x7f;
+		s->cgramMode = 0;
+	}
+	else if (command & CMD_SET_CGRAM_ADDR)
+	{
+		s->address = command & 0x3f;
+		s->cgramMode = 1;
+	}
+	else if (command & CMD_FUNCTION)
+	{
+		// interface width, lines and font are fixed
+	}
+	else if (command & CMD_SHIFT)
+	{
+		int delta = (command & 0x04) ? 1 : -1;
+		if (command & 0x08)
+		{
+			scrollDisplay(s, -delta);
+			s->dirtyAll = 1;
+		}
+		else if (s->cgramMode)
+			s->address = (s->address + delta) & (LCD_CGRAM_SIZE - 1);
+		else
+			s->address = nextDdramAddress(s->address, delta);
+	}
+	else if (command & CMD_DISPLAY)
+	{
+		if (s->displayOn != ((command & 0x04) ? 1 : 0))
+			s->dirtyAll = 1;
+		s->displayOn = (command & 0x04) ? 1 : 0;
+		s->cursorOn = (command & 0x02) ? 1 : 0;
+		s->blinkOn = (command & 0x01) ? 1 : 0;
+	}
+	else if (command & CMD_ENTRY_MODE)
+	{
+		s->increment = (command & 0x02) ? 1 : -1;
+		s->shiftOnWrite = (command & 0x01) ? 1 : 0;
+	}
+	else if (command & CMD_HOME)
+	{
+		s->address = 0;
+		s->cgramMode = 0;
+		if (s->scroll != 0)
+			s->dirtyAll = 1;
+		s->scroll = 0;
+	}
+	else if (command & CMD_CLEAR)
+	{
+		memset(s->ddram, ' ', sizeof(s->ddram));
+		s->address = 0;
+		s->cgramMode = 0;
+		s->increment = 1;
+		s->scroll = 0;
+		s->dirtyAll = 1;
+		s->contentStale = 1;
+	}
+	markCursor(s);
+}
+
+DLLEXPORT void lcdShadowData(LcdShadow* s, byte data)
+{
+	if (s->cgramMode)
+	{
+		if (s->cgram[s->address] != data)
+			markCharacter(s, s->address >> 3);
+		setContent(s, LCD_DDRAM_SIZE + s->address, &s->cgram[s->address], data);
+		s->address = (s->address + s->increment) & (LCD_CGRAM_SIZE - 1);
+		return;
+	}
+
+	markCursor(s);
+	if (s->ddram[s->address] != data)
+		markDirty(s, s->address);
+	setContent(s, s->address, &s->ddram[s->address], data);
+	s->address = nextDdramAddress(s->address, s->increment);
+	if (s->shiftOnWrite)
+	{
+		scrollDisplay(s, s->increment);
+		s->dirtyAll = 1;
+	}
+	markCursor(s);
+}
+
+DLLEXPORT void lcdShadowRow(LcdShadow* s, int row, char* out)
+{
+	int offset = (row & 1) ? LINE2_OFFSET : 0;
+	for (int i = 0; i < s->width; ++i)
+	{
+		out[i] = (char)s->ddram[offset + (s->scroll + i) % LCD_LINE_LENGTH];
+	}
+	out[s->width] = '\0';
+}
+
+DLLEXPORT int lcdShadowDirtyCells(LcdShadow* s, byte* mask)
+{
+	int count = 0;
+	memset(mask, 0, LCD_DIRTY_BYTES);
+	for (int row = 0; row < s->height; ++row)
+	{
+		int offset = (row & 1) ? LINE2_OFFSET : 0;
+		for (int i = 0; i < s->width; ++i)
+		{
+			int address = offset + (s->scroll + i) % LCD_LINE_LENGTH;
+			int cell = row * s->width + i;
+			if (cell < LCD_MAX_CELLS && (s->dirtyAll || (s->dirty[address >> 3] & (1 << (address & 7)))))
+			{
+				mask[cell >> 3] |= (byte)(1 << (cell & 7));
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+DLLEXPORT void lcdShadowClearDirty(LcdShadow* s)
+{
+	memset(s->dirty, 0, sizeof(s->dirty));
+	s->dirtyAll = 0;
+}
+
+DLLEXPORT int lcdShadowCursorCell(LcdShadow* s)
+{
+	if (s->cgramMode)
+		return -1;
+
+	int row = s->address >= LINE2_OFFSET ? 1 : 0;
+	int column = (s->address - row * LINE2_OFFSET - s->scroll + LCD_LINE_LENGTH) % LCD_LINE_LENGTH;
+	if (row >= s->height || column >= s->width)
+		return -1;
+	return row * s->width + column;
+}
+
+DLLEXPORT unsigned lcdShadowFrameHash(LcdShadow* s)
+{
+	if (s->contentStale)
+	{
+		s->contentSum = 0;
+		for (int i = 0; i < LCD_DDRAM_SIZE; ++i)
+			s->contentSum += contentHash(i, s->ddram[i]);
+		for (int i = 0; i < LCD_CGRAM_SIZE; ++i)
+			s->contentSum += contentHash(LCD_DDRAM_SIZE + i, s->cgram[i]);
+		s->contentStale = 0;
+	}
+
+	unsigned h = s->contentSum ^ (unsigned)s->scroll * 0x27d4eb2fu ^ (s->displayOn ? 0x165667b1u : 0);
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	return h ^ (h >> 13);
+}
+
+DLLEXPORT void lcdShadowPixels(LcdShadow* s, byte* out)
+{
+	VrEmuLcd* lcd = vrEmuLcdNew(s->width, s->height, EmuLcdRomA00);
+
+	vrEmuLcdSendCommand(lcd, CMD_SET_CGRAM_ADDR);
+	for (int i = 0; i < LCD_CGRAM_SIZE; ++i)
+		vrEmuLcdWriteByte(lcd, s->cgram[i]);
+
+	for (int row = 0; row < 2; ++row)
+	{
+		int offset = row ? LINE2_OFFSET : 0;
+		vrEmuLcdSendCommand(lcd, (byte)(CMD_SET_DDRAM_ADDR | offset));
+		for (int i = 0; i < LCD_LINE_LENGTH; ++i)
+			vrEmuLcdWriteByte(lcd, s->ddram[offset + i]);
+	}
+
+	// display shift left, once per column scrolled
+	for (int i = 0; i < s->scroll; ++i)
+		vrEmuLcdSendCommand(lcd, CMD_SHIFT | 0x08);
+	vrEmuLcdSendCommand(lcd, (byte)(CMD_DISPLAY | (s->displayOn ? 0x04 : 0)));
+
+	vrEmuLcdUpdatePixels(lcd);
+	int width = LCD_PIXELS_X(s->width);
+	int height = LCD_PIXELS_Y(s->height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+			*out++ = vrEmuLcdPixelState(lcd, x, y) == 1;
+	}
+
+	vrEmuLcdDestroy(lcd);
+}
@@ -0,0 +1,92 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+#ifndef _SIMLIB_LCDSHADOW_H_
+#define _SIMLIB_LCDSHADOW_H_
+
+#include "simlib.h"
+
+// a side-effect free model of the HD44780 display memory
+//
+// fed the same command/data bytes as the lcd (eg. from EventLcdCommand and
+// EventLcdData events) so hosts can read the display text without going
+// through the lcd's own read path, which moves its address counter.
+//
+// it also tracks which display cells have changed (text, cgram characters
+// in use, the cursor, scrolling) so a host can redraw only those
+
+#define LCD_DDRAM_SIZE   128
+#define LCD_CGRAM_SIZE   64
+#define LCD_LINE_LENGTH  40  // ddram bytes per display line
+#define LCD_MAX_CELLS    (LCD_LINE_LENGTH * 2)
+#define LCD_DIRTY_BYTES  (LCD_MAX_CELLS / 8)
+
+typedef struct DLLEXPORT
+{
+	int width;
+	int height;
+
+	byte ddram[LCD_DDRAM_SIZE];
+	byte cgram[LCD_CGRAM_SIZE];
+
+	int address;        // address counter
+	int cgramMode;      // address counter points at cgram rather than ddram
+	int increment;      // entry mode: 1 or -1
+	int shiftOnWrite;   // entry mode: shift the display on each write
+	int scroll;         // ddram column shown at the left of the display
+
+	int displayOn;
+	int cursorOn;
+	int blinkOn;
+
+	byte dirty[LCD_DDRAM_SIZE / 8];  // ddram addresses changed, a bit each
+	int dirtyAll;                    // every cell (scrolled, cleared, display on/off)
+
+	unsigned contentSum;             // lcdShadowFrameHash: ddram and cgram bytes, hashed and summed
+	int contentStale;                // recompute contentSum (cleared, reset)
+} LcdShadow;
+
+DLLEXPORT LcdShadow* newLcdShadow(int width, int height);
+DLLEXPORT void destroyLcdShadow(LcdShadow* s);
+
+DLLEXPORT void lcdShadowReset(LcdShadow* s);
+
+DLLEXPORT void lcdShadowCommand(LcdShadow* s, byte command);
+DLLEXPORT void lcdShadowData(LcdShadow* s, byte data);
+
+// copy the visible characters of a row to out (width bytes + terminator).
+// bytes are raw character codes (0-7 are the cgram characters)
+DLLEXPORT void lcdShadowRow(LcdShadow* s, int row, char* out);
+
+// the visible cells changed since the last lcdShadowClearDirty, a bit per
+// cell (row * width + column) in mask (LCD_DIRTY_BYTES). returns how many
+DLLEXPORT int lcdShadowDirtyCells(LcdShadow* s, byte* mask);
+DLLEXPORT void lcdShadowClearDirty(LcdShadow* s);
+
+// the visible cell (row * width + column) at the address counter, where the
+// cursor is drawn, or -1
+DLLEXPORT int lcdShadowCursorCell(LcdShadow* s);
+
+// 32-bit hash of the display contents: ddram, cgram, scroll and display on
+// or off. it changes whenever any of them do, so a run's lcd output can be
+// checked by its sequence of frame hashes. the cursor is left out. kept up
+// to date by each write, so it's cheap enough to call after every one
+DLLEXPORT unsigned lcdShadowFrameHash(LcdShadow* s);
+
+// the display as pixels, cgram characters included and the cursor left out:
+// LCD_PIXELS_X(width) by LCD_PIXELS_Y(height), a byte each (1 = on), rows
+// from the top. drawn by a vrEmuLcd loaded with the shadow's contents, so
+// they match the emulator's lcd
+#define LCD_PIXELS_X(width)  ((width) * 6 - 1)
+#define LCD_PIXELS_Y(height) ((height) * 9 - 1)
+DLLEXPORT void lcdShadowPixels(LcdShadow* s, byte* out);
+
+#endif
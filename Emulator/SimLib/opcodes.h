@@ -0,0 +1,278 @@
+/*
+ * Troy's 8-bit computer - Emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// generated by Arduino/Microcode/MicrocodeTools. do not edit
+
+#ifndef _SIMLIB_OPCODES_H_
+#define _SIMLIB_OPCODES_H_
+
+#include "disasm.h"
+
+static const OpcodeInfo opcodeTable[256] = {
+  /* 00 */ { "nop", 0 },
+  /* 01 */ { "mov Ra Rb", 0 },
+  /* 02 */ { "mov Ra Rc", 0 },
+  /* 03 */ { "mov Ra Rd", 0 },
+  /* 04 */ { "mov Ra SP", 0 },
+  /* 05 */ { "mov Ra PC", 0 },
+  /* 06 */ { "mov Ra Acc", 0 },
+  /* 07 */ { "movi Ra, Imm", 1 },
+  /* 08 */ { "mov Rb Ra", 0 },
+  /* 09 */ { "<Unassigned>", 0 },
+  /* 0a */ { "mov Rb Rc", 0 },
+  /* 0b */ { "mov Rb Rd", 0 },
+  /* 0c */ { "mov Rb SP", 0 },
+  /* 0d */ { "mov Rb PC", 0 },
+  /* 0e */ { "mov Rb Acc", 0 },
+  /* 0f */ { "movi Rb, Imm", 1 },
+  /* 10 */ { "mov Rc Ra", 0 },
+  /* 11 */ { "mov Rc Rb", 0 },
+  /* 12 */ { "<Unassigned>", 0 },
+  /* 13 */ { "mov Rc Rd", 0 },
+  /* 14 */ { "mov Rc SP", 0 },
+  /* 15 */ { "mov Rc PC", 0 },
+  /* 16 */ { "mov Rc Acc", 0 },
+  /* 17 */ { "movi Rc, Imm", 1 },
+  /* 18 */ { "mov Rd Ra", 0 },
+  /* 19 */ { "mov Rd Rb", 0 },
+  /* 1a */ { "mov Rd Rc", 0 },
+  /* 1b */ { "<Unassigned>", 0 },
+  /* 1c */ { "mov Rd SP", 0 },
+  /* 1d */ { "mov Rd PC", 0 },
+  /* 1e */ { "mov Rd Acc", 0 },
+  /* 1f */ { "movi Rd, Imm", 1 },
+  /* 20 */ { "mov SP Ra", 0 },
+  /* 21 */ { "mov SP Rb", 0 },
+  /* 22 */ { "mov SP Rc", 0 },
+  /* 23 */ { "mov SP Rd", 0 },
+  /* 24 */ { "<Unassigned>", 0 },
+  /* 25 */ { "mov SP PC", 0 },
+  /* 26 */ { "mov SP Acc", 0 },
+  /* 27 */ { "movi SP, Imm", 1 },
+  /* 28 */ { "jmp Ra", 0 },
+  /* 29 */ { "jmp Rb", 0 },
+  /* 2a */ { "jmp Rc", 0 },
+  /* 2b */ { "jmp Rd", 0 },
+  /* 2c */ { "jmp SP", 0 },
+  /* 2d */ { "hlt", 0 },
+  /* 2e */ { "jmp Acc", 0 },
+  /* 2f */ { "jmpi Imm", 1 },
+  /* 30 */ { "tst Ra", 0 },
+  /* 31 */ { "tst Rb", 0 },
+  /* 32 */ { "tst Rc", 0 },
+  /* 33 */ { "tst Rd", 0 },
+  /* 34 */ { "tst SP", 0 },
+  /* 35 */ { "jmz", 0 },
+  /* 36 */ { "<Unassigned>", 0 },
+  /* 37 */ { "clra", 0 },
+  /* 38 */ { "jc", 1 },
+  /* 39 */ { "jz", 1 },
+  /* 3a */ { "jo", 1 },
+  /* 3b */ { "jnn", 1 },
+  /* 3c */ { "jn", 1 },
+  /* 3d */ { "jno", 1 },
+  /* 3e */ { "jnz", 1 },
+  /* 3f */ { "jnc", 1 },
+  /* 40 */ { "lod Ra Ra (Ra = *Ra)", 0 },
+  /* 41 */ { "lod Ra Rb (Ra = *Rb)", 0 },
+  /* 42 */ { "lod Ra Rc (Ra = PGM*Rc)", 0 },
+  /* 43 */ { "lod Ra Rd (Ra = *Rd)", 0 },
+  /* 44 */ { "lod Ra SP (Ra = *SP)", 0 },
+  /* 45 */ { "lod Ra PC (Ra = *PC)", 1 },
+  /* 46 */ { "pop Ra", 0 },
+  /* 47 */ { "lod Ra Imm (Ra = *Imm)", 1 },
+  /* 48 */ { "lod Rb Ra (Rb = *Ra)", 0 },
+  /* 49 */ { "lod Rb Rb (Rb = *Rb)", 0 },
+  /* 4a */ { "lod Rb Rc (Rb = PGM*Rc)", 0 },
+  /* 4b */ { "lod Rb Rd (Rb = *Rd)", 0 },
+  /* 4c */ { "lod Rb SP (Rb = *SP)", 0 },
+  /* 4d */ { "lod Rb PC (Rb = *PC)", 1 },
+  /* 4e */ { "pop Rb", 0 },
+  /* 4f */ { "lod Rb Imm (Rb = *Imm)", 1 },
+  /* 50 */ { "lod Rc Ra (Rc = *Ra)", 0 },
+  /* 51 */ { "lod Rc Rb (Rc = *Rb)", 0 },
+  /* 52 */ { "lod Rc Rc (Rc = PGM*Rc)", 0 },
+  /* 53 */ { "lod Rc Rd (Rc = *Rd)", 0 },
+  /* 54 */ { "lod Rc SP (Rc = *SP)", 0 },
+  /* 55 */ { "lod Rc PC (Rc = *PC)", 1 },
+  /* 56 */ { "pop Rc", 0 },
+  /* 57 */ { "lod Rc Imm (Rc = *Imm)", 1 },
+  /* 58 */ { "lod Rd Ra (Rd = *Ra)", 0 },
+  /* 59 */ { "lod Rd Rb (Rd = *Rb)", 0 },
+  /* 5a */ { "lod Rd Rc (Rd = PGM*Rc)", 0 },
+  /* 5b */ { "lod Rd Rd (Rd = *Rd)", 0 },
+  /* 5c */ { "lod Rd SP (Rd = *SP)", 0 },
+  /* 5d */ { "lod Rd PC (Rd = *PC)", 1 },
+  /* 5e */ { "pop Rd", 0 },
+  /* 5f */ { "lod Rd Imm (Rd = *Imm)", 1 },
+  /* 60 */ { "lod SP Ra (SP = *Ra)", 0 },
+  /* 61 */ { "lod SP Rb (SP = *Rb)", 0 },
+  /* 62 */ { "lod SP Rc (SP = PGM*Rc)", 0 },
+  /* 63 */ { "lod SP Rd (SP = *Rd)", 0 },
+  /* 64 */ { "lod SP SP (SP = *SP)", 0 },
+  /* 65 */ { "lod SP PC (SP = *PC)", 1 },
+  /* 66 */ { "pop SP", 0 },
+  /* 67 */ { "lod SP Imm (SP = *Imm)", 1 },
+  /* 68 */ { "lod PC Ra (PC = *Ra)", 0 },
+  /* 69 */ { "lod PC Rb (PC = *Rb)", 0 },
+  /* 6a */ { "lod PC Rc (PC = PGM*Rc)", 0 },
+  /* 6b */ { "lod PC Rd (PC = *Rd)", 0 },
+  /* 6c */ { "lod PC SP (PC = *SP)", 0 },
+  /* 6d */ { "lod PC PC (PC = *PC)", 1 },
+  /* 6e */ { "ret", 0 },
+  /* 6f */ { "lod PC Imm (PC = *Imm)", 1 },
+  /* 70 */ { "peek Ra", 0 },
+  /* 71 */ { "peek Rb", 0 },
+  /* 72 */ { "peek Rc", 0 },
+  /* 73 */ { "peek Rd", 0 },
+  /* 74 */ { "lcc mem", 1 },
+  /* 75 */ { "lcd mem", 1 },
+  /* 76 */ { "lcc pgm", 1 },
+  /* 77 */ { "lcd pgm", 1 },
+  /* 78 */ { "clr Ra", 0 },
+  /* 79 */ { "clr Rb", 0 },
+  /* 7a */ { "clr Rc", 0 },
+  /* 7b */ { "clr Rd", 0 },
+  /* 7c */ { "clr SP", 0 },
+  /* 7d */ { "clr PC", 0 },
+  /* 7e */ { "lcc imm", 1 },
+  /* 7f */ { "lcd imm", 1 },
+  /* 80 */ { "sto Ra Ra (*Ra = Ra)", 0 },
+  /* 81 */ { "sto Ra Rb (*Ra = Rb)", 0 },
+  /* 82 */ { "sto Ra Rc (*Ra = Rc)", 0 },
+  /* 83 */ { "sto Ra Rd (*Ra = Rd)", 0 },
+  /* 84 */ { "sto Ra SP (*Ra = SP)", 0 },
+  /* 85 */ { "sto Ra PC (*Ra = PC)", 0 },
+  /* 86 */ { "pop => Ra", 0 },
+  /* 87 */ { "sto Ra Imm (*Ra = Imm)", 0 },
+  /* 88 */ { "sto Rb Ra (*Rb = Ra)", 0 },
+  /* 89 */ { "sto Rb Rb (*Rb = Rb)", 0 },
+  /* 8a */ { "sto Rb Rc (*Rb = Rc)", 0 },
+  /* 8b */ { "sto Rb Rd (*Rb = Rd)", 0 },
+  /* 8c */ { "sto Rb SP (*Rb = SP)", 0 },
+  /* 8d */ { "sto Rb PC (*Rb = PC)", 0 },
+  /* 8e */ { "pop => Rb", 0 },
+  /* 8f */ { "sto Rb Imm (*Rb = Imm)", 0 },
+  /* 90 */ { "sto Rc Ra (PGM*Rc = Ra)", 0 },
+  /* 91 */ { "sto Rc Rb (PGM*Rc = Rb)", 0 },
+  /* 92 */ { "sto Rc Rc (PGM*Rc = Rc)", 0 },
+  /* 93 */ { "sto Rc Rd (PGM*Rc = Rd)", 0 },
+  /* 94 */ { "sto Rc SP (PGM*Rc = SP)", 0 },
+  /* 95 */ { "sto Rc PC (PGM*Rc = PC)", 0 },
+  /* 96 */ { "pop => Rc", 0 },
+  /* 97 */ { "sto Rc Imm (PGM*Rc = Imm)", 0 },
+  /* 98 */ { "sto Rd Ra (*Rd = Ra)", 0 },
+  /* 99 */ { "sto Rd Rb (*Rd = Rb)", 0 },
+  /* 9a */ { "sto Rd Rc (*Rd = Rc)", 0 },
+  /* 9b */ { "sto Rd Rd (*Rd = Rd)", 0 },
+  /* 9c */ { "sto Rd SP (*Rd = SP)", 0 },
+  /* 9d */ { "sto Rd PC (*Rd = PC)", 0 },
+  /* 9e */ { "pop => Rd", 0 },
+  /* 9f */ { "sto Rd Imm (*Rd = Imm)", 0 },
+  /* a0 */ { "sto SP Ra (*SP = Ra)", 0 },
+  /* a1 */ { "sto SP Rb (*SP = Rb)", 0 },
+  /* a2 */ { "sto SP Rc (*SP = Rc)", 0 },
+  /* a3 */ { "sto SP Rd (*SP = Rd)", 0 },
+  /* a4 */ { "sto SP SP (*SP = SP)", 0 },
+  /* a5 */ { "sto SP PC (*SP = PC)", 0 },
+  /* a6 */ { "pop => SP", 0 },
+  /* a7 */ { "sto SP Imm (*SP = Imm)", 0 },
+  /* a8 */ { "sto PC Ra (*PC = Ra)", 1 },
+  /* a9 */ { "sto PC Rb (*PC = Rb)", 1 },
+  /* aa */ { "sto PC Rc (*PC = Rc)", 1 },
+  /* ab */ { "sto PC Rd (*PC = Rd)", 1 },
+  /* ac */ { "sto PC SP (*PC = SP)", 1 },
+  /* ad */ { "sto PC PC (*PC = PC)", 1 },
+  /* ae */ { "ret", 0 },
+  /* af */ { "sto PC Imm (*PC = Imm)", 1 },
+  /* b0 */ { "push <= Ra", 0 },
+  /* b1 */ { "push <= Rb", 0 },
+  /* b2 */ { "push <= Rc", 0 },
+  /* b3 */ { "push <= Rd", 0 },
+  /* b4 */ { "push <= SP", 0 },
+  /* b5 */ { "call Rc", 0 },
+  /* b6 */ { "push <= Acc", 0 },
+  /* b7 */ { "pushi <= Imm", 1 },
+  /* b8 */ { "stoi Ra (*Imm = Ra)", 1 },
+  /* b9 */ { "stoi Rb (*Imm = Rb)", 1 },
+  /* ba */ { "stoi Rc (*Imm = Rc)", 1 },
+  /* bb */ { "stoi Rd (*Imm = Rd)", 1 },
+  /* bc */ { "stoi SP (*Imm = SP)", 1 },
+  /* bd */ { "calli", 1 },
+  /* be */ { "stoi Acc (*Imm = Acc)", 1 },
+  /* bf */ { "stoi (PGM*Imm2 = Imm1)", 2 },
+  /* c0 */ { "inc Ra", 0 },
+  /* c1 */ { "inc Rb", 0 },
+  /* c2 */ { "inc Rc", 0 },
+  /* c3 */ { "inc Rd", 0 },
+  /* c4 */ { "Rb sub Ra => Ra", 0 },
+  /* c5 */ { "Rb sub Rb => Rb", 0 },
+  /* c6 */ { "Rb sub Rc => Rc", 0 },
+  /* c7 */ { "Rb sub Rd => Rd", 0 },
+  /* c8 */ { "sub Rb from Ra => Ra", 0 },
+  /* c9 */ { "sub Rb from Rb => Rb", 0 },
+  /* ca */ { "sub Rb from Rc => Rc", 0 },
+  /* cb */ { "sub Rb from Rd => Rd", 0 },
+  /* cc */ { "add Rb Ra => Ra", 0 },
+  /* cd */ { "add Rb Rb => Rb", 0 },
+  /* ce */ { "add Rb Rc => Rc", 0 },
+  /* cf */ { "add Rb Rd => Rd", 0 },
+  /* d0 */ { "xor Rb Ra => Ra", 0 },
+  /* d1 */ { "xor Rb Rb => Rb", 0 },
+  /* d2 */ { "xor Rb Rc => Rc", 0 },
+  /* d3 */ { "xor Rb Rd => Rd", 0 },
+  /* d4 */ { "or Rb Ra => Ra", 0 },
+  /* d5 */ { "or Rb Rb => Rb", 0 },
+  /* d6 */ { "or Rb Rc => Rc", 0 },
+  /* d7 */ { "or Rb Rd => Rd", 0 },
+  /* d8 */ { "and Rb Ra => Ra", 0 },
+  /* d9 */ { "and Rb Rb => Rb", 0 },
+  /* da */ { "and Rb Rc => Rc", 0 },
+  /* db */ { "and Rb Rd => Rd", 0 },
+  /* dc */ { "set Ra => Ra", 0 },
+  /* dd */ { "set Rb => Rb", 0 },
+  /* de */ { "set Rc => Rc", 0 },
+  /* df */ { "set Rd => Rd", 0 },
+  /* e0 */ { "dec Ra", 0 },
+  /* e1 */ { "dec Rb", 0 },
+  /* e2 */ { "dec Rc", 0 },
+  /* e3 */ { "dec Rd", 0 },
+  /* e4 */ { "Rb sub Ra with carry  => Ra", 0 },
+  /* e5 */ { "Rb sub Rb with carry  => Rb", 0 },
+  /* e6 */ { "Rb sub Rc with carry  => Rc", 0 },
+  /* e7 */ { "Rb sub Rd with carry  => Rd", 0 },
+  /* e8 */ { "sub Rb from Ra with carry  => Ra", 0 },
+  /* e9 */ { "sub Rb from Rb with carry  => Rb", 0 },
+  /* ea */ { "sub Rb from Rc with carry  => Rc", 0 },
+  /* eb */ { "sub Rb from Rd with carry  => Rd", 0 },
+  /* ec */ { "add Rb Ra with carry  => Ra", 0 },
+  /* ed */ { "add Rb Rb with carry  => Rb", 0 },
+  /* ee */ { "add Rb Rc with carry  => Rc", 0 },
+  /* ef */ { "add Rb Rd with carry  => Rd", 0 },
+  /* f0 */ { "lcc Ra", 0 },
+  /* f1 */ { "lcc Rb", 0 },
+  /* f2 */ { "lcc Rc", 0 },
+  /* f3 */ { "lcc Rd", 0 },
+  /* f4 */ { "cmp Rb, Ra", 0 },
+  /* f5 */ { "cmp Rb, Rb", 0 },
+  /* f6 */ { "cmp Rb, Rc", 0 },
+  /* f7 */ { "cmp Rb, Rd", 0 },
+  /* f8 */ { "cmp Ra, Rb", 0 },
+  /* f9 */ { "cmp Rb, Rb", 0 },
+  /* fa */ { "cmp Rc, Rb", 0 },
+  /* fb */ { "cmp Rd, Rb", 0 },
+  /* fc */ { "lcd Ra", 0 },
+  /* fd */ { "lcd Rb", 0 },
+  /* fe */ { "lcd Rc", 0 },
+  /* ff */ { "lcd Rd", 0 },
+};
+
+#endif
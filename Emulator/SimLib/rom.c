@@ -16,55 +16,160 @@
 #include <memory.h>
 
 DLLEXPORT Rom* newRomFromFile(const char *romFile)
+{
+	FILE* f = fopen(romFile, "rb");
+	if (f == NULL)
+	{
+		printf("Unable to load ROM file: %s\n", romFile);
+		exit(1);
+	}
+
+	fseek(f, 0, SEEK_END);
+	long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	char* text = malloc(length + 1);
+	Rom* r = NULL;
+	if (text != NULL)
+	{
+		text[fread(text, 1, length, f)] = '\0';
+		r = newRomFromString(text);
+		free(text);
+	}
+	fclose(f);
+	return r;
+}
+
+static int hexNibble(char ch)
+{
+	if (ch >= '0' && ch <= '9') return ch - '0';
+	if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+	if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+	return -1;
+}
+
+// same text as rom.hex: 8 hex digits per word, most significant first.
+// whitespace is skipped, words past the end of the string are left 0.
+// more than ROM_WORDS words makes a wide step rom
+DLLEXPORT Rom* newRomFromString(const char* romStr)
 {
 	Rom* r = (Rom*)malloc(sizeof(Rom));
 	if (r != NULL)
 	{
-		byte buf[10];
-		r->size = 32767 * 4;
-		FILE* f = NULL;
-		f = fopen(romFile, "r");
-		if (f == NULL)
+		r->size = ROM_WIDE_WORDS * 4;
+		r->bytes = malloc(r->size);
+		memset(r->bytes, 0, r->size);
+
+		int digits = 0;
+		unsigned word = 0;
+		for (const char* p = romStr; *p && digits < r->size * 2; ++p)
 		{
-			printf("Unable to load ROM file: %s\n", romFile);
-			exit(1);
+			int nibble = hexNibble(*p);
+			if (nibble < 0)
+				continue;
+
+			word = (word << 4) | (unsigned)nibble;
+			if ((++digits & 7) == 0)
+			{
+				int i = (digits / 8 - 1) * 4;
+				r->bytes[i] = (byte)word;
+				r->bytes[i + 1] = (byte)(word >> 8);
+				r->bytes[i + 2] = (byte)(word >> 16);
+				r->bytes[i + 3] = (byte)(word >> 24);
+				word = 0;
+			}
 		}
-		else
+
+		r->stepBits = ROM_WIDE_STEP_BITS;
+		if (digits / 8 <= ROM_WORDS)
 		{
-			r->bytes = malloc(r->size);
-			memset(r->bytes, 0, r->size);
+			r->stepBits = ROM_STEP_BITS;
+			r->size = ROM_WORDS * 4;
+			r->bytes = realloc(r->bytes, r->size);
+		}
+	}
+	return r;
+}
+
+static int readVarint(const byte** p, const byte* end, unsigned* value)
+{
+	*value = 0;
+	for (int shift = 0; *p < end && shift < 32; shift += 7)
+	{
+		byte b = *(*p)++;
+		*value |= (unsigned)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return 1;
+	}
+	return 0;
+}
+
+static Rom* unpack(Rom* r, const byte* p, const byte* end)
+{
+	unsigned words, entries;
+	if (!readVarint(&p, end, &words) || words > ROM_WIDE_WORDS ||
+		!readVarint(&p, end, &entries) || entries > words || (unsigned)(end - p) < entries * 4)
+		return NULL;
+
+	const byte* dictionary = p;
+	p += entries * 4;
+
+	r->stepBits = words > ROM_WORDS ? ROM_WIDE_STEP_BITS : ROM_STEP_BITS;
+	r->size = (words > ROM_WORDS ? ROM_WIDE_WORDS : ROM_WORDS) * 4;
+	r->bytes = malloc(r->size);
+	if (r->bytes == NULL)
+		return NULL;
+	memset(r->bytes, 0, r->size);
+
+	unsigned out = 0;
+	while (out < words)
+	{
+		unsigned token;
+		if (!readVarint(&p, end, &token))
+			return NULL;
+
+		unsigned n = token >> 1;
+		if (n == 0 || n > words - out)
+			return NULL;
+
+		if (token & 1)
+		{
+			unsigned distance;
+			if (!readVarint(&p, end, &distance) || distance == 0 || distance > out)
+				return NULL;
 
-			for (int i = 0; i < r->size; i += 4)
+			// forwards, a byte at a time: the source may overlap the copy
+			byte* dst = r->bytes + out * 4;
+			const byte* src = dst - distance * 4;
+			for (unsigned i = 0; i < n * 4; ++i)
+				dst[i] = src[i];
+			out += n;
+		}
+		else
+		{
+			for (; n > 0; --n, ++out)
 			{
-				fgets(buf, 3, f);
-				sscanf(buf, "%02hhX", r->bytes + i + 3);
-				fgets(buf, 3, f);
-				sscanf(buf, "%02hhX", r->bytes + i + 2);
-				fgets(buf, 3, f);
-				sscanf(buf, "%02hhX", r->bytes + i + 1);
-				fgets(buf, 3, f);
-				sscanf(buf, "%02hhX", r->bytes + i);
+				unsigned index;
+				if (!readVarint(&p, end, &index) || index >= entries)
+					return NULL;
+				memcpy(r->bytes + out * 4, dictionary + index * 4, 4);
 			}
-
-			fclose(f);
 		}
 	}
 	return r;
 }
 
-DLLEXPORT Rom* newRomFromString(const char* romStr)
+DLLEXPORT Rom* newRomFromPacked(const byte* packed, int packedSize)
 {
 	Rom* r = (Rom*)malloc(sizeof(Rom));
 	if (r != NULL)
 	{
-		byte buf[10];
-		r->size = 32767 * 4;
-		r->bytes = malloc(r->size);
-		memset(r->bytes, 0, r->size);
-
-		for (int i = 0; i < r->size; i += 4)
+		r->bytes = NULL;
+		if (unpack(r, packed, packed + packedSize) == NULL)
 		{
-			sscanf(buf, "%08x", (unsigned*)(romStr + i));
+			free(r->bytes);
+			free(r);
+			r = NULL;
 		}
 	}
 	return r;
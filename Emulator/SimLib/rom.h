@@ -14,14 +14,38 @@
 
 #include "simlib.h"
 
+// rom address: opcode | step << 8 | flags << (8 + step bits)
+#define ROM_STEP_BITS      3
+#define ROM_WORDS          (1 << 15) // 15 address bits: flags, step, opcode
+
+// wide step rom (MicrocodeTools -w): a 4 bit step counter for instructions
+// with up to 14 execute steps. emulator only, the EEPROMs have 15 address bits
+#define ROM_WIDE_STEP_BITS 4
+#define ROM_WIDE_WORDS     (1 << 16)
+
 typedef struct DLLEXPORT
 {
 	int size;
 	byte* bytes;
+	int stepBits;  // ROM_STEP_BITS or ROM_WIDE_STEP_BITS
 } Rom;
 
+// the layout follows from the size: more than ROM_WORDS words is a wide step rom
 DLLEXPORT Rom* newRomFromFile(const char* romFile);
 DLLEXPORT Rom* newRomFromString(const char* romStr);
+
+// packed rom (SimWasm/rompack), for building a rom into the binary:
+//
+//   varint  words               rom size in words
+//   varint  entries             dictionary size
+//   u32     dictionary[entries] distinct words, little endian
+//   tokens, until all words are produced:
+//     varint n << 1             n literals follow, each a varint dictionary index
+//     varint n << 1 | 1         then varint distance: repeat n words from distance back
+//
+// varints are 7 bits per byte, least significant first, top bit set on all
+// but the last. returns NULL if the data is malformed
+DLLEXPORT Rom* newRomFromPacked(const byte* packed, int packedSize);
 DLLEXPORT void destroyRom(Rom* r);
 
 DLLEXPORT byte readRom(Rom* r, int address);
@@ -12,7 +12,7 @@
 #ifndef _SIMLIB_H_
 #define _SIMLIB_H_
 
-#if _EMSCRIPTEN
+#if _EMSCRIPTEN || !_WIN32
 #define DLLEXPORT
 #elif COMPILING_DLL
 #define DLLEXPORT __declspec(dllexport)
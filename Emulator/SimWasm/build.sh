@@ -0,0 +1,41 @@
+#!/bin/sh
+# Linux build of the web emulator core (emscripten's emcc on the path)
+#
+# the rom (ROM=..., default rom.hex from MicrocodeTools) is packed by rompack
+# into rompacked.h and built in, so there is no cpemu.data to download or
+# rom.hex text to parse at startup. builds two variants:
+#
+#   out/o3   -O3, fastest core
+#   out/os   -Os, smallest download
+#
+# then measures both against the current Web/emu build (coldstart.js) and
+# copies VARIANT (default o3) to Web/emu, removing the cpemu.data an older
+# (rom preloading) build left there
+
+cd "$(dirname "$0")"
+
+ROM=${ROM:-rom.hex}
+VARIANT=${VARIANT:-o3}
+
+cc -O2 -o rompack -I ../SimLib rompack.c ../SimLib/rom.c || exit 1
+./rompack "$ROM" rompacked.h || exit 1
+
+SOURCES="simwasm.c ../SimInst/siminst.c ../SimLib/alu.c ../SimLib/computer.c ../SimLib/register.c ../SimLib/ram.c \
+  ../SimLib/rom.c ../SimLib/counter.c ../SimLib/bus.c ../SimLib/events.c ../SimLib/lcdshadow.c ../SimLib/inputscript.c \
+  ../SimLib/disasm.c ../vrEmuLcd/src/vrEmuLcd.c"
+FLAGS="-I . -I ../SimInst -I ../SimLib -I ../vrEmuLcd/src -D _EMSCRIPTEN -D SI_EMBEDDED_ROM=1 \
+  -s EXPORTED_RUNTIME_METHODS=ccall,cwrap -s EXPORTED_FUNCTIONS=_malloc,_free"
+
+for opt in o3 os; do
+  mkdir -p out/$opt
+  case $opt in
+    o3) level=-O3 ;;
+    os) level=-Os ;;
+  esac
+  emcc $level -o out/$opt/cpemu.js $FLAGS $SOURCES || exit 1
+done
+
+node coldstart.js out/o3 out/os ../../Web/emu
+
+cp out/$VARIANT/cpemu.js out/$VARIANT/cpemu.wasm ../../Web/emu || exit 1
+rm -f ../../Web/emu/cpemu.data
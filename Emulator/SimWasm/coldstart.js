@@ -0,0 +1,153 @@
+/*
+ * Troy's 8-bit computer - Cold start measurement of the wasm builds
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: node coldstart.js [-n runs] dir...
+//
+// for each dir holding a cpemu.js build (cpemu.wasm, and cpemu.data when the
+// rom is preloaded rather than built in), prints:
+//
+//   download   bytes the page fetches for the core, raw and gzipped
+//   instantiate  compiling and instantiating cpemu.wasm
+//   runtime    until emscripten's runtime is up (includes mounting the
+//              preloaded rom.hex)
+//   first cycle  until simLibInitialise (reading the rom) and one clock
+//              cycle have run
+//
+// times are from starting cpemu.js, each the median of runs (default 9)
+// fresh node processes, so nothing is cached between them
+
+var fs = require('fs');
+var path = require('path');
+var zlib = require('zlib');
+var childProcess = require('child_process');
+
+// one cold start, in this process
+var measure = function (dir)
+{
+  var t0 = performance.now();
+  var times = {};
+  var Module = {
+    print: function () {},
+    printErr: function () {},
+    instantiateWasm: function (imports, receiveInstance)
+    {
+      var t = performance.now();
+      WebAssembly.instantiate(fs.readFileSync(path.join(dir, 'cpemu.wasm')), imports).then(function (result)
+      {
+        times.instantiate = performance.now() - t;
+        receiveInstance(result.instance, result.module);
+      });
+      return {};
+    },
+    getPreloadedPackage: function (name)
+    {
+      var data = fs.readFileSync(path.join(dir, path.basename(name)));
+      return data.buffer.slice(data.byteOffset, data.byteOffset + data.length);
+    },
+    onRuntimeInitialized: function ()
+    {
+      times.runtime = performance.now() - t0;
+      Module._simLibInitialise();
+      if (Module._simLibRun)
+      {
+        Module._simLibRun(1);
+      }
+      else
+      {
+        Module._simLibSetClock(0);
+        Module._simLibSetClock(1);
+      }
+      times.firstCycle = performance.now() - t0;
+      process.stdout.write(JSON.stringify(times));
+    },
+  };
+
+  // cpemu.js runs as a classic script on the page: give it those globals
+  globalThis.Module = Module;
+  globalThis.require = require;
+  globalThis.__dirname = dir;
+  globalThis.location = { pathname: dir + '/' };
+  require('vm').runInThisContext(fs.readFileSync(path.join(dir, 'cpemu.js'), 'utf8'), { filename: 'cpemu.js' });
+};
+
+var download = function (dir)
+{
+  var files = ['cpemu.js', 'cpemu.wasm'];
+  if (fs.readFileSync(path.join(dir, 'cpemu.js'), 'utf8').indexOf('cpemu.data') >= 0)
+  {
+    files.push('cpemu.data');
+  }
+
+  var raw = 0, gzipped = 0;
+  files.forEach(function (f)
+  {
+    var data = fs.readFileSync(path.join(dir, f));
+    raw += data.length;
+    gzipped += zlib.gzipSync(data, { level: 9 }).length;
+  });
+  return { files: files, raw: raw, gzipped: gzipped };
+};
+
+var median = function (values)
+{
+  values = values.slice().sort(function (a, b) { return a - b; });
+  return values[Math.floor(values.length / 2)];
+};
+
+var kb = function (bytes)
+{
+  return (bytes / 1024).toFixed(1) + " KB";
+};
+
+var main = function (args)
+{
+  if (args[0] == '--child')
+  {
+    measure(path.resolve(args[1]));
+    return 0;
+  }
+
+  var runs = 9;
+  if (args[0] == '-n')
+  {
+    runs = parseInt(args[1], 10);
+    args = args.slice(2);
+  }
+  if (args.length == 0 || !(runs > 0))
+  {
+    console.error("usage: node coldstart.js [-n runs] dir...");
+    return 1;
+  }
+
+  args.forEach(function (dir)
+  {
+    var samples = [];
+    for (var i = 0; i < runs; ++i)
+    {
+      var out = childProcess.execFileSync(process.execPath, [__filename, '--child', dir]);
+      samples.push(JSON.parse(out));
+    }
+
+    var d = download(dir);
+    var ms = function (key)
+    {
+      return median(samples.map(function (s) { return s[key]; })).toFixed(1) + " ms";
+    };
+    console.log(dir + " (" + d.files.join(", ") + ")");
+    console.log("  download     " + kb(d.raw) + ", " + kb(d.gzipped) + " gzipped");
+    console.log("  instantiate  " + ms('instantiate'));
+    console.log("  runtime      " + ms('runtime'));
+    console.log("  first cycle  " + ms('firstCycle'));
+  });
+  return 0;
+};
+
+process.exitCode = main(process.argv.slice(2));
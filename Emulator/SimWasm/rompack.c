@@ -0,0 +1,205 @@
+/*
+ * Troy's 8-bit computer - Emulator rom packer
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// usage: rompack rom.hex rompacked.h
+//
+// packs a rom (rom.h, newRomFromPacked) and writes it as a C array,
+// romPacked[], for siminst.c to build in with SI_EMBEDDED_ROM. the microcode
+// has few distinct words and long repeats (the same steps for every flags
+// combination), so a word dictionary with an LZ77 style match search packs
+// the 256 KB of rom.hex text to a couple of KB. the output is unpacked and
+// checked against the rom before it is written
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rom.h"
+
+#define MIN_MATCH   3
+#define MAX_CHAIN   256
+#define HASH_BITS   16
+
+typedef struct
+{
+	byte* bytes;
+	int size;
+	int capacity;
+} Output;
+
+static void put(Output* o, byte b)
+{
+	if (o->size == o->capacity)
+	{
+		o->capacity = o->capacity ? o->capacity * 2 : 4096;
+		o->bytes = realloc(o->bytes, o->capacity);
+	}
+	o->bytes[o->size++] = b;
+}
+
+static void putVarint(Output* o, unsigned v)
+{
+	while (v >= 0x80)
+	{
+		put(o, (byte)(v | 0x80));
+		v >>= 7;
+	}
+	put(o, (byte)v);
+}
+
+static unsigned romWord(const Rom* r, int i)
+{
+	return r->bytes[i * 4] | r->bytes[i * 4 + 1] << 8 | r->bytes[i * 4 + 2] << 16 | (unsigned)r->bytes[i * 4 + 3] << 24;
+}
+
+static unsigned hash(const unsigned* words, int i)
+{
+	unsigned h = words[i] * 2654435761u ^ words[i + 1] * 2246822519u ^ words[i + 2] * 3266489917u;
+	return h >> (32 - HASH_BITS);
+}
+
+static void flushLiterals(Output* o, const unsigned* indices, int from, int to)
+{
+	if (to > from)
+	{
+		putVarint(o, (unsigned)(to - from) << 1);
+		for (int i = from; i < to; ++i)
+			putVarint(o, indices[i]);
+	}
+}
+
+static Output pack(const Rom* r)
+{
+	Output o = { NULL, 0, 0 };
+	int n = r->size / 4;
+
+	unsigned* words = malloc(n * sizeof(unsigned));
+	unsigned* indices = malloc(n * sizeof(unsigned));
+	unsigned* dictionary = malloc(n * sizeof(unsigned));
+	int* head = malloc((1 << HASH_BITS) * sizeof(int));
+	int* prev = malloc(n * sizeof(int));
+	int entries = 0;
+
+	for (int i = 0; i < n; ++i)
+	{
+		words[i] = romWord(r, i);
+		int e = 0;
+		while (e < entries && dictionary[e] != words[i])
+			++e;
+		if (e == entries)
+			dictionary[entries++] = words[i];
+		indices[i] = e;
+	}
+
+	putVarint(&o, n);
+	putVarint(&o, entries);
+	for (int e = 0; e < entries; ++e)
+	{
+		for (int b = 0; b < 4; ++b)
+			put(&o, (byte)(dictionary[e] >> (b * 8)));
+	}
+
+	// greedy: the longest earlier match of at least MIN_MATCH words,
+	// searched along a hash chain
+	for (int h = 0; h < (1 << HASH_BITS); ++h)
+		head[h] = -1;
+
+	int literals = 0;
+	int i = 0;
+	while (i < n)
+	{
+		int best = 0, bestDistance = 0;
+		if (i + MIN_MATCH <= n)
+		{
+			int chain = 0;
+			for (int j = head[hash(words, i)]; j >= 0 && chain < MAX_CHAIN; j = prev[j], ++chain)
+			{
+				int length = 0;
+				while (i + length < n && words[j + length] == words[i + length])
+					++length;
+				if (length > best)
+				{
+					best = length;
+					bestDistance = i - j;
+				}
+			}
+		}
+
+		int advance = best >= MIN_MATCH ? best : 1;
+		if (best >= MIN_MATCH)
+		{
+			flushLiterals(&o, indices, literals, i);
+			putVarint(&o, (unsigned)best << 1 | 1);
+			putVarint(&o, bestDistance);
+		}
+
+		for (int k = i; k < i + advance; ++k)
+		{
+			if (k + MIN_MATCH <= n)
+			{
+				unsigned h = hash(words, k);
+				prev[k] = head[h];
+				head[h] = k;
+			}
+		}
+		i += advance;
+		if (best >= MIN_MATCH)
+			literals = i;
+	}
+	flushLiterals(&o, indices, literals, n);
+
+	free(words);
+	free(indices);
+	free(dictionary);
+	free(head);
+	free(prev);
+	return o;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s rom.hex rompacked.h\n", argv[0]);
+		return 1;
+	}
+
+	Rom* r = newRomFromFile(argv[1]);
+	Output o = pack(r);
+
+	Rom* check = newRomFromPacked(o.bytes, o.size);
+	if (check == NULL || check->size != r->size || check->stepBits != r->stepBits || memcmp(check->bytes, r->bytes, r->size) != 0)
+	{
+		fprintf(stderr, "%s: packed rom does not unpack to %s\n", argv[0], argv[1]);
+		return 2;
+	}
+
+	FILE* f = fopen(argv[2], "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "%s: unable to write %s\n", argv[0], argv[2]);
+		return 1;
+	}
+
+	fprintf(f, "// generated by rompack from %s: %d words, %d bytes packed\n\n", argv[1], r->size / 4, o.size);
+	fprintf(f, "static const unsigned char romPacked[%d] = {", o.size);
+	for (int i = 0; i < o.size; ++i)
+		fprintf(f, "%s0x%02x,", (i % 16) ? " " : "\n\t", o.bytes[i]);
+	fprintf(f, "\n};\n");
+	fclose(f);
+
+	fprintf(stderr, "%s: %d words (%d bytes) packed to %d bytes\n", argv[2], r->size / 4, r->size, o.size);
+
+	destroyRom(check);
+	destroyRom(r);
+	free(o.bytes);
+	return 0;
+}
@@ -27,12 +27,33 @@ void simLibLoadRam(const char* data)
 	siLoadRam(data);
 }
 
+// binary images: data points at length bytes on the heap (eg. a Uint8Array
+// copied to _malloc'd memory), rather than hex strings through ccall
+EMSCRIPTEN_KEEPALIVE
+void simLibLoadProgramBytes(const byte* data, int length)
+{
+	siLoadProgramBytes(data, length);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void simLibLoadRamBytes(const byte* data, int length)
+{
+	siLoadRamBytes(data, length);
+}
+
 EMSCRIPTEN_KEEPALIVE
 int simLibRamByte(int offset)
 {
 	return siRamByte(offset);
 }
 
+// rom.hex text. swapped in at the next instruction fetch
+EMSCRIPTEN_KEEPALIVE
+void simLibLoadRom(const char* rom)
+{
+	siLoadRom(rom);
+}
+
 EMSCRIPTEN_KEEPALIVE
 void simLibSetInput(byte inputByte)
 {
@@ -52,6 +73,26 @@ void simLibReset()
 	siReset();
 }
 
+EMSCRIPTEN_KEEPALIVE
+unsigned simLibRun(unsigned cycles)
+{
+	return siRun(cycles);
+}
+
+// input script text (inputscript.h). returns 0, or the line number of a
+// malformed line
+EMSCRIPTEN_KEEPALIVE
+int simLibSetInputScript(const char* script)
+{
+	return siSetInputScript(script);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void simLibSetFeatures(unsigned features)
+{
+	siSetFeatures(features);
+}
+
 EMSCRIPTEN_KEEPALIVE
 int simLibGetValue(SIComponent component)
 {
@@ -69,3 +110,36 @@ int simLibGetControlWord()
 {
 	return (int)siGetControlWord();
 }
+
+// events are 8 bytes each (see SimEvent). out must point to a heap
+// buffer of at least maxEvents * 8 bytes
+EMSCRIPTEN_KEEPALIVE
+void simLibEnableEvents(unsigned mask, int capacity)
+{
+	siEnableEvents(mask, capacity);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int simLibReadEvents(SimEvent* out, int maxEvents)
+{
+	return siReadEvents(out, maxEvents);
+}
+
+// refreshes the SIStateBlock (siminst.h) and returns a pointer to it. call
+// once per frame and read it from the heap rather than calling
+// simLibGetValue/simLibRamByte per value
+EMSCRIPTEN_KEEPALIVE
+const SIStateBlock* simLibGetState()
+{
+	return siGetState();
+}
+
+// lcd cells changed since the last call: LCD_DIRTY_BYTES (lcdshadow.h), a
+// bit per cell (row * 16 + column), valid until the next call
+EMSCRIPTEN_KEEPALIVE
+const byte* simLibTakeLcdDirty()
+{
+	static byte mask[LCD_DIRTY_BYTES];
+	siTakeLcdDirty(mask);
+	return mask;
+}
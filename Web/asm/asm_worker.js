@@ -0,0 +1,37 @@
+// assembles off the page's thread (main.js, doAssemble)
+//
+// posts { ready: true, lineOffset } once customasm and troyscpudef.asm are
+// loaded, then answers each { id, format, source } with { id, output, cached }
+// or { id, error }, in order
+
+importScripts("assembler.js")
+
+
+let g_assembler = null
+let g_queue = []
+
+
+function handle(msg) {
+  try {
+    let result = g_assembler.assemble(msg.format, msg.source)
+    postMessage({ id: msg.id, output: result.output, cached: result.cached })
+  } catch (e) {
+    postMessage({ id: msg.id, error: String(e) })
+  }
+}
+
+
+onmessage = function (ev) {
+  if (g_assembler == null)
+    g_queue.push(ev.data)
+  else
+    handle(ev.data)
+}
+
+
+loadAssembler().then(assembler => {
+  g_assembler = assembler
+  postMessage({ ready: true, lineOffset: assembler.lineOffset })
+  g_queue.forEach(handle)
+  g_queue = []
+})
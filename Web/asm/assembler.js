@@ -0,0 +1,201 @@
+// customasm wrapper shared by asm_worker.js and, where there are no workers,
+// the page itself (main.js)
+//
+// troyscpudef.asm is prepended to every program. it is fetched and encoded
+// once, and programs are copied into the wasm heap in bulk rather than a
+// wasm_string_set_byte call per byte. the last few outputs are kept, keyed by
+// format and a hash of the program, so re-assembling unchanged code (loading
+// an example, emulate after assemble) doesn't run customasm again
+
+
+const ASM_CACHE_SIZE = 16
+
+
+function makeAssembler(wasmBytes, definition) {
+  return WebAssembly.instantiate(wasmBytes).then(wasm => {
+    const exports = wasm.instance.exports
+    const encode = typeof TextEncoder !== 'undefined' ? (str => new TextEncoder("utf-8").encode(str)) : stringToUtf8ByteArray
+    const decode = typeof TextDecoder !== 'undefined' ? (bytes => new TextDecoder("utf-8").decode(bytes)) : utf8ByteArrayToString
+
+    const prefix = encode(definition + "\n")
+    const lineOffset = definition.split(/\r\n|\r|\n/).length
+    const dataField = findDataField(exports)
+    const cache = new Map()
+
+    let makeRustString = function (bytes) {
+      let ptr = exports.wasm_string_new(prefix.length + bytes.length)
+
+      if (dataField < 0) {
+        for (let i = 0; i < prefix.length; i++)
+          exports.wasm_string_set_byte(ptr, i, prefix[i])
+        for (let i = 0; i < bytes.length; i++)
+          exports.wasm_string_set_byte(ptr, prefix.length + i, bytes[i])
+        return ptr
+      }
+
+      // wasm_string_new may have grown memory: views are taken after it
+      let data = new Uint32Array(exports.memory.buffer, ptr, 3)[dataField]
+      let heap = new Uint8Array(exports.memory.buffer, data, prefix.length + bytes.length)
+      heap.set(prefix)
+      heap.set(bytes, prefix.length)
+      return ptr
+    }
+
+    let readRustString = function (ptr) {
+      let len = exports.wasm_string_get_len(ptr)
+
+      if (dataField < 0) {
+        let bytes = new Uint8Array(len)
+        for (let i = 0; i < len; i++)
+          bytes[i] = exports.wasm_string_get_byte(ptr, i)
+        return decode(bytes)
+      }
+
+      let data = new Uint32Array(exports.memory.buffer, ptr, 3)[dataField]
+      return decode(new Uint8Array(exports.memory.buffer, data, len).slice())
+    }
+
+    let run = function (format, source) {
+      let asmPtr = makeRustString(encode(source))
+      let outputPtr = exports.wasm_assemble(format, asmPtr)
+      let output = readRustString(outputPtr)
+
+      exports.wasm_string_drop(asmPtr)
+      exports.wasm_string_drop(outputPtr)
+      return output
+    }
+
+    return {
+      lineOffset: lineOffset,
+
+      // the output, and whether it came from the cache
+      assemble: function (format, source) {
+        let key = format + ":" + hashString(source)
+        let hit = cache.get(key)
+        if (hit && hit.source === source) {
+          // most recently used last
+          cache.delete(key)
+          cache.set(key, hit)
+          return { output: hit.output, cached: true }
+        }
+
+        let output = run(format, source)
+
+        cache.delete(key)
+        cache.set(key, { source: source, output: output })
+        if (cache.size > ASM_CACHE_SIZE)
+          cache.delete(cache.keys().next().value)
+
+        return { output: output, cached: false }
+      }
+    }
+  })
+}
+
+
+// wasm_string_new returns a boxed rust String: a (data, capacity, length)
+// triple whose field order the compiler chooses. finds the data pointer by
+// writing a marker through wasm_string_set_byte. -1 if it isn't there, and
+// the strings are copied a byte at a time as before
+function findDataField(exports) {
+  const marker = [0xa5, 0x5a, 0xc3, 0x3c]
+  let ptr = exports.wasm_string_new(marker.length)
+  marker.forEach((b, i) => exports.wasm_string_set_byte(ptr, i, b))
+
+  let found = -1
+  let fields = new Uint32Array(exports.memory.buffer, ptr, 3)
+  for (let f = 0; f < fields.length && found < 0; f++) {
+    let data = fields[f]
+    if (data > 0 && data + marker.length <= exports.memory.buffer.byteLength) {
+      let bytes = new Uint8Array(exports.memory.buffer, data, marker.length)
+      if (marker.every((b, i) => bytes[i] == b))
+        found = f
+    }
+  }
+
+  exports.wasm_string_drop(ptr)
+  return found
+}
+
+
+// 32-bit FNV-1a of the utf-16 code units
+function hashString(str) {
+  let h = 0x811c9dc5
+  for (let i = 0; i < str.length; i++)
+    h = Math.imul(h ^ str.charCodeAt(i), 0x01000193)
+  return (h >>> 0).toString(16)
+}
+
+
+// From https://github.com/google/closure-library/blob/e877b1eac410c0d842bcda118689759512e0e26f/closure/goog/crypt/crypt.js#L115
+function stringToUtf8ByteArray(str) {
+  let out = [],
+    p = 0
+  for (let i = 0; i < str.length; i++) {
+    let c = str.charCodeAt(i)
+    if (c < 128) {
+      out[p++] = c
+    } else if (c < 2048) {
+      out[p++] = (c >> 6) | 192
+      out[p++] = (c & 63) | 128
+    } else if (
+      ((c & 0xFC00) == 0xD800) && (i + 1) < str.length &&
+      ((str.charCodeAt(i + 1) & 0xFC00) == 0xDC00)) {
+      // Surrogate Pair
+      c = 0x10000 + ((c & 0x03FF) << 10) + (str.charCodeAt(++i) & 0x03FF)
+      out[p++] = (c >> 18) | 240
+      out[p++] = ((c >> 12) & 63) | 128
+      out[p++] = ((c >> 6) & 63) | 128
+      out[p++] = (c & 63) | 128
+    } else {
+      out[p++] = (c >> 12) | 224
+      out[p++] = ((c >> 6) & 63) | 128
+      out[p++] = (c & 63) | 128
+    }
+  }
+  return out
+}
+
+
+// From https://github.com/google/closure-library/blob/e877b1eac410c0d842bcda118689759512e0e26f/closure/goog/crypt/crypt.js#L149
+function utf8ByteArrayToString(bytes) {
+  let out = [],
+    pos = 0,
+    c = 0
+  while (pos < bytes.length) {
+    let c1 = bytes[pos++]
+    if (c1 < 128) {
+      out[c++] = String.fromCharCode(c1)
+    } else if (c1 > 191 && c1 < 224) {
+      let c2 = bytes[pos++]
+      out[c++] = String.fromCharCode((c1 & 31) << 6 | c2 & 63)
+    } else if (c1 > 239 && c1 < 365) {
+      // Surrogate Pair
+      let c2 = bytes[pos++]
+      let c3 = bytes[pos++]
+      let c4 = bytes[pos++]
+      let u = ((c1 & 7) << 18 | (c2 & 63) << 12 | (c3 & 63) << 6 | c4 & 63) - 0x10000
+      out[c++] = String.fromCharCode(0xD800 + (u >> 10))
+      out[c++] = String.fromCharCode(0xDC00 + (u & 1023))
+    } else {
+      let c2 = bytes[pos++]
+      let c3 = bytes[pos++]
+      out[c++] =
+        String.fromCharCode((c1 & 15) << 12 | (c2 & 63) << 6 | c3 & 63)
+    }
+  }
+  return out.join('')
+}
+
+
+// both files, fetched in parallel
+function loadAssembler() {
+  return Promise.all([
+    fetch("customasm.gc.wasm").then(r => r.arrayBuffer()),
+    fetch("troyscpudef.asm").then(r => r.text())
+  ]).then(r => makeAssembler(r[0], r[1]))
+}
+
+
+if (typeof module !== 'undefined')
+  module.exports = { makeAssembler: makeAssembler, hashString: hashString }
@@ -18,7 +18,7 @@ CodeMirror.defineMode('z80', function(_config, parserConfig) {
     keywords1 = /^(exx?|(ld|cp)([di]r?)?|[lp]ea|cmp|mov|jmp|jc|jz|jnc|jnz|pop|push|ad[cd]|cpl|daa|dec|inc|neg|sbc|sub|and|bit|[cs]cf|x?or|res|set|r[lr]c?a?|r[lr]d|s[lr]a|srl|djnz|nop|[de]i|halt|im|in([di]mr?|ir?|irx|2r?)|ot(dmr?|[id]rx|imr?)|out(0?|[di]r?|[di]2r?)|tst(io)?|slp)(\.([sl]?i)?[sl])?\b/i;
     keywords2 = /^(((call|j[pr]|rst|ret[in]?)(\.([sl]?i)?[sl])?)|(rs|st)mix)\b/i;
   } else {
-    keywords1 = /^(exx?|(ld|cp|in)([di]r?)?|cmp|mov|jmp|sto|lcc|lcd|lod|jmz|lsr|mv[abcd]|jc|jz|clr|clra|jnc|jnz|jnn|jno|jn|jo|peek|pop|push|ad[cd]|cpl|daa|dec|inc|neg|sbc|sub|subc|addc|or|xor|tst|and|bit|[cs]cf|x?or|res|set|r[lr]c?a?|r[lr]d|s[lr]a|srl|djnz|nop|rst|[de]i|halt|im|ot[di]r|out[di]?)\b/i;
+    keywords1 = /^(exx?|(ld|cp|in)([di]r?)?|cmp|mov|jmp|sto|lcc|lcd|lod|jmz|lsr|sh[lr]|ro[lr]|mul|cpy|add16|sub16|mv[abcd]|jc|jz|clr|clra|jnc|jnz|jnn|jno|jn|jo|peek|pop|push|ad[cd]|cpl|daa|dec|inc|neg|sbc|sub|subc|addc|or|xor|tst|and|bit|[cs]cf|x?or|res|set|r[lr]c?a?|r[lr]d|s[lr]a|srl|djnz|nop|rst|[de]i|halt|im|ot[di]r|out[di]?)\b/i;
     keywords2 = /^(call|j[pr]|ret[in]?|data|b_?(call|jump))\b/i;
   }
 
@@ -0,0 +1,34 @@
+; SHIFT UNIT - shl, shr, rlc and rrc of Rb
+;
+; emulator only: assemble with troyscpudef_shift.asm and run on the shift
+; unit rom (MicrocodeTools -s). the EEPROMs don't have these instructions
+;
+; counts the set bits of Pattern into Rd, rotates Rb a full turn, then
+; leaves Pattern << 1 in Rb and halts. Rd = 4 and Rb = 0x68 when it halts
+
+Pattern = 0b10110100
+
+	clr Rd
+	data Rb, Pattern
+	data Rc, 8
+
+.count:
+	shr Rb		; bit 0 into carry
+	jnc .next
+	inc Rd
+.next:
+	dec Rc
+	jnz .count
+
+	data Rb, Pattern
+	data Rc, 8
+
+.rotate:
+	rlc Rb
+	rrc Rb
+	rlc Rb		; one place left per pass
+	dec Rc
+	jnz .rotate
+
+	shl Rb
+	hlt
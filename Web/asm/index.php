@@ -170,6 +170,7 @@ span::selection {
   </div>
 
   <script src="underscore.min.js"></script>
+  <script src="assembler.js"></script>
   <script src="main.js"></script>
   <script src="codemirror/codemirror.js"></script>
   <script src="codemirror/troy_syntax.js"></script>
@@ -1,6 +1,14 @@
-let g_wasm = null
+let g_assembler = null
+let g_asmWorker = null
+let g_asmCallbacks = {}
+let g_asmNextId = 0
 let g_codeEditor = null
 
+// assemble this long after the last keystroke
+const ASSEMBLE_DELAY_MS = 300
+let g_assembleTimer = null
+let g_assembleLatest = 0
+
 
 function main() {
   setupEditor()
@@ -10,14 +18,39 @@ function main() {
   window.onkeydown = onKeyDown
   window.onbeforeunload = onBeforeUnload
 
-  fetch("customasm.gc.wasm")
-    .then(r => r.arrayBuffer())
-    .then(r => WebAssembly.instantiate(r))
-    .then(wasm => {
-      g_wasm = wasm
-      document.getElementById("buttonAssemble").disabled = false
-      assemble();
+  let ready = () => {
+    document.getElementById("buttonAssemble").disabled = false
+    assemble();
+  }
+
+  // customasm runs in asm_worker.js so long programs don't stall typing.
+  // without workers, it runs here (assembler.js)
+  if (window.Worker) {
+    g_asmWorker = new Worker("asm_worker.js")
+    g_asmWorker.onmessage = function (ev) {
+      let msg = ev.data
+      if (msg.ready) {
+        lineOffset = msg.lineOffset
+        g_assembler = g_asmWorker
+        ready()
+        return
+      }
+
+      let success = g_asmCallbacks[msg.id]
+      delete g_asmCallbacks[msg.id]
+      if (msg.error) {
+        alert("Error assembling!\n\n" + msg.error)
+        return
+      }
+      success(msg.output)
+    }
+  } else {
+    loadAssembler().then(assembler => {
+      lineOffset = assembler.lineOffset
+      g_assembler = assembler
+      ready()
     })
+  }
 }
 
 function getQueryParams()
@@ -66,6 +99,7 @@ function setupEditor() {
   })
 
   g_codeEditor.setOption("theme", "lesser-dark");
+  g_codeEditor.on("change", assembleSoon)
   
   example = getParam("e");
   if (!example)
@@ -105,34 +139,29 @@ function hex2bin(hex) {
 lineOffset = 0;
 
 function doAssemble(format, success) {
-  if (g_wasm == null)
+  if (g_assembler == null)
     return;
 
-  fetch("troyscpudef.asm")
-    .then(r => r.text())
-    .then(function (r) {
-      var code = "";
-      code = r; //.text()
-      lineOffset = (code.split(/\r\n|\r|\n/).length)
-
-      code = code + "\n" + g_codeEditor.getValue();
-
-      let asmPtr = makeRustString(code); //g_codeEditor.getValue())
-      let outputPtr = null
-      try {
-        outputPtr = g_wasm.instance.exports.wasm_assemble(format, asmPtr)
-      } catch (e) {
-        alert("Error assembling!\n\n" + e)
-        throw e
-      }
-
-      let output = readRustString(outputPtr)
+  if (g_asmWorker) {
+    let id = ++g_asmNextId
+    g_asmCallbacks[id] = success
+    g_asmWorker.postMessage({ id: id, format: format, source: g_codeEditor.getValue() })
+    return
+  }
 
-      dropRustString(asmPtr)
-      dropRustString(outputPtr)
+  let output = null
+  try {
+    output = g_assembler.assemble(format, g_codeEditor.getValue()).output
+  } catch (e) {
+    alert("Error assembling!\n\n" + e)
+    throw e
+  }
+  success(output)
+}
 
-      success(output)
-    });
+function assembleSoon() {
+  clearTimeout(g_assembleTimer)
+  g_assembleTimer = setTimeout(assemble, ASSEMBLE_DELAY_MS)
 }
 
 function submit() {
@@ -171,7 +200,14 @@ function loadExample(file) {
 }
 
 function assemble() {
+  clearTimeout(g_assembleTimer)
+
+  // only the latest listing is shown, if earlier ones are still queued
+  let request = ++g_assembleLatest
   doAssemble(1, function (output) {
+    if (request != g_assembleLatest)
+      return
+
     output = output.replace("outp | addr |", "    address    |")
     output = output.replace(/\n.*\|(.*)\|/g, function (match, p1, offset, string) {
       return "\n " + parseInt(p1, 16).toString().padEnd(4, ' ') + ": " + hex2bin(p1) + " |";
@@ -223,108 +259,3 @@ function assemble() {
 
   });
 }
-
-
-function makeRustString(str) {
-  //console.log("makeRustString")
-  //console.log(str)
-
-  let bytes = window.TextEncoder ? new TextEncoder("utf-8").encode(str) : stringToUtf8ByteArray(str)
-  //console.log(bytes)
-
-  let ptr = g_wasm.instance.exports.wasm_string_new(bytes.length)
-
-  for (let i = 0; i < bytes.length; i++)
-    g_wasm.instance.exports.wasm_string_set_byte(ptr, i, bytes[i])
-
-  //console.log(ptr)
-  return ptr
-}
-
-
-function readRustString(ptr) {
-  //console.log("readRustString")
-  //console.log(ptr)
-
-  let len = g_wasm.instance.exports.wasm_string_get_len(ptr)
-  //console.log(len)
-
-  let bytes = []
-  for (let i = 0; i < len; i++)
-    bytes.push(g_wasm.instance.exports.wasm_string_get_byte(ptr, i))
-
-  //console.log(bytes)
-
-  let str = window.TextDecoder ? new TextDecoder("utf-8").decode(new Uint8Array(bytes)) : utf8ByteArrayToString(bytes)
-  //console.log(str)
-  return str
-}
-
-
-function dropRustString(ptr) {
-  //console.log("dropRustString")
-  //console.log(ptr)
-
-  g_wasm.instance.exports.wasm_string_drop(ptr)
-}
-
-
-// From https://github.com/google/closure-library/blob/e877b1eac410c0d842bcda118689759512e0e26f/closure/goog/crypt/crypt.js#L115
-function stringToUtf8ByteArray(str) {
-  let out = [],
-    p = 0
-  for (let i = 0; i < str.length; i++) {
-    let c = str.charCodeAt(i)
-    if (c < 128) {
-      out[p++] = c
-    } else if (c < 2048) {
-      out[p++] = (c >> 6) | 192
-      out[p++] = (c & 63) | 128
-    } else if (
-      ((c & 0xFC00) == 0xD800) && (i + 1) < str.length &&
-      ((str.charCodeAt(i + 1) & 0xFC00) == 0xDC00)) {
-      // Surrogate Pair
-      c = 0x10000 + ((c & 0x03FF) << 10) + (str.charCodeAt(++i) & 0x03FF)
-      out[p++] = (c >> 18) | 240
-      out[p++] = ((c >> 12) & 63) | 128
-      out[p++] = ((c >> 6) & 63) | 128
-      out[p++] = (c & 63) | 128
-    } else {
-      out[p++] = (c >> 12) | 224
-      out[p++] = ((c >> 6) & 63) | 128
-      out[p++] = (c & 63) | 128
-    }
-  }
-  return out
-}
-
-
-// From https://github.com/google/closure-library/blob/e877b1eac410c0d842bcda118689759512e0e26f/closure/goog/crypt/crypt.js#L149
-function utf8ByteArrayToString(bytes) {
-  let out = [],
-    pos = 0,
-    c = 0
-  while (pos < bytes.length) {
-    let c1 = bytes[pos++]
-    if (c1 < 128) {
-      out[c++] = String.fromCharCode(c1)
-    } else if (c1 > 191 && c1 < 224) {
-      let c2 = bytes[pos++]
-      out[c++] = String.fromCharCode((c1 & 31) << 6 | c2 & 63)
-    } else if (c1 > 239 && c1 < 365) {
-      // Surrogate Pair
-      let c2 = bytes[pos++]
-      let c3 = bytes[pos++]
-      let c4 = bytes[pos++]
-      let u = ((c1 & 7) << 18 | (c2 & 63) << 12 | (c3 & 63) << 6 | c4 & 63) - 0x10000
-      out[c++] = String.fromCharCode(0xD800 + (u >> 10))
-      out[c++] = String.fromCharCode(0xDC00 + (u & 1023))
-    } else {
-      let c2 = bytes[pos++]
-      let c3 = bytes[pos++]
-      out[c++] =
-        String.fromCharCode((c1 & 15) << 12 | (c2 & 63) << 6 | c3 & 63)
-    }
-  }
-  return out.join('')
-}
\ No newline at end of file
@@ -26,9 +26,15 @@
     mva  {src: reg}              ->  {
 		assert(src != 0b000)
 		0b00 @ 0b000 @ src[2:0] }
-    mvb  {src: reg}              -> 0b00 @ 0b001 @ src[2:0]
-    mvc  {src: reg}              -> 0b00 @ 0b010 @ src[2:0]
-    mvd  {src: reg}              -> 0b00 @ 0b011 @ src[2:0]
+    mvb  {src: reg}              ->  {
+		assert(src != 0b001)
+		0b00 @ 0b001 @ src[2:0] }
+    mvc  {src: reg}              ->  {
+		assert(src != 0b010)
+		0b00 @ 0b010 @ src[2:0] }
+    mvd  {src: reg}              ->  {
+		assert(src != 0b011)
+		0b00 @ 0b011 @ src[2:0] }
     acc  {src: reg}              -> 0b00 @ 0b110 @ src[2:0]
     mva  #{value}                -> 0b00 @ 0b000 @ 0b111 @ value[7:0]
     mvb  #{value}                -> 0b00 @ 0b001 @ 0b111 @ value[7:0]
@@ -89,6 +95,11 @@
     lsh                          -> 0b110 @ 0b011 @ 0b01
     rol                          -> 0b111 @ 0b011 @ 0b01
 
+    mul                          -> 0b111 @ 0b001 @ 0b01 ; wide step rom only: Ra += Rb * Rc
+    cpy                          -> 0b111 @ 0b010 @ 0b01 ; wide step rom only: Rc bytes *Ra -> *Rd
+    add16                        -> 0b111 @ 0b101 @ 0b01 ; wide step rom only: 16-bit *Ra += *Rd
+    sub16                        -> 0b111 @ 0b110 @ 0b01 ; wide step rom only: 16-bit *Ra -= *Rd
+
     and  {dest: reg}, Rb         -> 0b110 @ 0b110 @ dest[1:0]
     or   {dest: reg}, Rb         -> 0b110 @ 0b101 @ dest[1:0]
     xor  {dest: reg}, Rb         -> 0b110 @ 0b100 @ dest[1:0]
@@ -0,0 +1,11 @@
+; shift unit instructions, emulator only: they need the rom MicrocodeTools -s
+; writes (rom-shift.hex). the EEPROMs and the standard rom decode these
+; opcodes as "mov X, X", which does nothing.
+;
+; these rules go inside the #cpudef block of troyscpudef.asm (as
+; Emulator/SimBench/corpus/assemble.js does for examples/shift/)
+
+    shl  Rb                      -> 0b00 @ 0b001 @ 0b001 ; Rb << 1, C = bit 7
+    shr  Rb                      -> 0b00 @ 0b010 @ 0b010 ; Rb >> 1, C = bit 0
+    rlc  Rb                      -> 0b00 @ 0b011 @ 0b011 ; rotate left, C = bit 7
+    rrc  Rb                      -> 0b00 @ 0b100 @ 0b100 ; rotate right, C = bit 0
@@ -0,0 +1,165 @@
+/*
+ * Troy's 8-bit computer - Clock scheduler for the web emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// decides how many cycles to run in each batch (a frame on the page, a
+// slice in cpemu_worker.js) to hold a target clock rate:
+//
+//   var clock = CpEmuClock.create(hz, budgetMs);
+//   var n = clock.due(now);            // cycles to run now
+//   ... run n (or fewer, eg. halted) ...
+//   clock.ran(cyclesRun, msTaken, instructionsRun);
+//
+// the target is kept against the wall clock since the last restart, so a
+// late or short batch is made up by the next ones. batches are capped to
+// what the host runs in budgetMs, and a backlog of more than MAX_BEHIND_MS
+// (a slow host, a background tab) is dropped rather than burst through.
+// hz of 0 runs flat out: every batch fills the budget
+//
+// achievedHz and instructionsPerSec are measured over WINDOW_MS
+
+var CpEmuClock = (function ()
+{
+  var MAX_BEHIND_MS = 100;
+  var WINDOW_MS = 500;
+  var INITIAL_RATE = 100;   // cycles per ms, until measured
+  var RATE_MS = 4;          // host time the rate is measured over
+
+  return {
+    // clock rates offered by the speed buttons. 0 = as fast as possible
+    RATES: [1, 2, 5, 10, 20, 50, 100, 200, 500, 1e3, 2e3, 5e3, 1e4, 2e4, 5e4,
+            1e5, 2e5, 5e5, 1e6, 2e6, 5e6, 1e7, 0],
+
+    // "1.00 Hz", "2.50 kHz"
+    format: function (hz)
+    {
+      var units = ["Hz", "kHz", "MHz", "GHz"];
+      var u = 0;
+      while (hz >= 1000 && u < units.length - 1)
+      {
+        hz /= 1000;
+        ++u;
+      }
+      return (hz >= 100 ? hz.toFixed(0) : hz >= 10 ? hz.toFixed(1) : hz.toFixed(2)) + " " + units[u];
+    },
+
+    // nearest entry in RATES (0 only for 0)
+    nearestRate: function (hz)
+    {
+      if (hz <= 0) return 0;
+      var best = this.RATES[0];
+      for (var i = 0; i < this.RATES.length; ++i)
+      {
+        var r = this.RATES[i];
+        if (r > 0 && Math.abs(Math.log(r / hz)) < Math.abs(Math.log(best / hz)))
+        {
+          best = r;
+        }
+      }
+      return best;
+    },
+
+    create: function (hz, budgetMs)
+    {
+      return {
+        hz: hz > 0 ? hz : 0,
+        budgetMs: budgetMs,
+        rate: INITIAL_RATE,   // measured cycles per ms of host time
+        rateCycles: 0,
+        rateMs: 0,
+        startMs: null,        // pacing reference
+        startCycles: 0,
+        cycles: 0,            // total cycles run
+        instructions: 0,      // total instructions run (if reported)
+        achievedHz: 0,
+        instructionsPerSec: 0,
+        windowMs: null,
+        windowCycles: 0,
+        windowInstructions: 0,
+
+        restart: function (now)
+        {
+          this.startMs = now;
+          this.startCycles = this.cycles;
+        },
+
+        setHz: function (hz, now)
+        {
+          this.hz = hz > 0 ? hz : 0;
+          this.restart(now);
+        },
+
+        due: function (now)
+        {
+          if (this.startMs === null)
+          {
+            this.restart(now);
+          }
+
+          var budget = Math.max(1, Math.floor(this.rate * this.budgetMs));
+          if (this.hz <= 0)
+          {
+            return budget;
+          }
+
+          var due = Math.floor((now - this.startMs) * this.hz / 1000) - (this.cycles - this.startCycles);
+          var maxBehind = Math.max(1, Math.ceil(this.hz * MAX_BEHIND_MS / 1000));
+          if (due > maxBehind)
+          {
+            this.startCycles -= due - maxBehind;
+            due = maxBehind;
+          }
+          return Math.max(0, Math.min(due, budget));
+        },
+
+        ran: function (cycles, ms, instructions)
+        {
+          this.cycles += cycles;
+          this.instructions += instructions || 0;
+
+          // short batches are pooled until they can be timed
+          this.rateCycles += cycles;
+          this.rateMs += ms;
+          if (this.rateMs >= RATE_MS)
+          {
+            this.rate = (this.rate + this.rateCycles / this.rateMs) / 2;
+            this.rateCycles = 0;
+            this.rateMs = 0;
+          }
+        },
+
+        // call once per batch or frame with the current time
+        sample: function (now)
+        {
+          if (this.windowMs === null)
+          {
+            this.windowMs = now;
+            this.windowCycles = this.cycles;
+            this.windowInstructions = this.instructions;
+          }
+          else if (now - this.windowMs >= WINDOW_MS)
+          {
+            var seconds = (now - this.windowMs) / 1000;
+            this.achievedHz = (this.cycles - this.windowCycles) / seconds;
+            this.instructionsPerSec = (this.instructions - this.windowInstructions) / seconds;
+            this.windowMs = now;
+            this.windowCycles = this.cycles;
+            this.windowInstructions = this.instructions;
+          }
+        },
+      };
+    },
+  };
+})();
+
+if (typeof module !== 'undefined')
+{
+  module.exports = CpEmuClock;
+}
@@ -0,0 +1,108 @@
+/*
+ * Troy's 8-bit computer - Input recording for the web emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// records the input (Rd) changes of a session against the clock cycles run
+// since the reset, as an input script (Emulator/SimLib/inputscript.h) that
+// simcli -s or simLibSetInputScript play back at the same cycles. whoever
+// runs the core (cpemu_worker.js, or the page) feeds it the cycles it runs,
+// resets and inputs
+
+var CpEmuInput = (function ()
+{
+  var hex = function (value)
+  {
+    return (value & 0xff).toString(16).padStart(2, "0");
+  };
+
+  return {
+    // play script text in the core (simLibSetInputScript). its cycles count
+    // from the machine's next reset, which is up to the caller. returns 0,
+    // the line number of a malformed line, or -1 if the build can't play
+    // scripts
+    setScript: function (Module, text)
+    {
+      if (!Module._simLibSetInputScript)
+      {
+        return -1;
+      }
+
+      // scripts can be long: copied to the heap rather than ccall's stack
+      var bytes = new TextEncoder().encode(text || "");
+      var ptr = Module._malloc(bytes.length + 1);
+      Module.HEAPU8.set(bytes, ptr);
+      Module.HEAPU8[ptr + bytes.length] = 0;
+      var error = Module._simLibSetInputScript(ptr);
+      Module._free(ptr);
+      return error;
+    },
+
+    recorder: function ()
+    {
+      var cycles = 0;
+      var lines = null;     // null when not recording
+      var last = -1;
+
+      return {
+        // the machine was reset: cycles count from here, and a recording
+        // starts over
+        restart: function ()
+        {
+          cycles = 0;
+          last = -1;
+          if (lines)
+          {
+            lines = lines.slice(0, 1);
+          }
+        },
+
+        ran: function (n)
+        {
+          cycles += n;
+        },
+
+        input: function (value)
+        {
+          if (lines && value != last)
+          {
+            lines.push(cycles + " " + hex(value));
+          }
+          last = value;
+        },
+
+        // the caller resets the machine, so the recording plays back from
+        // a reset
+        start: function ()
+        {
+          lines = ["# recorded " + new Date().toISOString()];
+          this.restart();
+        },
+
+        // the script text
+        stop: function ()
+        {
+          var text = lines ? lines.join("\n") + "\n" : "";
+          lines = null;
+          return text;
+        },
+
+        recording: function ()
+        {
+          return lines !== null;
+        },
+      };
+    },
+  };
+})();
+
+if (typeof module !== 'undefined')
+{
+  module.exports = CpEmuInput;
+}
@@ -0,0 +1,84 @@
+/*
+ * Troy's 8-bit computer - Program loading for the web emulator
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// programs come as hex (?h=): 512 digits of program memory, then ram.
+// they go to the core as binary images copied into the heap
+// (simLibLoadProgramBytes, simLibLoadRamBytes)
+
+var CpEmuLoad = (function ()
+{
+  var IMAGE_BYTES = 256;
+
+  // hex digit values + 1, 0 for anything else (as computer.c)
+  var digits = new Uint8Array(128);
+  "0123456789abcdef".split("").forEach(function (ch, i)
+  {
+    digits[ch.charCodeAt(0)] = i + 1;
+    digits[ch.toUpperCase().charCodeAt(0)] = i + 1;
+  });
+
+  var digit = function (hex, i)
+  {
+    var code = hex.charCodeAt(i);
+    return code < 128 ? digits[code] : 0;
+  };
+
+  var loadImage = function (Module, fn, hex)
+  {
+    var bytes = CpEmuLoad.hexBytes(hex);
+    var ptr = Module._malloc(bytes.length || 1);
+    Module.HEAPU8.set(bytes, ptr);
+    Module['_' + fn + 'Bytes'](ptr, bytes.length);
+    Module._free(ptr);
+  };
+
+  return {
+    // up to 256 bytes from pairs of hex digits. a pair that isn't two hex
+    // digits reads as its first digit, or 0
+    hexBytes: function (hex)
+    {
+      var bytes = new Uint8Array(Math.min(hex.length >> 1, IMAGE_BYTES));
+      for (var i = 0; i < bytes.length; ++i)
+      {
+        var high = digit(hex, i * 2);
+        var low = digit(hex, i * 2 + 1);
+        bytes[i] = !high ? 0 : !low ? high - 1 : (high - 1) << 4 | (low - 1);
+      }
+      return bytes;
+    },
+
+    // program hex, and ram hex (default: whatever follows the program).
+    // throws if the core can't take binary images (an out of date build)
+    load: function (Module, program, ram)
+    {
+      if (!Module._simLibLoadProgramBytes || !Module._simLibLoadRamBytes)
+      {
+        throw new Error("can't load the program: cpemu.wasm has no simLibLoadProgramBytes, " +
+          "rebuild it with Emulator/SimWasm/build.sh");
+      }
+
+      program = program || "";
+      ram = ram || program.substring(512);
+      program = program.substring(0, 512);
+
+      loadImage(Module, 'simLibLoadProgram', program);
+      if (ram)
+      {
+        loadImage(Module, 'simLibLoadRam', ram);
+      }
+    },
+  };
+})();
+
+if (typeof module !== 'undefined')
+{
+  module.exports = CpEmuLoad;
+}
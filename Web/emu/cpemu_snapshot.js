@@ -0,0 +1,121 @@
+/*
+ * Troy's 8-bit computer - Machine state snapshots shared between the
+ * emulator worker (cpemu_worker.js) and the front-end
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// the worker publishes the machine state into a SharedArrayBuffer guarded
+// by a seqlock: the sequence word is odd while a snapshot is being written.
+// a reader copies the snapshot and keeps it only if the sequence was even
+// and unchanged across the copy. the writer never waits for readers.
+// pages that aren't cross origin isolated have no SharedArrayBuffer: the
+// worker then posts copies of its snapshot instead (cpemu_worker.js)
+//
+// layout (byte offsets):
+//
+//   0    int32[16]   sequence, controlWord, lcdWrites, running, halted,
+//                    lcdPixelsX, lcdPixelsY, lcdGeneration (changes
+//                    whenever the pixels do. rest reserved)
+//   64   float64[4]  cycles, achieved hz, instructions per second (-1 if
+//                    the core doesn't count them), target hz (0 = max)
+//   96   uint8[16]   component values (SIComponent order, siminst.h)
+//   112  uint8[256]  ram
+//   368  uint8[256]  pgm
+//   624  int8[4096]  lcd pixel states (vrEmuLcdPixelState), row major
+
+var CpEmuSnapshot = (function ()
+{
+  var WORDS = 16;
+  var VALUES = 96;
+  var RAM = 112;
+  var PGM = 368;
+  var PIXELS = 624;
+  var MAX_PIXELS = 4096;
+  var READ_ATTEMPTS = 8;
+
+  var Word = {
+    Sequence: 0,
+    ControlWord: 1,
+    LcdWrites: 2,
+    Running: 3,
+    Halted: 4,
+    LcdPixelsX: 5,
+    LcdPixelsY: 6,
+    LcdGeneration: 7,
+  };
+
+  var views = function (buffer)
+  {
+    return {
+      buffer: buffer,
+      words: new Int32Array(buffer, 0, WORDS),
+      numbers: new Float64Array(buffer, 64, 4),
+      values: new Uint8Array(buffer, VALUES, 16),
+      ram: new Uint8Array(buffer, RAM, 256),
+      pgm: new Uint8Array(buffer, PGM, 256),
+      pixels: new Int8Array(buffer, PIXELS, MAX_PIXELS),
+    };
+  };
+
+  return {
+    Word: Word,
+    SIZE: PIXELS + MAX_PIXELS,
+    MAX_PIXELS: MAX_PIXELS,
+
+    // a snapshot in a SharedArrayBuffer, or a private copy of one in an
+    // ArrayBuffer (no argument)
+    create: function (buffer)
+    {
+      if (!buffer)
+      {
+        buffer = new ArrayBuffer(this.SIZE);
+      }
+      return views(buffer);
+    },
+
+    // writer side. fill() updates the snapshot in place between the two
+    // sequence stores
+    write: function (snapshot, fill)
+    {
+      var sequence = Atomics.load(snapshot.words, Word.Sequence);
+      Atomics.store(snapshot.words, Word.Sequence, sequence + 1);
+      fill(snapshot);
+      Atomics.store(snapshot.words, Word.Sequence, sequence + 2);
+    },
+
+    // reader side. copies a consistent snapshot from shared into copy and
+    // returns true, or returns false (leaving copy as it was) if the writer
+    // kept it busy for every attempt
+    read: function (shared, copy)
+    {
+      var src = new Uint8Array(shared.buffer, 0, this.SIZE);
+      var dst = new Uint8Array(copy.buffer, 0, this.SIZE);
+      for (var attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+      {
+        var before = Atomics.load(shared.words, Word.Sequence);
+        if (before & 1)
+        {
+          continue;
+        }
+
+        dst.set(src);
+        if (Atomics.load(shared.words, Word.Sequence) == before)
+        {
+          return true;
+        }
+      }
+      return false;
+    },
+  };
+})();
+
+if (typeof module !== 'undefined')
+{
+  module.exports = CpEmuSnapshot;
+}
@@ -97,6 +97,8 @@ var ratio = 1.0,
   yoff = 0.0,
   scale = 1.0;
 
+var canvasResized = true;  // the next frame is drawn in full
+
 window.addEventListener('resize', resizeCanvas, false);
 document.onload = resizeCanvas;
 img.onload = resizeCanvas;
@@ -321,7 +323,7 @@ function resizeCanvas()
 
   ctx.fillStyle = "#262626";
   ctx.fillRect(0, 0, canv.width, canv.height);
-
+  canvasResized = true;
 }
 resizeCanvas();
 
@@ -375,8 +377,6 @@ Module.onRuntimeInitialized = function ()
   simLib = {
     initialise: Module.cwrap('simLibInitialise', null),
     destroy: Module.cwrap('simLibDestroy', null),
-    loadProgram: Module.cwrap('simLibLoadProgram', null, ['string']),
-    loadRam: Module.cwrap('simLibLoadRam', null, ['string']),
     ramByte: Module.cwrap('simLibRamByte', 'number', ['number']),
     setInput: Module.cwrap('simLibSetInput', null, ['number']),
     setClock: Module.cwrap('simLibSetClock', null, ['number']),
@@ -390,7 +390,199 @@ Module.onRuntimeInitialized = function ()
 
   simLib.initialise();
 
+  // machine state is read straight from the wasm heap (SIStateBlock in
+  // siminst.h), which simLibGetState refreshes once a frame (refreshState).
+  // builds without simLibGetState fall back to a call per value
+  var STATE_VERSION = 4;
+  var statePtr = Module._simLibGetState ? Module._simLibGetState() : 0;
+  var state = null;
+
+  var mapState = function ()
+  {
+    if (!statePtr || (state && state.buffer === Module.HEAPU8.buffer))
+    {
+      return;
+    }
+
+    var buffer = Module.HEAPU8.buffer;
+    var words = new Uint32Array(buffer, statePtr, 6);
+    if (words[0] != STATE_VERSION)
+    {
+      statePtr = 0;
+      state = null;
+      return;
+    }
+
+    state = {
+      buffer: buffer,
+      words: words,   // version, size, updates, tick, controlWord, lcdWrites
+      values: new Uint8Array(buffer, statePtr + 24, 16),
+      ram: new Uint8Array(buffer, statePtr + 40, 256),
+      pgm: new Uint8Array(buffer, statePtr + 296, 256),
+      instructions: new Uint32Array(buffer, statePtr + 552, 1),
+      lcd: new Int32Array(buffer, statePtr + 556, 2),   // lcdFlags, lcdCursor
+    };
+  };
+
+  // registers, memory and lcd flags are copied into the block only when
+  // asked for. the counters in words[] are kept current by every call
+  var refreshState = function ()
+  {
+    if (state)
+    {
+      Module._simLibGetState();
+    }
+  };
+
+  // the core runs flat out or paced in cpemu_worker.js and this page only
+  // renders its snapshots at display refresh. cross origin isolated pages
+  // (COOP/COEP headers) share the snapshot in a SharedArrayBuffer; without
+  // them, as hosted, the worker posts a copy of it at most once a frame.
+  // ?w=0 keeps the core on the page
+  var worker = null;
+  var shared = null;
+  var frame = null;
+  if (window.Worker && getParam("w") != "0")
+  {
+    if (typeof SharedArrayBuffer !== 'undefined' && window.crossOriginIsolated)
+    {
+      shared = CpEmuSnapshot.create(new SharedArrayBuffer(CpEmuSnapshot.SIZE));
+    }
+    frame = CpEmuSnapshot.create();
+    worker = new Worker("cpemu_worker.js");
+  }
+
+  var getValue = function (component)
+  {
+    if (frame) return frame.values[component];
+    return state ? state.values[component] : simLib.getValue(component);
+  };
+
+  var getControlWord = function ()
+  {
+    if (frame) return frame.words[CpEmuSnapshot.Word.ControlWord];
+    return state ? state.words[4] : simLib.getControlWord();
+  };
+
+  var ramByte = function (offset)
+  {
+    if (frame) return frame.ram[offset];
+    return state ? state.ram[offset] : simLib.ramByte(offset);
+  };
+
+  // run up to n whole cycles on the page. returns the number run. builds
+  // without simLibRun are clocked an edge at a time
+  var runCycles = function (n)
+  {
+    if (Module._simLibRun)
+    {
+      return Module._simLibRun(n) >>> 0;
+    }
+    for (var i = 0; i < n; ++i)
+    {
+      if (getControlWord() & (1 << 23))
+      {
+        return i;
+      }
+      Module._simLibSetClock(0);
+      Module._simLibSetClock(1);
+    }
+    return n;
+  };
+
+  var getInstructions = function ()
+  {
+    return state ? state.instructions[0] : 0;
+  };
+
+  // inputs are recorded (R) by whichever runs the core: the worker, or
+  // this recorder for the page
+  var recorder = CpEmuInput.recorder();
+  var recording = false;
+
+  var setInput = function (value)
+  {
+    if (worker) worker.postMessage({ cmd: "input", value: value });
+    else simLib.setInput(value);
+    recorder.input(value);
+  };
+
+  var saveRecording = function (text)
+  {
+    var link = document.createElement("a");
+    link.href = URL.createObjectURL(new Blob([text], { type: "text/plain" }));
+    link.download = "session.input";
+    link.click();
+    URL.revokeObjectURL(link.href);
+  };
+
+  // recording restarts the program, so the script plays back from a reset
+  // (simcli -s, or ?in=)
+  var toggleRecording = function ()
+  {
+    recording = !recording;
+    document.title = (recording ? "\u25cf " : "") + document.title.replace(/^\u25cf /, "");
+    if (worker)
+    {
+      worker.postMessage({ cmd: "record", on: recording });
+    }
+    else if (recording)
+    {
+      simLib.reset();
+      recorder.start();
+    }
+    else
+    {
+      saveRecording(recorder.stop());
+    }
+  };
+
+  var playScript = function (text)
+  {
+    if (worker)
+    {
+      worker.postMessage({ cmd: "script", text: text });
+      return;
+    }
+
+    var error = CpEmuInput.setScript(Module, text);
+    if (error == 0)
+    {
+      simLib.reset();
+      recorder.restart();
+    }
+    reportScript(error);
+  };
+
+  // problems the user needs to know about (the program or the input script
+  // didn't load), not just the console
+  var showError = function (text)
+  {
+    console.error(text);
+    alert(text);
+  };
+
+  var reportScript = function (error)
+  {
+    if (error < 0) showError("can't play the input script: cpemu.wasm has no simLibSetInputScript, rebuild it with Emulator/SimWasm/build.sh");
+    else if (error > 0) showError("input script: malformed line " + error);
+  };
+
+  mapState();
+  if (!worker && !state)
+  {
+    // still runs, a call per value and the lcd redrawn every blink interval
+    console.warn("cpemu.wasm has no state block (simLibGetState v" + STATE_VERSION +
+      "), rebuild it with Emulator/SimWasm/build.sh");
+  }
+
   lcd = vrEmuLcd.registerLcd(simLib.getLcd());
+  if (worker)
+  {
+    // same size lcd, drawn from the worker's pixels
+    lcd.updatePixels = function () {};
+    lcd.pixelState = function (x, y) { return frame.pixels[y * this.numPixelsX + x]; };
+  }
   //lcd.colorScheme = vrEmuLcd.Schemes.GreenBlack;
 
   var programHex = getParam("h");
@@ -401,21 +593,42 @@ Module.onRuntimeInitialized = function ()
 
   var ramData = programHex.substring(512);
 
-  simLib.loadProgram(programHex.substring(0, 512));
-  
-  if (ramData) 
+  try
+  {
+    CpEmuLoad.load(Module, programHex.substring(0, 512), ramData);
+  }
+  catch (e)
   {
-    simLib.loadRam(ramData);
+    // the worker loads its own copy: it reports the same error
+    if (!worker) showError(e.message);
   }
 
   var tick = 0;
   var lastTick = 0;
   var lastD = 0;
   var autoClock = true;
-  var speed = parseInt(getParam("s"));
-  if (!speed) speed = 100;
-  if (speed < 0) speed = 1;
-  if (speed > 500) speed = 500;
+
+  // target clock rate: an index into CpEmuClock.RATES, stepped by the speed
+  // buttons. ?hz= picks the nearest rate (0 = max). ?s= is the old speed
+  // setting (0 - 500), which was a half cycle per 200 / s ms up to 150
+  var rateIndex = CpEmuClock.RATES.indexOf(200);
+  var hzParam = parseFloat(getParam("hz"));
+  var speedParam = parseInt(getParam("s"));
+  if (hzParam >= 0)
+  {
+    rateIndex = CpEmuClock.RATES.indexOf(CpEmuClock.nearestRate(hzParam));
+  }
+  else if (speedParam > 0)
+  {
+    rateIndex = CpEmuClock.RATES.indexOf(speedParam >= 500 ? 0 : CpEmuClock.nearestRate(speedParam * 2.5));
+  }
+
+  var targetHz = function ()
+  {
+    return CpEmuClock.RATES[rateIndex];
+  };
+
+  var showStats = getParam("stats") != "0";
   
   var clkMode = { x: 280, y: 173 }
   var step = { x: 188, y: 188 }
@@ -450,8 +663,14 @@ Module.onRuntimeInitialized = function ()
        case 40:
           inputByte |= BTN_DOWN;
           break;
+       case 80:
+          showStats = !showStats;
+          return;
+       case 82:
+          toggleRecording();
+          return;
     }
-    simLib.setInput(inputByte);
+    setInput(inputByte);
   };
   document.onkeyup = function(event) {
     switch (event.keyCode) {
@@ -468,7 +687,7 @@ Module.onRuntimeInitialized = function ()
           inputByte &= ~BTN_DOWN;
           break;
     }
-    simLib.setInput(inputByte);
+    setInput(inputByte);
   };
 
 
@@ -481,16 +700,16 @@ Module.onRuntimeInitialized = function ()
     }
     else if (getMouseDist(evt, spdUp) < getXSize(30))
     {
-      if (speed < 500)
+      if (rateIndex < CpEmuClock.RATES.length - 1)
       {
-        speed += 20;
+        ++rateIndex;
       }
     }
     else if (getMouseDist(evt, spdDn) < getXSize(30))
     {
-      if (speed > 0)
+      if (rateIndex > 0)
       {
-        speed -= 20;
+        --rateIndex;
       }
     }
     else if (getMouseDist(evt, dispNeg) < getXSize(30))
@@ -590,241 +809,591 @@ Module.onRuntimeInitialized = function ()
     }
   }
 
-  var renderByte = function (img, val, arr, sz)
+  var wasRunning = true;
+
+  // change driven drawing. each group of leds (and the 7 segment display,
+  // the lcd and the stats) remembers the value it last drew and is only
+  // drawn again when that changes: base.jpg is restored under the group and
+  // every group overlapping it is redrawn, in the original drawing order,
+  // clipped to it. led and digit sprites are pre-scaled into an atlas
+  var SEG_W = 60;
+  var SEG_H = 77;
+  var LED_SPRITES = [
+    [glow_red, 100], [glow_yellow, 100], [glow_green, 100], [glow_blue, 100],
+    [on_red, 100], [on_red_br, 100], [on_red_tc, 100], [on_yellow_br, 100],
+    [on_yellow_bl, 100], [on_green_br, 100], [on_green_bl, 100], [on_green_l, 100],
+    [on_blue, 100], [glow_green, 60], [on_green_bl, 60]
+  ];
+  var SEG_IMAGES = [seg_a, seg_b, seg_c, seg_d, seg_e, seg_f, seg_g];
+  var GLYPHS = seg_digits.concat([segg_f]);  // digits, then the minus sign
+
+  var atlas = null;
+
+  var imagesReady = function ()
   {
-    if (!sz) sz = 100;
-    for (var a = 0; a < arr.length; ++a)
+    for (var i = 0; i < LED_SPRITES.length; ++i)
     {
-      if (val & (1 << a))
-      {
-        drawScaled(img, arr[a].x, arr[a].y, sz, sz);
-      }
+      if (!LED_SPRITES[i][0].complete || LED_SPRITES[i][0].naturalHeight === 0) return false;
     }
-  }
-  
-  var wasRunning = true;
-  var loop = function ()
-  {
-    var stepsPerCycle = 0;
-    if (autoClock && (speed > 150))
+    for (var s = 0; s < SEG_IMAGES.length; ++s)
     {
-        stepsPerCycle = (speed - 150) + 1;
+      if (!SEG_IMAGES[s].complete || SEG_IMAGES[s].naturalHeight === 0) return false;
     }
+    return img.complete && img.naturalHeight !== 0;
+  };
 
-    for (var i = stepsPerCycle; i >=0; --i)
+  var newCanvas = function (w, h)
+  {
+    if (typeof OffscreenCanvas !== 'undefined')
     {
+      return new OffscreenCanvas(w, h);
+    }
+    var c = document.createElement("canvas");
+    c.width = w;
+    c.height = h;
+    return c;
+  };
 
-      if (autoClock)
-      {
-        ++tick;
-      }
-      if (lastTick != tick)
-      {
-        simLib.setClock(tick % 2);
-        lastTick = tick;
-      }
-      
-      if (i > 0)
+  // bakes every sprite at the current scale. cells are found by image and
+  // size (leds) or segment mask (glyphs)
+  var buildAtlas = function ()
+  {
+    var ATLAS_W = 1024;
+    var cells = [];
+    var x = 0, y = 0, rowH = 0;
+    var place = function (w, h)
+    {
+      var cw = Math.ceil(getXSize(w)) + 1;
+      var ch = Math.ceil(getYSize(h)) + 1;
+      if (x + cw > ATLAS_W)
       {
-          // only render on the last cycle
-          continue;
+        x = 0;
+        y += rowH;
+        rowH = 0;
       }
-      
-      ctx.fillStyle = "#262626f0";
-      ctx.fillRect(0, 0, canv.width, canv.height);
-      drawScaled(img, 0, 0, $(img).width(), $(img).height());
-      
-      var cwv = simLib.getControlWord();
-      var isRunning = (cwv & (1 << 23)) == 0;
-
-      if (isRunning != wasRunning)
+      var cell = { x: x, y: y, w: cw, h: ch };
+      x += cw;
+      rowH = Math.max(rowH, ch);
+      return cell;
+    };
+
+    var leds = LED_SPRITES.map(function (s) { return { img: s[0], size: s[1], cell: place(s[1], s[1]) }; });
+    var glyphs = GLYPHS.map(function (mask) { return { mask: mask, cell: place(SEG_W, SEG_H) }; });
+
+    var canvas = newCanvas(ATLAS_W, y + rowH);
+    var actx = canvas.getContext("2d");
+    leds.forEach(function (l)
+    {
+      actx.drawImage(l.img, l.cell.x, l.cell.y, getXSize(l.size), getYSize(l.size));
+    });
+    glyphs.forEach(function (g)
+    {
+      for (var s = 0; s < SEG_IMAGES.length; ++s)
       {
-        var ramImage = ""
-        for (var i = 0; i < 256; ++i)
+        if (g.mask & (1 << s))
         {
-          var b = simLib.ramByte(i);
-          ramImage += b.toString(16).padStart(2, '0');
+          actx.drawImage(SEG_IMAGES[s], g.cell.x, g.cell.y, getXSize(SEG_W), getYSize(SEG_H));
         }
-        console.log(ramImage);
-        console.log(tick);
       }
-      wasRunning = isRunning;
+    });
 
-      if (isResetting)
+    return {
+      canvas: canvas,
+      scale: scale,
+      led: function (image, size)
       {
-        simLib.reset();
-      }
+        for (var i = 0; i < leds.length; ++i)
+        {
+          if (leds[i].img === image && leds[i].size == size) return leds[i].cell;
+        }
+        return null;
+      },
+      glyph: function (mask)
+      {
+        for (var i = 0; i < glyphs.length; ++i)
+        {
+          if (glyphs[i].mask == mask) return glyphs[i].cell;
+        }
+        return null;
+      },
+    };
+  };
 
-      var rav = simLib.getValue(Component.Ra);
-      renderByte(glow_red, rav, ledDefs.ra);
-      renderByte(on_red_br, rav, ledDefs.ra);
+  var drawCell = function (cell, x, y)
+  {
+    ctx.drawImage(atlas.canvas, cell.x, cell.y, cell.w, cell.h, getXPos(x), getYPos(y), cell.w, cell.h);
+  };
 
-      var rbv = simLib.getValue(Component.Rb);
-      renderByte(glow_red, rbv, ledDefs.rb);
-      renderByte(on_red, rbv, ledDefs.rb);
+  // leds lit by the bits of a value: all glows, then all on states (or
+  // each led's glow and on state in turn, interleaved)
+  var ledGroup = function (leds, glow, on, size, interleaved)
+  {
+    size = size || 100;
+    var x0 = Infinity, y0 = Infinity, x1 = -Infinity, y1 = -Infinity;
+    leds.forEach(function (l)
+    {
+      x0 = Math.min(x0, l.x); y0 = Math.min(y0, l.y);
+      x1 = Math.max(x1, l.x + size); y1 = Math.max(y1, l.y + size);
+    });
 
-      var rcv = simLib.getValue(Component.Rc);
-      renderByte(glow_red, rcv, ledDefs.rc);
-      renderByte(on_red_tc, rcv, ledDefs.rc);
+    return {
+      rect: { x: x0, y: y0, w: x1 - x0, h: y1 - y0 },
+      draw: function (value)
+      {
+        var glowCell = atlas.led(glow, size);
+        var onCell = atlas.led(on, size);
+        for (var a = 0; a < leds.length; ++a)
+        {
+          if (value & (1 << a))
+          {
+            drawCell(glowCell, leds[a].x, leds[a].y);
+            if (interleaved) drawCell(onCell, leds[a].x, leds[a].y);
+          }
+        }
+        if (interleaved)
+        {
+          return;
+        }
+        for (var b = 0; b < leds.length; ++b)
+        {
+          if (value & (1 << b)) drawCell(onCell, leds[b].x, leds[b].y);
+        }
+      },
+    };
+  };
 
-      var segSizeX = 60;
-      var segSizeY = 77;
+  // the 7 segment glyph masks for the display: digits 0 - 2, then the sign
+  var displayMasks = function (rdv)
+  {
+    var masks = [0, 0, 0, 0];
+    if (dispMode == 1 && (rdv & 0x80))
+    {
+      rdv = Math.abs(256 - rdv);
+      masks[3] = segg_f;
+    }
 
-      var rdv = simLib.getValue(Component.Rd);
-      if (dispMode == 1)
+    if (dispMode == 2)
+    {
+      var hex = rdv.toString(16).padStart(3, '0');
+      for (var dig = 0; dig < 3; ++dig)
       {
-        if (rdv & 0x80)
+        var digit = hex.charCodeAt(hex.length - (dig + 1));
+        if (dig == 2)
         {
-          rdv = Math.abs(256 - rdv);
-          drawScaled(seg_g, ledDefs.rd[3].x, ledDefs.rd[3].y, segSizeX, segSizeY);
+          digit = 16;
         }
+        else if (digit >= 97) digit -= 87;
+        else if (digit >= 65) digit -= 55;
+        else digit -= 48;
+        masks[dig] = seg_digits[digit];
+      }
+    }
+    else
+    {
+      for (var d = 0; d < 3; ++d)
+      {
+        masks[d] = seg_digits[Math.floor((rdv / Math.pow(10, d))) % 10];
       }
+    }
+    return masks;
+  };
 
-      if (dispMode == 2)
+  var displayGroup = {
+    rect: { x: ledDefs.rd[3].x, y: ledDefs.rd[0].y, w: ledDefs.rd[0].x + SEG_W - ledDefs.rd[3].x, h: SEG_H + 2 },
+    draw: function (value)
+    {
+      var masks = value.split(",");
+      for (var d = 0; d < 4; ++d)
       {
-        var hex = rdv.toString(16).padStart(3, '0');
-        for (var dig = 0; dig < 3; ++dig)
-        {
-          var digit = hex.charCodeAt(hex.length - (dig + 1));
-          if (dig == 2)
-          {
-            digit = 16;
-          }
-          else if (digit >= 97) digit -= 87;
-          else if (digit >= 65) digit -= 55;
-          else digit -= 48;
-
-          var segs = seg_digits[digit];
-          if (segs & sega_f) drawScaled(seg_a, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segb_f) drawScaled(seg_b, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segc_f) drawScaled(seg_c, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segd_f) drawScaled(seg_d, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & sege_f) drawScaled(seg_e, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segf_f) drawScaled(seg_f, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segg_f) drawScaled(seg_g, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-        }
+        if (masks[d] != 0) drawCell(atlas.glyph(+masks[d]), ledDefs.rd[d].x, ledDefs.rd[d].y);
       }
-      else
+    },
+  };
+
+  var lcdGroup = {
+    rect: { x: 313, y: 711, w: 674, h: 177 },
+    draw: function ()
+    {
+      lcd.render(ctx, getXPos(340), getYPos(780), getXSize(300), getYSize(106));
+      drawScaled(lcdimg, 313, 711, 674, 177);
+    },
+  };
+
+  var statsGroup = {
+    rect: { x: 10, y: 10, w: 330, h: 30 * 4 + 12 },
+    draw: function (value)
+    {
+      if (!value)
       {
-        for (var dig = 0; dig < 3; ++dig)
-        {
-          var digit = Math.floor((rdv / Math.pow(10, dig))) % 10;
-          var segs = seg_digits[digit];
-          if (segs & sega_f) drawScaled(seg_a, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segb_f) drawScaled(seg_b, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segc_f) drawScaled(seg_c, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segd_f) drawScaled(seg_d, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & sege_f) drawScaled(seg_e, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segf_f) drawScaled(seg_f, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-          if (segs & segg_f) drawScaled(seg_g, ledDefs.rd[dig].x, ledDefs.rd[dig].y, segSizeX, segSizeY);
-        }
+        return;
+      }
+      var lines = value.split("\n");
+      ctx.font = getYSize(22) + "px monospace";
+      ctx.fillStyle = "#000000a0";
+      ctx.fillRect(getXPos(10), getYPos(10), getXSize(330), getYSize(30 * lines.length + 12));
+      ctx.fillStyle = "#f0f0f0";
+      for (var l = 0; l < lines.length; ++l)
+      {
+        ctx.fillText(lines[l], getXPos(20), getYPos(34 + l * 30));
       }
+    },
+  };
 
-      var spv = simLib.getValue(Component.SP);
-      renderByte(glow_yellow, spv, ledDefs.sp);
-      renderByte(on_yellow_br, spv, ledDefs.sp);
+  var single = function (def) { return [def]; };
+  var groups = [
+    ledGroup(ledDefs.ra, glow_red, on_red_br),
+    ledGroup(ledDefs.rb, glow_red, on_red),
+    ledGroup(ledDefs.rc, glow_red, on_red_tc),
+    displayGroup,
+    ledGroup(ledDefs.sp, glow_yellow, on_yellow_br),
+    ledGroup(ledDefs.pc, glow_green, on_green_bl),
+    ledGroup(ledDefs.st, glow_green, on_green_bl, 60),
+    ledGroup(ledDefs.ir, glow_yellow, on_yellow_bl),
+    ledGroup(ledDefs.ma, glow_yellow, on_yellow_br),
+    ledGroup(ledDefs.me, glow_red, on_red_br),
+    ledGroup(ledDefs.alu, glow_green, on_green_br),
+    ledGroup(ledDefs.aluf, glow_yellow, on_yellow_br),
+    ledGroup(ledDefs.bus, glow_red, on_red_tc),
+    ledGroup(single(ledDefs.clkmode), glow_green, on_green_br),
+    ledGroup(single(ledDefs.runMode), glow_green, on_green_l),
+    ledGroup(single(ledDefs.clk), glow_blue, on_blue),
+    ledGroup(single(ledDefs.pgm), glow_green, on_green_br),
+    ledGroup(ledDefs.cw_r, glow_green, on_green_br),
+    ledGroup(ledDefs.cw.filter(function (l) { return l.x; }), glow_green, on_green_br, 100, true),
+    lcdGroup,
+    statsGroup,
+  ];
+  var G = {
+    ra: 0, rb: 1, rc: 2, rd: 3, sp: 4, pc: 5, st: 6, ir: 7, ma: 8, me: 9, alu: 10, fl: 11, bus: 12,
+    clkMode: 13, runMode: 14, clk: 15, pgm: 16, cwr: 17, cw: 18, lcd: 19, stats: 20
+  };
 
-      var pcv = simLib.getValue(Component.PC);
-      renderByte(glow_green, pcv, ledDefs.pc);
-      renderByte(on_green_bl, pcv, ledDefs.pc);
+  // control word leds, in ledDefs.cw order (skipping the unused bits).
+  // the active low signals light when clear
+  var cwLeds = function (cwv)
+  {
+    var value = 0;
+    var n = 0;
+    for (var cwi = 0; cwi < ledDefs.cw.length; ++cwi)
+    {
+      if (!ledDefs.cw[cwi].x)
+      {
+        continue;
+      }
 
-      var stv = simLib.getValue(Component.TR);
-      renderByte(glow_green, stv, ledDefs.st, 60);
-      renderByte(on_green_bl, stv, ledDefs.st, 60);
+      var on = false;
+      switch (cwi)
+      {
+        case 8:
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+        case 13:
+        case 14:
+        case 16:
+        case 18:
+        case 19:
+          on = (cwv & (1 << cwi)) == 0;
+          break;
 
-      var irv = simLib.getValue(Component.IR);
-      renderByte(glow_yellow, irv, ledDefs.ir);
-      renderByte(on_yellow_bl, irv, ledDefs.ir);
+        default:
+          on = (cwv & (1 << cwi)) != 0;
+          break;
+      }
 
-      var mav = simLib.getValue(Component.MA);
-      renderByte(glow_yellow, mav, ledDefs.ma);
-      renderByte(on_yellow_br, mav, ledDefs.ma);
+      if (on) value |= 1 << n;
+      ++n;
+    }
+    return value;
+  };
 
-      var mev = simLib.getValue(Component.ME);
-      renderByte(glow_red, mev, ledDefs.me);
-      renderByte(on_red_br, mev, ledDefs.me);
+  // canvas pixel rectangle of a group, whole pixels
+  var canvasRect = function (r)
+  {
+    var x0 = Math.floor(getXPos(r.x)), y0 = Math.floor(getYPos(r.y));
+    var x1 = Math.ceil(getXPos(r.x + r.w)) + 1, y1 = Math.ceil(getYPos(r.y + r.h)) + 1;
+    return { x: x0, y: y0, w: x1 - x0, h: y1 - y0 };
+  };
 
-      var aluv = simLib.getValue(Component.AL);
-      renderByte(glow_green, aluv, ledDefs.alu);
-      renderByte(on_green_br, aluv, ledDefs.alu);
+  var overlaps = function (a, b)
+  {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+  };
 
-      var flv = simLib.getValue(Component.FL);
-      renderByte(glow_yellow, flv, ledDefs.aluf);
-      renderByte(on_yellow_br, flv, ledDefs.aluf);
+  var drawBackground = function (r)
+  {
+    ctx.fillStyle = "#262626";
+    ctx.fillRect(r.x, r.y, r.w, r.h);
+    drawScaled(img, 0, 0, $(img).width(), $(img).height());
+  };
 
-      var buv = simLib.getValue(Component.BU);
-      renderByte(glow_red, buv, ledDefs.bus);
-      renderByte(on_red_tc, buv, ledDefs.bus);
+  // draws the machine from getValue/getControlWord/ramByte. clockTick and
+  // fast only drive the clock led. lcdKey changes whenever the lcd needs
+  // drawing, stats is the overlay text ("" = hidden)
+  var render = function (clockTick, fast, lcdKey, stats)
+  {
+    var cwv = getControlWord();
+    var isRunning = (cwv & (1 << 23)) == 0;
 
-      if (autoClock)
+    if (isRunning != wasRunning)
+    {
+      var ramImage = ""
+      for (var i = 0; i < 256; ++i)
       {
-        drawScaled(glow_green, ledDefs.clkmode.x, ledDefs.clkmode.y, 100, 100);
-        drawScaled(on_green_br, ledDefs.clkmode.x, ledDefs.clkmode.y, 100, 100);
+        var b = ramByte(i);
+        ramImage += b.toString(16).padStart(2, '0');
       }
+      console.log(ramImage);
+      console.log(clockTick);
+    }
+    wasRunning = isRunning;
 
-      drawScaled(glow_green, ledDefs.runMode.x, ledDefs.runMode.y, 100, 100);
-      drawScaled(on_green_l, ledDefs.runMode.x, ledDefs.runMode.y, 100, 100);
+    if (!imagesReady())
+    {
+      return;
+    }
 
+    var full = canvasResized || atlas === null || atlas.scale != scale;
+    if (full)
+    {
+      atlas = buildAtlas();
+      canvasResized = false;
+    }
 
-      if (((stepsPerCycle > 0 && (tick % 7) != 0) || (tick % 2)) && isRunning)
+    groups[G.ra].value = getValue(Component.Ra);
+    groups[G.rb].value = getValue(Component.Rb);
+    groups[G.rc].value = getValue(Component.Rc);
+    groups[G.rd].value = displayMasks(getValue(Component.Rd)).join(",");
+    groups[G.sp].value = getValue(Component.SP);
+    groups[G.pc].value = getValue(Component.PC);
+    groups[G.st].value = getValue(Component.TR);
+    groups[G.ir].value = getValue(Component.IR);
+    groups[G.ma].value = getValue(Component.MA);
+    groups[G.me].value = getValue(Component.ME);
+    groups[G.alu].value = getValue(Component.AL);
+    groups[G.fl].value = getValue(Component.FL);
+    groups[G.bus].value = getValue(Component.BU);
+    groups[G.clkMode].value = autoClock ? 1 : 0;
+    groups[G.runMode].value = 1;
+    groups[G.clk].value = (((fast && (clockTick % 7) != 0) || (clockTick % 2)) && isRunning) ? 1 : 0;
+    groups[G.pgm].value = (cwv & (1 << 15)) ? 1 : 0;
+    groups[G.cwr].value = 1 << (cwv & 0x07);
+    groups[G.cw].value = cwLeds(cwv);
+    groups[G.lcd].value = lcdKey;
+    groups[G.stats].value = stats;
+
+    if (full)
+    {
+      var all = { x: 0, y: 0, w: canv.width, h: canv.height };
+      drawBackground(all);
+      groups.forEach(function (g) { g.draw(g.value); g.drawn = g.value; });
+      return;
+    }
+
+    for (var d = 0; d < groups.length; ++d)
+    {
+      var dirty = groups[d];
+      if (dirty.value === dirty.drawn)
       {
-        drawScaled(glow_blue, ledDefs.clk.x, ledDefs.clk.y, 100, 100);
-        drawScaled(on_blue, ledDefs.clk.x, ledDefs.clk.y, 100, 100);
+        continue;
       }
 
-
-      if (cwv & (1 << 15))
+      var r = canvasRect(dirty.rect);
+      ctx.save();
+      ctx.beginPath();
+      ctx.rect(r.x, r.y, r.w, r.h);
+      ctx.clip();
+      drawBackground(r);
+      for (var o = 0; o < groups.length; ++o)
       {
-        drawScaled(glow_green, ledDefs.pgm.x, ledDefs.pgm.y, 100, 100);
-        drawScaled(on_green_br, ledDefs.pgm.x, ledDefs.pgm.y, 100, 100);
+        if (o == d || overlaps(r, canvasRect(groups[o].rect)))
+        {
+          groups[o].draw(groups[o].value);
+        }
       }
+      ctx.restore();
+    }
 
-      var bwv = 1 << (cwv & 0x07);
-      renderByte(glow_green, bwv, ledDefs.cw_r);
-      renderByte(on_green_br, bwv, ledDefs.cw_r);
+    groups.forEach(function (g) { g.drawn = g.value; });
+  };
 
+  // frame time (between frames) and render time, smoothed
+  var frameStats = { last: null, frameMs: 0, renderMs: 0 };
+  var frames = 0;
 
-      for (var cwi = 0; cwi < ledDefs.cw.length; ++cwi)
-      {
-        if (!ledDefs.cw[cwi].x)
-        {
-          continue;
-        }
+  var drawFrame = function (t, cyclesPerSec, instructionsPerSec)
+  {
+    if (frameStats.last !== null)
+    {
+      frameStats.frameMs += (t - frameStats.last - frameStats.frameMs) / 8;
+    }
+    frameStats.last = t;
 
-        var on = false;
-        switch (cwi)
-        {
-          case 8:
-          case 9:
-          case 10:
-          case 11:
-          case 12:
-          case 13:
-          case 14:
-          case 16:
-          case 18:
-          case 19:
-            on = (cwv & (1 << cwi)) == 0;
-            break;
-
-          default:
-            on = (cwv & (1 << cwi)) != 0;
-            break;
-        }
+    // the clock led follows the clock's phase in real time
+    var hz = targetHz();
+    var clockTick = tick;
+    if (autoClock)
+    {
+      clockTick = hz > 0 ? Math.floor(t * hz / 500) : ++frames;
+    }
+    render(clockTick, autoClock && (hz == 0 || hz > 60), lcdKey(t), statsText(t, cyclesPerSec, instructionsPerSec));
+    frameStats.renderMs += (performance.now() - t - frameStats.renderMs) / 8;
+  };
 
-        if (on)
-        {
-          drawScaled(glow_green, ledDefs.cw[cwi].x, ledDefs.cw[cwi].y, 100, 100);
-          drawScaled(on_green_br, ledDefs.cw[cwi].x, ledDefs.cw[cwi].y, 100, 100);
-        }
+  // changes whenever the lcd may look different: the worker counts its
+  // pixel updates. on the page, a write, or each cursor blink interval
+  // while it blinks (always, for builds that don't say)
+  var LCD_BLINK_MS = 100;
+  var SI_LCD_BLINK = 0x04;
+  var lcdKey = function (t)
+  {
+    if (frame)
+    {
+      return frame.words[CpEmuSnapshot.Word.LcdGeneration];
+    }
+    if (state && !(state.lcd[0] & SI_LCD_BLINK))
+    {
+      return state.words[5];
+    }
+    return (state ? state.words[5] : 0) + "/" + Math.floor(t / LCD_BLINK_MS);
+  };
+
+  // achieved rates against the target, refreshed a few times a second so
+  // it doesn't force a redraw every frame. p toggles it, ?stats=0 hides it
+  var STATS_MS = 250;
+  var stats = { text: "", time: -STATS_MS };
+  var statsText = function (t, cyclesPerSec, instructionsPerSec)
+  {
+    if (!showStats)
+    {
+      stats.time = -STATS_MS;
+      return "";
+    }
+    if (t - stats.time < STATS_MS)
+    {
+      return stats.text;
+    }
+
+    stats.time = t;
+    stats.text = [
+      "clock  " + CpEmuClock.format(cyclesPerSec) + " / " + (!autoClock ? "manual" : targetHz() > 0 ? CpEmuClock.format(targetHz()) : "max"),
+      "instr  " + (instructionsPerSec >= 0 ? CpEmuClock.format(instructionsPerSec).replace("Hz", "/s") : "- (core doesn't count)"),
+      "frame  " + frameStats.frameMs.toFixed(1) + " ms (draw " + frameStats.renderMs.toFixed(2) + " ms)",
+      worker ? (shared ? "core   worker (shared)" : "core   worker (posted)") : "core   page",
+    ].join("\n");
+    return stats.text;
+  };
+
+  // the core on the page: each frame runs the cycles the clock scheduler
+  // says are due (at most about half a frame's worth of host time), then
+  // draws
+  var pageClock = CpEmuClock.create(targetHz(), 8);
+  var loop = function ()
+  {
+    var t = performance.now();
+    if (targetHz() != pageClock.hz)
+    {
+      pageClock.setHz(targetHz(), t);
+    }
+
+    mapState();
+    if (isResetting)
+    {
+      simLib.reset();
+      recorder.restart();
+    }
+
+    if (autoClock && !isResetting && !(getControlWord() & (1 << 23)))
+    {
+      var due = pageClock.due(t);
+      var instructions = getInstructions();
+      var ran = due > 0 ? runCycles(due) : 0;
+      recorder.ran(ran);
+      pageClock.ran(ran, performance.now() - t, (getInstructions() - instructions) >>> 0);
+    }
+    else
+    {
+      pageClock.restart(t);
+      if (!autoClock && lastTick != tick)
+      {
+        simLib.setClock(tick % 2);
+        recorder.ran(tick % 2);
+        lastTick = tick;
       }
-      
-      lcd.render(ctx, getXPos(340), getYPos(780), getXSize(300), getYSize(106));
-      drawScaled(lcdimg, 313, 711, 674, 177);
-      
     }
-    window.setTimeout(loop, speed > 160 ? 0 : (200 / (speed <= 0 ? 1 : speed)));
+
+    pageClock.sample(t);
+    refreshState();
+    drawFrame(performance.now(), pageClock.achievedHz, state ? pageClock.instructionsPerSec : -1);
+    window.requestAnimationFrame(loop);
+  };
+
+  // the core in the worker: pass the controls on and draw its latest
+  // snapshot
+  var workerHz = -1;
+  var workerRunning = true;
+  var workerReset = false;
+  var workerLoop = function ()
+  {
+    if (targetHz() != workerHz)
+    {
+      workerHz = targetHz();
+      worker.postMessage({ cmd: "hz", hz: workerHz });
+    }
+    if (autoClock != workerRunning)
+    {
+      workerRunning = autoClock;
+      worker.postMessage({ cmd: "run", running: autoClock });
+    }
+    if (!autoClock && lastTick != tick)
+    {
+      worker.postMessage({ cmd: "clock", high: tick % 2 });
+      lastTick = tick;
+    }
+    if (isResetting != workerReset)
+    {
+      workerReset = isResetting;
+      worker.postMessage({ cmd: "hold", reset: isResetting });
+    }
+
+    if (shared)
+    {
+      CpEmuSnapshot.read(shared, frame);
+    }
+    drawFrame(performance.now(), frame.numbers[1], frame.numbers[2]);
+
+    window.requestAnimationFrame(workerLoop);
   };
 
-  loop();
+  if (worker)
+  {
+    worker.onmessage = function (e)
+    {
+      if (e.data.event == "recording") saveRecording(e.data.text);
+      else if (e.data.event == "script") reportScript(e.data.error);
+      else if (e.data.event == "error") showError(e.data.text);
+      else if (e.data.event == "snapshot") new Uint8Array(frame.buffer).set(new Uint8Array(e.data.buffer));
+    };
+    worker.postMessage({ cmd: "init", buffer: shared ? shared.buffer : null, program: programHex.substring(0, 512), ram: ramData });
+    window.requestAnimationFrame(workerLoop);
+  }
+  else
+  {
+    window.requestAnimationFrame(loop);
+  }
+
+  // ?in= an input script to play (recorded with R)
+  var scriptUrl = getParam("in");
+  if (scriptUrl)
+  {
+    fetch(scriptUrl).then(function (r)
+    {
+      if (!r.ok) throw new Error(r.status + " " + r.statusText);
+      return r.text();
+    }).then(playScript).catch(function (e)
+    {
+      showError("can't fetch the input script " + scriptUrl + ": " + e.message);
+    });
+  }
 };
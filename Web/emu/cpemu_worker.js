@@ -0,0 +1,554 @@
+/*
+ * Troy's 8-bit computer - Emulator worker: runs the cpemu WASM core away
+ * from the page so emulation speed does not depend on rendering
+ *
+ * Copyright (c) 2020 Troy Schrapel
+ *
+ * This code is licensed under the MIT license
+ *
+ * https://github.com/visrealm/vrcpu
+ *
+ */
+
+// runs in a browser Worker (new Worker("cpemu_worker.js")) or headless in a
+// Node worker_threads Worker (new Worker("Web/emu/cpemu_worker.js")).
+//
+// messages to the worker:
+//
+//   { cmd: "init", buffer, program, ram }  buffer: SharedArrayBuffer of
+//                                          CpEmuSnapshot.SIZE bytes, or null
+//                                          to be posted snapshots instead
+//   { cmd: "load", program, ram }          program/ram hex, as in ?h=
+//   { cmd: "hz", hz }                      clock rate, 0 = flat out
+//   { cmd: "run", running }                auto clock on/off
+//   { cmd: "clock", high }                 manual clock edge (when stopped)
+//   { cmd: "hold", reset }                 hold in reset (reset button)
+//   { cmd: "input", value }                input byte (Rd)
+//   { cmd: "record", on }                  start (resets the machine) or stop
+//                                          recording inputs
+//   { cmd: "script", text }                reset and play an input script
+//                                          (inputscript.h), "" to stop
+//
+// messages from the worker:
+//
+//   { event: "ready" }                     after init, once the core is up
+//   { event: "recording", text }           the input script recorded
+//   { event: "script", error }             0, or the malformed script line
+//                                          (-1: the core can't play scripts)
+//   { event: "error", text }               a program that couldn't be loaded
+//   { event: "snapshot", buffer }          without a shared buffer: a copy of
+//                                          the snapshot (ArrayBuffer)
+//
+// the machine state is published to the shared buffer after every slice of
+// cycles (see cpemu_snapshot.js). slices are sized by the clock scheduler
+// (cpemu_clock.js) to hold the clock rate and take at most about 10ms.
+//
+// SharedArrayBuffer needs the page to be cross origin isolated (COOP/COEP
+// headers), which the hosting doesn't give. without it the snapshot is kept
+// in the worker and a copy posted at most every POST_MS, and after each
+// command so manual clocking shows straight away
+
+var isNode = typeof importScripts !== 'function';
+
+var CpEmuSnapshotRef;
+var CpEmuClockRef;
+var CpEmuLoadRef;
+var CpEmuInputRef;
+var port;
+
+if (isNode)
+{
+  var workerThreads = require('worker_threads');
+  var fs = require('fs');
+  var path = require('path');
+  var vm = require('vm');
+
+  CpEmuSnapshotRef = require('./cpemu_snapshot.js');
+  CpEmuClockRef = require('./cpemu_clock.js');
+  CpEmuLoadRef = require('./cpemu_load.js');
+  CpEmuInputRef = require('./cpemu_input.js');
+  port = {
+    post: function (msg, transfer) { workerThreads.parentPort.postMessage(msg, transfer); },
+    listen: function (fn) { workerThreads.parentPort.on('message', fn); },
+  };
+}
+else
+{
+  importScripts('cpemu_snapshot.js', 'cpemu_clock.js', 'cpemu_load.js', 'cpemu_input.js');
+  CpEmuSnapshotRef = CpEmuSnapshot;
+  CpEmuClockRef = CpEmuClock;
+  CpEmuLoadRef = CpEmuLoad;
+  CpEmuInputRef = CpEmuInput;
+  port = {
+    post: function (msg, transfer) { self.postMessage(msg, transfer); },
+    listen: function (fn) { self.onmessage = function (e) { fn(e.data); }; },
+  };
+}
+
+var SLICE_MS = 10;
+var IDLE_MS = 16;
+var PIXEL_MS = 16;         // lcd pixels are refreshed at most this often
+var POST_MS = 16;          // posted snapshots are sent at most this often
+var CELL_X = 6;            // lcd character cell pitch in pixels (5x8 + gap)
+var CELL_Y = 9;
+var HLT = 1 << 23;
+var COMPONENTS = 13;
+var STATE_VERSION = 4;     // SI_STATE_VERSION (siminst.h)
+var SI_LCD_BLINK = 0x04;    // siminst.h
+var LCD_DIRTY_BYTES = 10;  // lcdshadow.h
+
+var core = null;
+var shared = null;
+var posting = false;       // no shared buffer: post copies of the snapshot
+var lastPost = -POST_MS;
+var running = true;
+var holdReset = false;
+var clock = CpEmuClockRef.create(0, SLICE_MS);
+var lastPixels = -PIXEL_MS;
+var lastLcdWrites = -1;
+var lcdGeneration = 0;
+var pixelsCopied = false;
+var scheduled = false;
+var pending = [];          // messages received before the core was up
+var recorder = CpEmuInputRef.recorder();
+
+var now = function ()
+{
+  return performance.now();
+};
+
+// wraps the wasm exports. newer builds run whole slices in the core,
+// export the state block (siminst.h) and track which lcd cells changed;
+// older ones are driven a clock edge at a time, read value by value, don't
+// count instructions and have their whole lcd copied periodically
+var openCore = function (Module)
+{
+  var lcd = Module._simLibGetLcd();
+  var stateBlock = Module._simLibGetState ? Module._simLibGetState() : 0;
+  if (stateBlock && Module.HEAPU32[stateBlock >> 2] != STATE_VERSION)
+  {
+    stateBlock = 0;
+  }
+
+  var c = {
+    lcd: lcd,
+    pixelsX: Module._vrEmuLcdNumPixelsX(lcd),
+    pixelsY: Module._vrEmuLcdNumPixelsY(lcd),
+
+    run: function (n)
+    {
+      if (Module._simLibRun)
+      {
+        return Module._simLibRun(n) >>> 0;
+      }
+      for (var i = 0; i < n; ++i)
+      {
+        if (Module._simLibGetControlWord() & HLT)
+        {
+          return i;
+        }
+        Module._simLibSetClock(0);
+        Module._simLibSetClock(1);
+      }
+      return n;
+    },
+
+    controlWord: function ()
+    {
+      return stateBlock ? Module.HEAPU32[(stateBlock + 16) >> 2] : Module._simLibGetControlWord();
+    },
+
+    lcdWrites: function ()
+    {
+      return stateBlock ? Module.HEAPU32[(stateBlock + 20) >> 2] : -1;
+    },
+
+    // copies registers, memory and lcd flags into the state block (the
+    // counters read above are current after every call anyway)
+    refresh: function ()
+    {
+      if (stateBlock)
+      {
+        Module._simLibGetState();
+      }
+    },
+
+    countsInstructions: !!stateBlock,
+    tracksLcd: !!stateBlock && !!Module._simLibTakeLcdDirty,
+
+    instructions: function ()
+    {
+      return stateBlock ? Module.HEAPU32[(stateBlock + 552) >> 2] : 0;
+    },
+
+    // the lcd cells changed since the last call, a bit each (row major)
+    takeLcdDirty: function ()
+    {
+      var ptr = Module._simLibTakeLcdDirty();
+      return Module.HEAPU8.slice(ptr, ptr + LCD_DIRTY_BYTES);
+    },
+
+    lcdFlags: function ()
+    {
+      return Module.HEAPU32[(stateBlock + 556) >> 2];
+    },
+
+    lcdCursor: function ()
+    {
+      return Module.HEAP32[(stateBlock + 560) >> 2];
+    },
+
+    copyState: function (snapshot)
+    {
+      if (stateBlock)
+      {
+        snapshot.values.set(Module.HEAPU8.subarray(stateBlock + 24, stateBlock + 24 + COMPONENTS));
+        snapshot.ram.set(Module.HEAPU8.subarray(stateBlock + 40, stateBlock + 40 + 256));
+        snapshot.pgm.set(Module.HEAPU8.subarray(stateBlock + 296, stateBlock + 296 + 256));
+        return;
+      }
+      for (var i = 0; i < COMPONENTS; ++i)
+      {
+        snapshot.values[i] = Module._simLibGetValue(i);
+      }
+      for (var a = 0; a < 256; ++a)
+      {
+        snapshot.ram[a] = Module._simLibRamByte(a);
+      }
+    },
+
+    // all pixels, or only those of the cells in mask
+    copyPixels: function (snapshot, mask)
+    {
+      Module._vrEmuLcdUpdatePixels(lcd);
+      if (!mask)
+      {
+        this.copyRect(snapshot, 0, 0, this.pixelsX, this.pixelsY);
+        return;
+      }
+
+      var columns = Math.floor((this.pixelsX + 1) / CELL_X);
+      for (var cell = 0; cell < mask.length * 8; ++cell)
+      {
+        if (mask[cell >> 3] & (1 << (cell & 7)))
+        {
+          var x = (cell % columns) * CELL_X;
+          var y = Math.floor(cell / columns) * CELL_Y;
+          this.copyRect(snapshot, x, y, Math.min(x + CELL_X - 1, this.pixelsX), Math.min(y + CELL_Y - 1, this.pixelsY));
+        }
+      }
+    },
+
+    copyRect: function (snapshot, x0, y0, x1, y1)
+    {
+      for (var y = y0; y < y1; ++y)
+      {
+        for (var x = x0; x < x1; ++x)
+        {
+          snapshot.pixels[y * this.pixelsX + x] = Module._vrEmuLcdPixelState(lcd, x, y);
+        }
+      }
+    },
+
+    Module: Module,
+  };
+
+  if (c.pixelsX * c.pixelsY > CpEmuSnapshotRef.MAX_PIXELS)
+  {
+    c.pixelsY = Math.floor(CpEmuSnapshotRef.MAX_PIXELS / c.pixelsX);
+  }
+  if (!c.tracksLcd)
+  {
+    // still runs, but copies the whole lcd every refresh: say why
+    console.warn("cpemu.wasm doesn't track lcd changes (no simLibGetState v" + STATE_VERSION +
+      " or simLibTakeLcdDirty), rebuild it with Emulator/SimWasm/build.sh");
+  }
+  return c;
+};
+
+var loadProgram = function (program, ram)
+{
+  try
+  {
+    CpEmuLoadRef.load(core.Module, program, ram);
+  }
+  catch (e)
+  {
+    port.post({ event: 'error', text: e.message });
+  }
+  recorder.restart();
+  clock.restart(now());
+};
+
+// which lcd pixels to copy: true for all, a cell mask, or false for none
+var lcdChanges = function (t)
+{
+  var lcdWrites = core.lcdWrites();
+  if (!pixelsCopied || !core.tracksLcd)
+  {
+    // the lcd can change without writes (cursor blink), so it is refreshed
+    // periodically too
+    return !pixelsCopied || lcdWrites != lastLcdWrites || t - lastPixels >= PIXEL_MS;
+  }
+
+  var mask = core.takeLcdDirty();
+  var cursor = core.lcdCursor();
+  if ((core.lcdFlags() & SI_LCD_BLINK) && cursor >= 0 && t - lastPixels >= PIXEL_MS)
+  {
+    mask[cursor >> 3] |= 1 << (cursor & 7);
+  }
+  for (var i = 0; i < mask.length; ++i)
+  {
+    if (mask[i])
+    {
+      return mask;
+    }
+  }
+  return false;
+};
+
+// force: post the snapshot (when posting) however recently the last went
+var publish = function (force)
+{
+  var t = now();
+  core.refresh();
+  var lcdWrites = core.lcdWrites();
+  var pixels = lcdChanges(t);
+
+  CpEmuSnapshotRef.write(shared, function (s)
+  {
+    var cw = core.controlWord();
+    s.words[CpEmuSnapshotRef.Word.ControlWord] = cw;
+    s.words[CpEmuSnapshotRef.Word.LcdWrites] = lcdWrites;
+    s.words[CpEmuSnapshotRef.Word.Running] = running ? 1 : 0;
+    s.words[CpEmuSnapshotRef.Word.Halted] = (cw & HLT) ? 1 : 0;
+    s.words[CpEmuSnapshotRef.Word.LcdPixelsX] = core.pixelsX;
+    s.words[CpEmuSnapshotRef.Word.LcdPixelsY] = core.pixelsY;
+    s.numbers[0] = clock.cycles;
+    s.numbers[1] = clock.achievedHz;
+    s.numbers[2] = core.countsInstructions ? clock.instructionsPerSec : -1;
+    s.numbers[3] = clock.hz;
+    core.copyState(s);
+    if (pixels)
+    {
+      core.copyPixels(s, pixels === true ? null : pixels);
+      s.words[CpEmuSnapshotRef.Word.LcdGeneration] = ++lcdGeneration;
+    }
+  });
+
+  if (pixels)
+  {
+    pixelsCopied = true;
+    lastPixels = t;
+    lastLcdWrites = lcdWrites;
+  }
+
+  if (posting && (force || t - lastPost >= POST_MS))
+  {
+    var copy = shared.buffer.slice(0);
+    port.post({ event: 'snapshot', buffer: copy }, [copy]);
+    lastPost = t;
+  }
+};
+
+// flat out slices are chained without a delay: setTimeout(0) is clamped
+// to several ms once nested. node has setImmediate, which also lets the
+// worker's messages in between slices; browsers use a message channel
+var channel = null;
+var scheduleSlice = function (delayMs)
+{
+  if (scheduled)
+  {
+    return;
+  }
+  scheduled = true;
+  if (delayMs > 0)
+  {
+    setTimeout(slice, delayMs);
+  }
+  else if (typeof setImmediate === 'function')
+  {
+    setImmediate(slice);
+  }
+  else
+  {
+    if (channel === null)
+    {
+      channel = new MessageChannel();
+      channel.port1.onmessage = function () { slice(); };
+    }
+    channel.port2.postMessage(0);
+  }
+};
+
+var slice = function ()
+{
+  scheduled = false;
+  var t = now();
+  var delay = 0;
+
+  if (holdReset)
+  {
+    core.Module._simLibReset();
+    recorder.restart();
+    clock.restart(t);
+    delay = IDLE_MS;
+  }
+  else if (!running || (core.controlWord() & HLT))
+  {
+    clock.restart(t);
+    delay = IDLE_MS;
+  }
+  else
+  {
+    var due = clock.due(t);
+    var instructions = core.instructions();
+    var ran = due > 0 ? core.run(due) : 0;
+    recorder.ran(ran);
+    clock.ran(ran, now() - t, (core.instructions() - instructions) >>> 0);
+
+    // paced, the next slice starts a slice period after this one. flat
+    // out, straight away
+    delay = clock.hz > 0 ? SLICE_MS - (now() - t) : 0;
+  }
+
+  clock.sample(now());
+  publish();
+  scheduleSlice(delay);
+};
+
+var handle = function (msg)
+{
+  if (core === null && msg.cmd != 'init')
+  {
+    pending.push(msg);
+    return;
+  }
+
+  switch (msg.cmd)
+  {
+    case 'init':
+      start(msg);
+      break;
+
+    case 'load':
+      loadProgram(msg.program, msg.ram);
+      break;
+
+    case 'hz':
+      clock.setHz(msg.hz, now());
+      break;
+
+    case 'run':
+      running = !!msg.running;
+      clock.restart(now());
+      break;
+
+    case 'clock':
+      if (!running)
+      {
+        var instructions = core.instructions();
+        core.Module._simLibSetClock(msg.high ? 1 : 0);
+        recorder.ran(msg.high ? 1 : 0);
+        clock.ran(msg.high ? 1 : 0, 0, (core.instructions() - instructions) >>> 0);
+      }
+      break;
+
+    case 'hold':
+      holdReset = !!msg.reset;
+      if (holdReset)
+      {
+        core.Module._simLibReset();
+        recorder.restart();
+      }
+      break;
+
+    case 'input':
+      core.Module._simLibSetInput(msg.value & 0xff);
+      recorder.input(msg.value);
+      break;
+
+    case 'record':
+      if (msg.on)
+      {
+        core.Module._simLibReset();
+        recorder.start();
+      }
+      else
+      {
+        port.post({ event: 'recording', text: recorder.stop() });
+      }
+      break;
+
+    case 'script':
+      var error = CpEmuInputRef.setScript(core.Module, msg.text);
+      if (error == 0)
+      {
+        core.Module._simLibReset();
+        recorder.restart();
+      }
+      port.post({ event: 'script', error: error });
+      break;
+  }
+
+  if (core)
+  {
+    publish(true);
+  }
+};
+
+var start = function (msg)
+{
+  posting = !msg.buffer;
+  shared = CpEmuSnapshotRef.create(msg.buffer);
+
+  var Module = {
+    onRuntimeInitialized: function ()
+    {
+      Module._simLibInitialise();
+      core = openCore(Module);
+      loadProgram(msg.program, msg.ram);
+
+      var queued = pending;
+      pending = [];
+      queued.forEach(handle);
+
+      publish(true);
+      port.post({ event: 'ready' });
+      scheduleSlice(0);
+    },
+  };
+
+  if (isNode)
+  {
+    // cpemu.js expects to run as a classic script: give it the globals it
+    // would have there and hand it the preloaded data package from disk
+    var dir = __dirname;
+    globalThis.Module = Module;
+    globalThis.require = require;
+    globalThis.__dirname = dir;
+    globalThis.location = { pathname: dir + '/' };
+    Module.instantiateWasm = function (imports, receiveInstance)
+    {
+      // node has fetch, but not for file paths
+      WebAssembly.instantiate(fs.readFileSync(path.join(dir, 'cpemu.wasm')), imports).then(function (result)
+      {
+        receiveInstance(result.instance, result.module);
+      });
+      return {};
+    };
+    Module.getPreloadedPackage = function (name)
+    {
+      var data = fs.readFileSync(path.join(dir, path.basename(name)));
+      return data.buffer.slice(data.byteOffset, data.byteOffset + data.length);
+    };
+    vm.runInThisContext(fs.readFileSync(path.join(dir, 'cpemu.js'), 'utf8'), { filename: 'cpemu.js' });
+  }
+  else
+  {
+    self.Module = Module;
+    importScripts('cpemu.js');
+  }
+};
+
+port.listen(handle);